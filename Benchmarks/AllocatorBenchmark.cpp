@@ -0,0 +1,132 @@
+#include "Benchmarks.h"
+
+#include "Core/HeapAllocator.h"
+#include "Core/Platform.h"
+#include "Core/Logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace Gecko { namespace Benchmarks {
+
+	namespace
+	{
+		constexpr u32 LIVE_SLOTS = 4096;
+		constexpr u32 OPERATIONS_PER_THREAD = 2000000;
+		constexpr size_t MAX_GROW_SIZE = 64 * 1024;
+
+		struct CRTAllocator
+		{
+			static const char* Name() { return "CRT"; }
+			static void* Allocate(size_t size) { return Platform::CustomAllocate(size); }
+			static void* Reallocate(void* mem, size_t size) { return Platform::CustomRealloc(mem, size); }
+			static void Free(void* mem) { Platform::CustomFree(mem); }
+		};
+
+		struct HeapAllocator
+		{
+			static const char* Name() { return "Heap"; }
+			static void* Allocate(size_t size) { return Memory::HeapAllocate(size); }
+			static void* Reallocate(void* mem, size_t size) { return Memory::HeapReallocate(mem, size); }
+			static void Free(void* mem) { Memory::HeapFree(mem); }
+		};
+
+		inline u32 NextRandom(u32& state)
+		{
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			return state;
+		}
+
+		// Roughly what loading a scene looks like: mostly small nodes and strings, some vertex data, the odd texture.
+		inline size_t RandomSize(u32& state)
+		{
+			u32 bucket = NextRandom(state) % 100;
+			if (bucket < 70)
+				return 16 + NextRandom(state) % 240;
+			if (bucket < 95)
+				return 256 + NextRandom(state) % 3840;
+			if (bucket < 99)
+				return 4096 + NextRandom(state) % 28672;
+			return 65536 + NextRandom(state) % 196608;
+		}
+
+		template<typename Allocator>
+		void Worker(u32 seed)
+		{
+			u32 state = seed;
+			std::vector<void*> slots(LIVE_SLOTS, nullptr);
+			std::vector<size_t> sizes(LIVE_SLOTS, 0);
+
+			for (u32 i = 0; i < OPERATIONS_PER_THREAD; i++)
+			{
+				u32 index = NextRandom(state) % LIVE_SLOTS;
+
+				// One in eight operations grows a block the way a vector being filled would.
+				if (slots[index] != nullptr && sizes[index] < MAX_GROW_SIZE && (NextRandom(state) & 7) == 0)
+				{
+					sizes[index] *= 2;
+					slots[index] = Allocator::Reallocate(slots[index], sizes[index]);
+				}
+				else
+				{
+					Allocator::Free(slots[index]);
+					sizes[index] = RandomSize(state);
+					slots[index] = Allocator::Allocate(sizes[index]);
+				}
+				static_cast<u8*>(slots[index])[0] = static_cast<u8>(i);
+			}
+
+			for (void* mem : slots)
+			{
+				Allocator::Free(mem);
+			}
+		}
+
+		template<typename Allocator>
+		f64 Run(u32 threadCount)
+		{
+			std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+			std::vector<std::thread> threads;
+			threads.reserve(threadCount);
+			for (u32 i = 0; i < threadCount; i++)
+			{
+				threads.emplace_back(Worker<Allocator>, 0x9E3779B9u * (i + 1));
+			}
+			for (std::thread& thread : threads)
+			{
+				thread.join();
+			}
+
+			std::chrono::duration<f64> elapsed = std::chrono::high_resolution_clock::now() - start;
+			return elapsed.count();
+		}
+
+		template<typename Allocator>
+		void Report(u32 threadCount, f64 baseline)
+		{
+			f64 seconds = Run<Allocator>(threadCount);
+			f64 operations = static_cast<f64>(OPERATIONS_PER_THREAD) * threadCount;
+			LOG_INFO("  %-4s %2u threads: %8.2f ms, %7.2f ns/op, %6.2fx",
+				Allocator::Name(), threadCount, seconds * 1000., seconds * 1e9 / operations, baseline / seconds);
+		}
+	}
+
+	void RunAllocatorBenchmark()
+	{
+		LOG_INFO("Allocator benchmark, %u operations per thread over %u live blocks:", OPERATIONS_PER_THREAD, LIVE_SLOTS);
+
+		u32 maxThreads = std::max(1u, std::thread::hardware_concurrency());
+		for (u32 threadCount = 1; threadCount <= maxThreads; threadCount *= 2)
+		{
+			f64 baseline = Run<CRTAllocator>(threadCount);
+			Report<CRTAllocator>(threadCount, baseline);
+			Report<HeapAllocator>(threadCount, baseline);
+		}
+	}
+
+} }
@@ -0,0 +1,10 @@
+#pragma once
+
+namespace Gecko { namespace Benchmarks {
+
+	void RunAllocatorBenchmark();
+	void RunEventBenchmark();
+	void RunJobSystemBenchmark();
+	void RunTransformKernelBenchmark();
+
+} }
@@ -0,0 +1,164 @@
+#include "Benchmarks.h"
+
+#include "Core/Event.h"
+#include "Core/Logger.h"
+
+#include <chrono>
+#include <vector>
+
+namespace Gecko { namespace Benchmarks {
+
+	namespace
+	{
+		constexpr u32 NUM_EVENTS = 1000000;
+		constexpr u32 NUM_LISTENERS = 4;
+
+		// 48 bytes, too large for the 16 byte EventData union.
+		struct BenchmarkPayload
+		{
+			u64 Handle;
+			f32 Bounds[6];
+			char Name[16];
+		};
+
+		struct BenchmarkEvent
+		{
+			GECKO_TYPED_EVENT(BenchmarkEvent);
+			BenchmarkPayload Payload;
+		};
+
+		// The event path before typed events: a virtual callback per listener,
+		// large payloads go through a side table and only their index fits in the EventData.
+		class LegacyCallbackInterface
+		{
+		public:
+			virtual ~LegacyCallbackInterface() {};
+			virtual bool operator() (const Event::EventData& data) = 0;
+		};
+
+		std::vector<BenchmarkPayload> s_SideTable;
+
+		class LegacyListener : public LegacyCallbackInterface
+		{
+		public:
+			virtual bool operator() (const Event::EventData& data) override
+			{
+				const BenchmarkPayload& payload = s_SideTable[data.Data.u32[0]];
+				Sum += payload.Handle + static_cast<u64>(payload.Bounds[3]);
+				return false;
+			}
+
+			u64 Sum{ 0 };
+		};
+
+		class TypedListener : protected Event::EventListener<TypedListener>
+		{
+		public:
+			TypedListener()
+			{
+				AddEventListener(&TypedListener::OnBenchmarkEvent);
+			}
+
+			bool OnBenchmarkEvent(const BenchmarkEvent& event)
+			{
+				Sum += event.Payload.Handle + static_cast<u64>(event.Payload.Bounds[3]);
+				return false;
+			}
+
+			u64 Sum{ 0 };
+		};
+
+		BenchmarkEvent MakeEvent(u32 i)
+		{
+			BenchmarkEvent event{};
+			event.Payload.Handle = i;
+			event.Payload.Bounds[3] = static_cast<f32>(i & 0xFF);
+			return event;
+		}
+
+		template<typename Func>
+		f64 Measure(Func&& func)
+		{
+			std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+			func();
+			std::chrono::duration<f64> elapsed = std::chrono::high_resolution_clock::now() - start;
+			return elapsed.count();
+		}
+
+		void Report(const char* name, f64 seconds, u64 checksum)
+		{
+			LOG_INFO("  %-24s %8.2f ms, %6.2f ns/event (checksum %llu)",
+				name, seconds * 1000., seconds * 1e9 / NUM_EVENTS, static_cast<unsigned long long>(checksum));
+		}
+	}
+
+	void RunEventBenchmark()
+	{
+		Event::Init();
+
+		LOG_INFO("Event benchmark, %u events of %u bytes to %u listeners:", NUM_EVENTS, static_cast<u32>(sizeof(BenchmarkPayload)), NUM_LISTENERS);
+
+		{
+			LegacyListener listeners[NUM_LISTENERS];
+			std::vector<LegacyCallbackInterface*> callbacks;
+			for (LegacyListener& listener : listeners)
+			{
+				callbacks.push_back(&listener);
+			}
+
+			f64 seconds = Measure([&]()
+			{
+				for (u32 i = 0; i < NUM_EVENTS; i++)
+				{
+					s_SideTable.push_back(MakeEvent(i).Payload);
+
+					Event::EventData data{};
+					data.Data.u32[0] = static_cast<u32>(s_SideTable.size() - 1);
+					for (LegacyCallbackInterface* callback : callbacks)
+					{
+						(*callback)(data);
+					}
+
+					// The side table has to be cleaned up once every listener has seen the event.
+					if (s_SideTable.size() == 256)
+					{
+						s_SideTable.clear();
+					}
+				}
+			});
+			Report("Virtual + side table", seconds, listeners[0].Sum);
+		}
+
+		{
+			TypedListener listeners[NUM_LISTENERS];
+			f64 seconds = Measure([&]()
+			{
+				for (u32 i = 0; i < NUM_EVENTS; i++)
+				{
+					Event::Fire(MakeEvent(i));
+				}
+			});
+			Report("Typed Fire", seconds, listeners[0].Sum);
+		}
+
+		{
+			TypedListener listeners[NUM_LISTENERS];
+			f64 seconds = Measure([&]()
+			{
+				for (u32 i = 0; i < NUM_EVENTS; i++)
+				{
+					Event::Post(MakeEvent(i));
+					if ((i & 255) == 255)
+					{
+						Event::DispatchQueuedEvents();
+					}
+				}
+				Event::DispatchQueuedEvents();
+			});
+			Report("Typed Post + Dispatch", seconds, listeners[0].Sum);
+		}
+
+		Event::Shutdown();
+	}
+
+} }
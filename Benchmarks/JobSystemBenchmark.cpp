@@ -0,0 +1,162 @@
+#include "Benchmarks.h"
+
+#include "Core/JobSystem.h"
+#include "Core/Logger.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace Gecko { namespace Benchmarks {
+
+	namespace
+	{
+		constexpr u32 NUM_EMPTY_JOBS = 1000000;
+		constexpr u32 EMPTY_JOB_BATCH = 1024;
+		constexpr u32 NUM_ROUND_TRIPS = 100000;
+		constexpr u32 CHAIN_LENGTH = 100000;
+		constexpr u32 NUM_ELEMENTS = 1 << 22;
+
+		using Clock = std::chrono::high_resolution_clock;
+
+		f64 SecondsSince(Clock::time_point start)
+		{
+			std::chrono::duration<f64> elapsed = Clock::now() - start;
+			return elapsed.count();
+		}
+
+		void EmptyJob(void*)
+		{
+		}
+
+		// Queueing, stealing and finishing cost without any work to hide it.
+		void RunEmptyJobs()
+		{
+			std::vector<Jobs::Job> jobs(EMPTY_JOB_BATCH);
+			for (Jobs::Job& job : jobs)
+			{
+				job.Function = EmptyJob;
+			}
+
+			Clock::time_point start = Clock::now();
+			Jobs::JobCounter counter;
+			for (u32 i = 0; i < NUM_EMPTY_JOBS; i += EMPTY_JOB_BATCH)
+			{
+				Jobs::Run(jobs.data(), EMPTY_JOB_BATCH, &counter);
+			}
+			Jobs::Wait(counter);
+			f64 seconds = SecondsSince(start);
+
+			LOG_INFO("  %u empty jobs in batches of %u: %8.2f ms, %7.2f ns/job", NUM_EMPTY_JOBS, EMPTY_JOB_BATCH, seconds * 1000., seconds * 1e9 / NUM_EMPTY_JOBS);
+		}
+
+		// A single job queued and waited for, the latency a dependency adds when nothing else is running.
+		void RunRoundTrips()
+		{
+			Clock::time_point start = Clock::now();
+			for (u32 i = 0; i < NUM_ROUND_TRIPS; i++)
+			{
+				Jobs::JobCounter counter;
+				Jobs::Run(EmptyJob, nullptr, &counter);
+				Jobs::Wait(counter);
+			}
+			f64 seconds = SecondsSince(start);
+
+			LOG_INFO("  Run + Wait round trip:                  %7.2f ns", seconds * 1e9 / NUM_ROUND_TRIPS);
+		}
+
+		void WaitForGate(void* data)
+		{
+			std::atomic<bool>* gate = static_cast<std::atomic<bool>*>(data);
+			while (!gate->load(std::memory_order_acquire))
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		// Every job is a continuation of the one before it, the cost of handing a dependency from job to job.
+		void RunContinuationChain()
+		{
+			std::vector<Jobs::JobCounter> counters(CHAIN_LENGTH);
+
+			// The first job holds the chain back until all links are attached.
+			std::atomic<bool> gate{ false };
+			Jobs::Run(WaitForGate, &gate, &counters[0]);
+			for (u32 i = 1; i < CHAIN_LENGTH; i++)
+			{
+				Jobs::RunAfter(counters[i - 1], EmptyJob, nullptr, &counters[i]);
+			}
+
+			Clock::time_point start = Clock::now();
+			gate.store(true, std::memory_order_release);
+			Jobs::Wait(counters[CHAIN_LENGTH - 1]);
+			f64 seconds = SecondsSince(start);
+
+			LOG_INFO("  %u chained continuations:            %7.2f ns/link", CHAIN_LENGTH, seconds * 1e9 / CHAIN_LENGTH);
+		}
+
+		// Light work per element, so the grain size decides whether scheduling or the work dominates.
+		void RunParallelFor()
+		{
+			std::vector<f32> values(NUM_ELEMENTS);
+			for (u32 i = 0; i < NUM_ELEMENTS; i++)
+			{
+				values[i] = static_cast<f32>(i);
+			}
+
+			auto work = [&values](u32 begin, u32 end)
+				{
+					for (u32 i = begin; i < end; i++)
+					{
+						values[i] = std::sqrt(values[i] * 1.5f + 1.f);
+					}
+				};
+
+			Clock::time_point start = Clock::now();
+			work(0, NUM_ELEMENTS);
+			f64 serialSeconds = SecondsSince(start);
+			LOG_INFO("  ParallelFor over %u elements, serial:    %8.2f ms", NUM_ELEMENTS, serialSeconds * 1000.);
+
+			for (u32 grainSize : { 256u, 4096u, 65536u, 0u })
+			{
+				start = Clock::now();
+				Jobs::ParallelFor(0, NUM_ELEMENTS, grainSize, work);
+				f64 seconds = SecondsSince(start);
+				LOG_INFO("    grain %6u:                         %8.2f ms, %6.2fx", grainSize, seconds * 1000., serialSeconds / seconds);
+			}
+
+			start = Clock::now();
+			f64 sum = Jobs::ParallelReduce<f64>(0, NUM_ELEMENTS, 0, 0.,
+				[&values](u32 begin, u32 end)
+				{
+					f64 rangeSum = 0.;
+					for (u32 i = begin; i < end; i++)
+					{
+						rangeSum += values[i];
+					}
+					return rangeSum;
+				},
+				[](f64 a, f64 b) { return a + b; });
+			f64 seconds = SecondsSince(start);
+			LOG_INFO("  ParallelReduce sum %.3e:             %8.2f ms", sum, seconds * 1000.);
+		}
+	}
+
+	void RunJobSystemBenchmark()
+	{
+		Jobs::JobSystemDesc desc;
+		desc.NumWorkers = std::max(2u, std::thread::hardware_concurrency()) - 1;
+		Jobs::Init(desc);
+
+		LOG_INFO("Job system benchmark, %u workers and the main thread:", Jobs::GetNumWorkers());
+		RunEmptyJobs();
+		RunRoundTrips();
+		RunContinuationChain();
+		RunParallelFor();
+
+		Jobs::Shutdown();
+	}
+
+} }
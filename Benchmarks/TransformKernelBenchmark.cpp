@@ -0,0 +1,231 @@
+#include "Benchmarks.h"
+
+#include "Core/TransformKernels.h"
+#include "Core/Logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+namespace Gecko { namespace Benchmarks {
+
+	namespace
+	{
+		constexpr u32 NUM_TRANSFORMS = 1000000;
+		// Each side runs a few times and the fastest run counts, the first run pays for cold caches and pages.
+		constexpr u32 NUM_RUNS = 3;
+
+		using Clock = std::chrono::high_resolution_clock;
+
+		f64 SecondsSince(Clock::time_point start)
+		{
+			std::chrono::duration<f64> elapsed = Clock::now() - start;
+			return elapsed.count();
+		}
+
+		inline u32 NextRandom(u32& state)
+		{
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			return state;
+		}
+
+		inline f32 RandomFloat(u32& state, f32 min, f32 max)
+		{
+			return min + (max - min) * static_cast<f32>(NextRandom(state) & 0xFFFFFF) / static_cast<f32>(0xFFFFFF);
+		}
+
+		f32 MaxDifference(const std::vector<glm::mat4>& a, const std::vector<glm::mat4>& b)
+		{
+			f32 difference = 0.f;
+			for (size_t i = 0; i < a.size(); i++)
+			{
+				for (u32 column = 0; column < 4; column++)
+				{
+					for (u32 row = 0; row < 4; row++)
+					{
+						difference = std::max(difference, std::abs(a[i][column][row] - b[i][column][row]));
+					}
+				}
+			}
+			return difference;
+		}
+
+		template<typename Function>
+		f64 FastestRun(Function function)
+		{
+			f64 fastest = 0.;
+			for (u32 run = 0; run < NUM_RUNS; run++)
+			{
+				Clock::time_point start = Clock::now();
+				function();
+				f64 seconds = SecondsSince(start);
+				fastest = run == 0 ? seconds : std::min(fastest, seconds);
+			}
+			return fastest;
+		}
+
+		void LogResult(const char* name, f64 glmSeconds, f64 kernelSeconds, f32 difference)
+		{
+			LOG_INFO("  %-20s glm %7.2f ns, kernel %7.2f ns per transform, %5.2fx, max difference %.2e", name, glmSeconds * 1e9 / NUM_TRANSFORMS,
+				kernelSeconds * 1e9 / NUM_TRANSFORMS, glmSeconds / kernelSeconds, difference);
+		}
+
+		struct Transforms
+		{
+			std::vector<glm::vec3> Positions;
+			std::vector<glm::vec3> Rotations;
+			std::vector<glm::vec3> Scales;
+			// The same values one array per component, as the kernels take them.
+			std::vector<f32> Components[9];
+			Math::TRSArrays Arrays;
+		};
+
+		void CreateTransforms(Transforms& transforms)
+		{
+			u32 state = 0x9E3779B9;
+			transforms.Positions.resize(NUM_TRANSFORMS);
+			transforms.Rotations.resize(NUM_TRANSFORMS);
+			transforms.Scales.resize(NUM_TRANSFORMS);
+			for (std::vector<f32>& component : transforms.Components)
+			{
+				component.resize(NUM_TRANSFORMS);
+			}
+
+			for (u32 i = 0; i < NUM_TRANSFORMS; i++)
+			{
+				for (u32 component = 0; component < 3; component++)
+				{
+					transforms.Positions[i][component] = transforms.Components[component][i] = RandomFloat(state, -100.f, 100.f);
+					transforms.Rotations[i][component] = transforms.Components[3 + component][i] = RandomFloat(state, -180.f, 180.f);
+					transforms.Scales[i][component] = transforms.Components[6 + component][i] = RandomFloat(state, .5f, 2.f);
+				}
+			}
+
+			for (u32 component = 0; component < 3; component++)
+			{
+				transforms.Arrays.Position[component] = transforms.Components[component].data();
+				transforms.Arrays.Rotation[component] = transforms.Components[3 + component].data();
+				transforms.Arrays.Scale[component] = transforms.Components[6 + component].data();
+			}
+		}
+	}
+
+	void RunTransformKernelBenchmark()
+	{
+		LOG_INFO("Transform kernel benchmark, %u transforms, %s kernels:", NUM_TRANSFORMS, Math::GetKernelInstructionSet());
+
+		Transforms transforms;
+		CreateTransforms(transforms);
+		std::vector<glm::mat4> glmMatrices(NUM_TRANSFORMS);
+		std::vector<glm::mat4> kernelMatrices(NUM_TRANSFORMS);
+
+		// The way NodeTransform used to build its matrix.
+		f64 glmSeconds = FastestRun([&]()
+			{
+				for (u32 i = 0; i < NUM_TRANSFORMS; i++)
+				{
+					glm::mat4 translation = glm::translate(glm::mat4(1.), transforms.Positions[i]);
+					glm::mat4 rotation = glm::toMat4(glm::quat(glm::radians(transforms.Rotations[i])));
+					glm::mat4 scale = glm::scale(glm::mat4(1.), transforms.Scales[i]);
+					glmMatrices[i] = translation * rotation * scale;
+				}
+			});
+		f64 kernelSeconds = FastestRun([&]() { Math::ComposeTRS(transforms.Arrays, kernelMatrices.data(), NUM_TRANSFORMS); });
+		LogResult("Compose TRS", glmSeconds, kernelSeconds, MaxDifference(glmMatrices, kernelMatrices));
+
+		// Every matrix times the next one.
+		std::vector<glm::mat4> nextMatrices(NUM_TRANSFORMS);
+		for (u32 i = 0; i < NUM_TRANSFORMS; i++)
+		{
+			nextMatrices[i] = glmMatrices[(i + 1) % NUM_TRANSFORMS];
+		}
+		std::vector<glm::mat4> products(NUM_TRANSFORMS);
+		glmSeconds = FastestRun([&]()
+			{
+				for (u32 i = 0; i < NUM_TRANSFORMS; i++)
+				{
+					products[i] = glmMatrices[i] * nextMatrices[i];
+				}
+			});
+		kernelSeconds = FastestRun([&]() { Math::MultiplyMatrices(glmMatrices.data(), nextMatrices.data(), kernelMatrices.data(), NUM_TRANSFORMS); });
+		LogResult("Multiply", glmSeconds, kernelSeconds, MaxDifference(products, kernelMatrices));
+
+		// A wide hierarchy, every node hangs below one of the 64 nodes before it. Rotation and a small translation only,
+		// so the world matrices stay in a range where the difference means something.
+		std::vector<u32> parents(NUM_TRANSFORMS);
+		std::vector<u32> indices(NUM_TRANSFORMS);
+		std::vector<glm::mat4> localMatrices(NUM_TRANSFORMS);
+		u32 state = 0x2545F491;
+		for (u32 i = 0; i < NUM_TRANSFORMS; i++)
+		{
+			parents[i] = i == 0 ? Math::NO_PARENT_MATRIX : i - 1 - NextRandom(state) % std::min(i, 64u);
+			indices[i] = i;
+			localMatrices[i] = glm::translate(glm::mat4(1.), transforms.Positions[i] * .01f) * glm::toMat4(glm::quat(glm::radians(transforms.Rotations[i])));
+		}
+		glmSeconds = FastestRun([&]()
+			{
+				for (u32 i = 0; i < NUM_TRANSFORMS; i++)
+				{
+					products[i] = parents[i] == Math::NO_PARENT_MATRIX ? localMatrices[i] : products[parents[i]] * localMatrices[i];
+				}
+			});
+		kernelSeconds = FastestRun([&]() { Math::MultiplyByParents(indices.data(), NUM_TRANSFORMS, parents.data(), localMatrices.data(), kernelMatrices.data()); });
+		LogResult("Multiply by parents", glmSeconds, kernelSeconds, MaxDifference(products, kernelMatrices));
+
+		glmSeconds = FastestRun([&]()
+			{
+				for (u32 i = 0; i < NUM_TRANSFORMS; i++)
+				{
+					products[i] = glm::inverse(glmMatrices[i]);
+				}
+			});
+		kernelSeconds = FastestRun([&]() { Math::InvertAffine(glmMatrices.data(), kernelMatrices.data(), NUM_TRANSFORMS); });
+		LogResult("Invert affine", glmSeconds, kernelSeconds, MaxDifference(products, kernelMatrices));
+
+		// Unit boxes below the composed transforms, seen from the origin. The difference is the number of boxes the
+		// two sides disagree on.
+		Math::BoxArrays boxes;
+		std::vector<f32> centers(NUM_TRANSFORMS, 0.f);
+		std::vector<f32> extents(NUM_TRANSFORMS, 1.f);
+		for (u32 component = 0; component < 3; component++)
+		{
+			boxes.Center[component] = centers.data();
+			boxes.Extents[component] = extents.data();
+		}
+		glm::mat4 viewProjection = glm::perspective(glm::radians(60.f), 16.f / 9.f, .1f, 200.f);
+		Math::Frustum frustum = Math::ExtractFrustum(viewProjection);
+		std::vector<u32> glmVisible(NUM_TRANSFORMS);
+		std::vector<u32> kernelVisible(NUM_TRANSFORMS);
+		u32 glmVisibleCount = 0;
+		u32 kernelVisibleCount = 0;
+		glmSeconds = FastestRun([&]()
+			{
+				glmVisibleCount = 0;
+				for (u32 i = 0; i < NUM_TRANSFORMS; i++)
+				{
+					const glm::mat4& transform = glmMatrices[i];
+					glm::vec3 center = glm::vec3(transform[3]);
+					glm::vec3 halfSize = glm::abs(glm::vec3(transform[0])) + glm::abs(glm::vec3(transform[1])) + glm::abs(glm::vec3(transform[2]));
+					bool inside = true;
+					for (const glm::vec4& plane : frustum.Planes)
+					{
+						glm::vec3 normal = glm::vec3(plane);
+						inside &= glm::dot(normal, center) + plane.w + glm::dot(glm::abs(normal), halfSize) >= 0.f;
+					}
+					glmVisible[glmVisibleCount] = i;
+					glmVisibleCount += inside ? 1 : 0;
+				}
+			});
+		kernelSeconds = FastestRun([&]() { kernelVisibleCount = Math::CullBoxes(frustum, boxes, glmMatrices.data(), NUM_TRANSFORMS, kernelVisible.data()); });
+		u32 mismatches = glmVisibleCount > kernelVisibleCount ? glmVisibleCount - kernelVisibleCount : kernelVisibleCount - glmVisibleCount;
+		for (u32 i = 0; i < std::min(glmVisibleCount, kernelVisibleCount); i++)
+		{
+			mismatches += glmVisible[i] != kernelVisible[i] ? 1 : 0;
+		}
+		LogResult("Cull boxes", glmSeconds, kernelSeconds, static_cast<f32>(mismatches));
+	}
+
+} }
@@ -0,0 +1,12 @@
+#include "Defines.h"
+#include "Benchmarks.h"
+
+int main()
+{
+	Gecko::Benchmarks::RunAllocatorBenchmark();
+	Gecko::Benchmarks::RunEventBenchmark();
+	Gecko::Benchmarks::RunJobSystemBenchmark();
+	Gecko::Benchmarks::RunTransformKernelBenchmark();
+
+	return 0;
+}
@@ -5,8 +5,8 @@
 class CustomPass : public Gecko::RenderPass
 {
 public:
-	virtual const void Init(Gecko::Platform::AppInfo& appInfo, Gecko::ResourceManager* resourceManager) override;
-	virtual const void Render(const Gecko::SceneRenderInfo& sceneRenderInfo, Gecko::ResourceManager* resourceManager,
+	virtual void Init(Gecko::Platform::AppInfo& appInfo, Gecko::ResourceManager* resourceManager) override;
+	virtual void Render(const Gecko::SceneRenderInfo& sceneRenderInfo, Gecko::ResourceManager* resourceManager,
 		Gecko::Ref<Gecko::CommandList> commandList) override;
 
 private:
@@ -13,11 +13,21 @@
 #include "Rendering/Frontend/Renderer/RenderPasses/ToneMappingGammaCorrectionPass.h"
 #include "UI/DebugUIRenderer.h"
 
+#include "Core/Event.h"
 #include "Core/Input.h"
+#include "Core/Memory.h"
+#include "Core/AllocationGuard.h"
+#include "Core/FramePacer.h"
+#include "Core/FrameTaskGraph.h"
+#include "Core/Threading.h"
 
 #include "CustomPass.h"
 
-int main()
+#include <cstring>
+
+#include <optional>
+
+int main(int argc, char** argv)
 {
 
 	Gecko::Platform::AppInfo info;
@@ -29,20 +39,35 @@ int main()
 	info.X = 200;
 	info.Y = 200;
 	info.NumBackBuffers = 2;
+	info.CPUMemoryBudget = { 256ull << 20, 512ull << 20 };
+	info.GPUMemoryBudget = { 1024ull << 20, 1536ull << 20 };
 	info.Name = "Gecko App";
 	info.WorkingDir = WORKING_DIR_PATH;
+	// --no-render-thread renders on the main thread, to compare the two or to debug the renderer without the handoff.
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--no-render-thread") == 0)
+			info.UseRenderThread = false;
+	}
 
 	Gecko::Event::Init();
 	Gecko::Platform::Init(info);
 	Gecko::Input::Init();
-	Gecko::Logger::Init();
+	// Loading logs a burst of warnings, write them from a sink thread instead of stalling the loader.
+	Gecko::Logger::LoggerDesc loggerDesc;
+	loggerDesc.Mode = Gecko::Logger::LogMode::Async;
+	Gecko::Logger::Init(loggerDesc);
 
+	// Pin the threads before the context starts its IO threads.
+	Gecko::Threading::UseDefaultLayout();
+	Gecko::Threading::RegisterCurrentThread(Gecko::Threading::ThreadRole::Main);
 
 	// Create the context
 	Gecko::ApplicationContext ctx;
 	ctx.Init(info);
 
 	Gecko::Renderer* renderer = ctx.GetRenderer();
+	Gecko::RenderThread* renderThread = ctx.GetRenderThread();
 	Gecko::ResourceManager* resourceManager = ctx.GetResourceManager();
 	Gecko::SceneManager* sceneManager = ctx.GetSceneManager();
 
@@ -79,13 +104,13 @@ int main()
 	Gecko::Scene* sponzaScene = Gecko::GLTFSceneLoader::LoadScene("Assets/sponza/glb/Sponza.glb", ctx);
 	Gecko::SceneNode* sponzaNode = scene->GetRootNode()->AddNode("Sponza node");
 	sponzaNode->AppendScene(sponzaScene);
-	sponzaNode->Transform.Rotation.y = 90.f;
+	sponzaNode->EditTransform().Rotation.y = 90.f;
 
 	// Load Helmet gltf Scene
 	Gecko::Scene* helmetScene = Gecko::GLTFSceneLoader::LoadScene("Assets/gltfHelmet/glTF-Binary/DamagedHelmet.glb", ctx);
 	Gecko::SceneNode* helmetRootNode = scene->GetRootNode()->AddNode("Helmet node");
 	helmetRootNode->AppendScene(helmetScene);
-	helmetRootNode->Transform.Position.y = 3.f;
+	helmetRootNode->EditTransform().Position.y = 3.f;
 
 	// Create a camera in the scene
 	Gecko::SceneNode* cameraNode = scene->GetRootNode()->AddNode("Camera node");
@@ -93,8 +118,7 @@ int main()
 	camera->SetIsMain(true);
 	camera->SetAutoAspectRatio(true);
 	cameraNode->AttachCamera(camera);
-	cameraNode->Transform.Position.z = 4.f;
-	cameraNode->Transform.Position.y = 2.f;
+	cameraNode->EditTransform().Position = { 0.f, 2.f, 4.f };
 
 	// Create directional light
 	Gecko::SceneDirectionalLight* directionalLight = scene->CreateDirectionalLight();
@@ -102,60 +126,160 @@ int main()
 	directionalLight->SetColor({ 1., 1., 1. });
 	directionalLight->SetIntenstiy(1.f);
 	lightNode->AppendLight(directionalLight);
-	lightNode->Transform.Rotation.x = -90.f;
-
-	Gecko::f32 lastTime = Gecko::Platform::GetTime();
-	
+	lightNode->EditTransform().Rotation.x = -90.f;
+
+	// The swap chain already waits for vsync, the null device has nothing to wait on and is paced to 60 Hz instead.
+	Gecko::Time::FramePacerDesc pacerDesc;
+	pacerDesc.TargetFrameTime = Gecko::s_RenderAPI == Gecko::RenderAPI::Null ? Gecko::Time::FromFrequency(60.) : 0;
+	Gecko::Time::FramePacer framePacer(pacerDesc);
+	framePacer.WaitForNextFrame();
+
+	// Report allocations in the scene extraction and render once the first frames have warmed up the pools.
+	Gecko::Memory::SetAllocationGuardMode(Gecko::Memory::AllocationGuardMode::Record, 3);
+
+	// The frame as a graph, phases that do not touch the same resources run at the same time.
+	Gecko::FrameTaskGraph frameGraph;
+	Gecko::FrameResource inputResource = frameGraph.AddResource("Input");
+	Gecko::FrameResource sceneResource = frameGraph.AddResource("Scene");
+	Gecko::FrameResource debugUIResource = frameGraph.AddResource("DebugUI");
+	Gecko::FrameResource renderInfoResource = frameGraph.AddResource("SceneRenderInfo");
+	Gecko::FrameResource frameAllocatorResource = frameGraph.AddResource("FrameAllocator");
+	Gecko::FrameResource deviceResource = frameGraph.AddResource("Device");
+
+	Gecko::f32 deltaTime = 0.f;
+	std::optional<Gecko::SceneRenderInfo> sceneRenderInfo;
+
+	// Window messages fill the input state and resize events reach the cameras.
+	frameGraph.AddPhase({ "PumpMessage", [&ctx]()
+		{
+			Gecko::Platform::PumpMessage();
+			Gecko::Event::DispatchQueuedEvents();
+
+			// Samples the CPU usage once per frame, a crossed budget threshold is fired with the next frame's events.
+			ctx.GetResourceManager()->GetMemoryBudget().Update();
+		}, {}, { inputResource, sceneResource }, Gecko::PhaseThread::Main });
+
+	frameGraph.AddPhase({ "UpdateTransforms", [&]()
+		{
+			Gecko::NodeTransform& helmetTransform = helmetRootNode->EditTransform();
+			helmetTransform.Rotation.y += .73f * deltaTime * 50.f;
+			helmetTransform.Rotation.x += 1.6f * deltaTime * 50.f;
+			helmetTransform.Rotation.z += 1.0f * deltaTime * 50.f;
+
+			glm::vec3 rot{ 0. };
+
+			if (Gecko::Input::IsKeyDown(Gecko::Input::Key::UP))		rot.x += 1.f;
+			if (Gecko::Input::IsKeyDown(Gecko::Input::Key::DOWN))	rot.x -= 1.f;
+			if (Gecko::Input::IsKeyDown(Gecko::Input::Key::LEFT))	rot.y += 1.f;
+			if (Gecko::Input::IsKeyDown(Gecko::Input::Key::RIGHT))	rot.y -= 1.f;
+
+			// Only touch the camera when it moves, an untouched node keeps its cached matrices.
+			if (glm::length2(rot) > 0.)
+				cameraNode->EditTransform().Rotation += rot * deltaTime * 40.f;
+
+			glm::vec3 pos{ 0. };
+
+			if (Gecko::Input::IsKeyDown(Gecko::Input::Key::W))		pos.z -= 1.f;
+			if (Gecko::Input::IsKeyDown(Gecko::Input::Key::S))		pos.z += 1.f;
+			if (Gecko::Input::IsKeyDown(Gecko::Input::Key::A))		pos.x -= 1.f;
+			if (Gecko::Input::IsKeyDown(Gecko::Input::Key::D))		pos.x += 1.f;
+			if (Gecko::Input::IsKeyDown(Gecko::Input::Key::LSHIFT)) pos.y -= 1.f;
+			if (Gecko::Input::IsKeyDown(Gecko::Input::Key::SPACE))	pos.y += 1.f;
+			if (glm::length2(pos) > 0.)
+			{
+				pos = glm::normalize(pos);
+
+				glm::vec3 movement = glm::mat3(cameraNode->GetLocalMatrix()) * pos;
+
+				cameraNode->EditTransform().Position += movement * deltaTime;
+			}
+		}, { inputResource }, { sceneResource } });
+
+	// Do the imgui things, the node panel edits transforms. The ended frame is copied into the render thread's snapshot,
+	// so the UI never waits for the previous frame to be recorded.
+	frameGraph.AddPhase({ "DebugUIRenderer", [&ctx, renderer]()
+		{
+			renderer->BeginImGuiFrame();
+			Gecko::DebugUIRenderer::RenderDebugUI(ctx);
+			renderer->EndImGuiFrame();
+		}, {}, { debugUIResource, sceneResource }, Gecko::PhaseThread::Main });
+
+	frameGraph.AddPhase({ "GetSceneRenderInfo", [&]()
+		{
+			if (renderThread->IsRunning())
+			{
+				// Waits until the render thread is done with the snapshot, it is at most one frame behind.
+				renderThread->BeginFrame().Capture(*scene, *renderer);
+				return;
+			}
+			sceneRenderInfo.emplace(scene->GetSceneRenderInfo(Gecko::Memory::GetFrameAllocator()));
+		}, { sceneResource }, { renderInfoResource, frameAllocatorResource } });
+
+	// Only waits for the phases that read the input, so it overlaps with the scene extraction.
+	frameGraph.AddPhase({ "Input::Update", []()
+		{
+			Gecko::Input::Update();
+		}, {}, { inputResource }, Gecko::PhaseThread::Main });
+
+	frameGraph.AddPhase({ "RenderScene", [&]()
+		{
+			if (renderThread->IsRunning())
+			{
+				// Recorded and presented on the render thread while the main thread builds the next frame.
+				renderThread->SubmitFrame();
+				return;
+			}
+			renderer->RenderScene(*sceneRenderInfo);
+			// The frame allocator was reset, the render info points into it.
+			sceneRenderInfo.reset();
+		}, { debugUIResource }, { renderInfoResource, frameAllocatorResource, deviceResource }, Gecko::PhaseThread::Main });
+
+	const Gecko::u64 frameReportInterval = 600;
+
+	// Render on a thread of its own, the main thread prepares the next frame in the meantime.
+	if (info.UseRenderThread)
+	{
+		renderThread->Start();
+	}
 
 	while (Gecko::Platform::IsRunning()) {
-		Gecko::Platform::PumpMessage();
+		// Deltas come from integer ticks, so they stay precise however long the application runs.
+		deltaTime = static_cast<Gecko::f32>(Gecko::Time::ToSeconds(framePacer.WaitForNextFrame()));
 
-		Gecko::f32 currentTime = Gecko::Platform::GetTime();
-		Gecko::f32 deltaTime = (currentTime - lastTime);
-		lastTime = currentTime;
+		frameGraph.Execute();
 
-		helmetRootNode->Transform.Rotation.y += .73f * deltaTime * 50.f;
-		helmetRootNode->Transform.Rotation.x += 1.6f * deltaTime * 50.f;
-		helmetRootNode->Transform.Rotation.z += 1.0f * deltaTime * 50.f;
-	
-		glm::vec3 rot{ 0. };
-		
-		if (Gecko::Input::IsKeyDown(Gecko::Input::Key::UP))		rot.x += 1.f;
-		if (Gecko::Input::IsKeyDown(Gecko::Input::Key::DOWN))	rot.x -= 1.f;
-		if (Gecko::Input::IsKeyDown(Gecko::Input::Key::LEFT))	rot.y += 1.f;
-		if (Gecko::Input::IsKeyDown(Gecko::Input::Key::RIGHT))	rot.y -= 1.f;
-
-		cameraNode->Transform.Rotation += rot * deltaTime * 40.f;
-		
-		glm::vec3 pos{ 0. };
-
-		if (Gecko::Input::IsKeyDown(Gecko::Input::Key::W))		pos.z -= 1.f;
-		if (Gecko::Input::IsKeyDown(Gecko::Input::Key::S))		pos.z += 1.f;
-		if (Gecko::Input::IsKeyDown(Gecko::Input::Key::A))		pos.x -= 1.f;
-		if (Gecko::Input::IsKeyDown(Gecko::Input::Key::D))		pos.x += 1.f;
-		if (Gecko::Input::IsKeyDown(Gecko::Input::Key::LSHIFT)) pos.y -= 1.f;
-		if (Gecko::Input::IsKeyDown(Gecko::Input::Key::SPACE))	pos.y += 1.f;
-		if (glm::length2(pos) > 0.) pos = glm::normalize(pos);
-
-		glm::vec3 movement = glm::mat3(cameraNode->Transform.GetMat4()) * pos;
-		
-		cameraNode->Transform.Position += movement * deltaTime;
-
-		// Do the imgui things
-		Gecko::DebugUIRenderer::RenderDebugUI(ctx);
-		
-		renderer->RenderScene(scene->GetSceneRenderInfo());
-
-
-		Gecko::Input::Update();
+		if (frameGraph.GetLastReport().FrameIndex % frameReportInterval == 0)
+		{
+			frameGraph.LogReport();
+		}
 	}
 
+	if (renderThread->IsRunning())
+	{
+		renderThread->Stop();
+
+		Gecko::RenderThreadStats renderThreadStats = renderThread->GetStats();
+		LOG_INFO("Render thread: %llu frames, last frame idle %.3f ms, main thread blocked %.3f ms, %.3f ms from submit to present",
+			static_cast<unsigned long long>(renderThreadStats.NumFrames), Gecko::Time::ToMilliseconds(renderThreadStats.RenderThreadWait),
+			Gecko::Time::ToMilliseconds(renderThreadStats.MainThreadWait), Gecko::Time::ToMilliseconds(renderThreadStats.FrameLatency));
+	}
+
+	// Allocations in the guarded regions after the warmup fail the run, so a CI job running the example catches them.
+	Gecko::u64 guardedAllocations = Gecko::Memory::ReportAllocationGuard();
+
+	const Gecko::Time::FramePacerStats& pacerStats = framePacer.GetStats();
+	LOG_INFO("Frame pacer: %llu frames, %llu missed, overshoot average %.3f ms, max %.3f ms",
+		static_cast<unsigned long long>(pacerStats.NumFrames), static_cast<unsigned long long>(pacerStats.NumMissedFrames),
+		Gecko::Time::ToMilliseconds(static_cast<Gecko::u64>(pacerStats.AverageOvershoot)), Gecko::Time::ToMilliseconds(pacerStats.MaxOvershoot));
+
 	ctx.Shutdown();
 
+	Gecko::Memory::LogMemoryUsage();
+
 	Gecko::Logger::Shutdown();
 	Gecko::Input::Shutdown();
 	Gecko::Platform::Shutdown();
 	Gecko::Event::Shutdown();
 
-	return 0;
+	return guardedAllocations == 0 ? 0 : 1;
 }
\ No newline at end of file
@@ -3,7 +3,7 @@
 #include "Defines.h"
 #include "Rendering/Backend/CommandList.h"
 
-const void CustomPass::Init(Gecko::Platform::AppInfo& appInfo, Gecko::ResourceManager* resourceManager)
+void CustomPass::Init(Gecko::Platform::AppInfo& appInfo, Gecko::ResourceManager* resourceManager)
 {
 	// Simple colour output Compute Pipeline
 	{
@@ -32,12 +32,12 @@ const void CustomPass::Init(Gecko::Platform::AppInfo& appInfo, Gecko::ResourceMa
 	m_OutputHandle = resourceManager->CreateRenderTarget(renderTargetDesc, "ToneMappingGammaCorrection", true);
 }
 
-const void CustomPass::Render(const Gecko::SceneRenderInfo& sceneRenderInfo, Gecko::ResourceManager* resourceManager,
+void CustomPass::Render(const Gecko::SceneRenderInfo& sceneRenderInfo, Gecko::ResourceManager* resourceManager,
 	Gecko::Ref<Gecko::CommandList> commandList)
 {
 	Gecko::RenderTarget outputTarget = resourceManager->GetRenderTarget(m_OutputHandle);
 
-	Gecko::ComputePipeline CustomPipeline = resourceManager->GetComputePipeline(CustomPipelineHandle);
+	const Gecko::ComputePipeline& CustomPipeline = resourceManager->GetComputePipeline(CustomPipelineHandle);
 
 	commandList->BindComputePipeline(CustomPipeline);
 	commandList->BindAsRWTexture(0, outputTarget, Gecko::RenderTargetType::Target0);
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Defines.h"
+#include "Core/Memory.h"
+
+// The allocation guard hooks into Gecko::Memory, so it only exists when memory tracking does.
+#ifndef GECKO_ALLOCATION_GUARD
+#define GECKO_ALLOCATION_GUARD GECKO_MEMORY_TRACKING
+#endif
+
+namespace Gecko { namespace Memory {
+
+	enum class AllocationGuardMode : u8
+	{
+		// Guarded regions are ignored.
+		Disabled = 0,
+		// Allocations in a guarded region are recorded with their call stack.
+		Record,
+		// Like Record, but also asserts on the first allocation of every call site.
+		Assert
+	};
+
+	struct AllocationGuardStats
+	{
+		u64 FrameIndex{ 0 };
+		u64 AllocationsThisFrame{ 0 };
+		u64 AllocationsLastFrame{ 0 };
+		u64 BytesLastFrame{ 0 };
+		u64 TotalAllocations{ 0 };
+	};
+
+	// Guarded regions only start counting after warmupFrames calls to EndAllocationGuardFrame,
+	// so pools and frame allocators can grow to their steady state size first.
+	void SetAllocationGuardMode(AllocationGuardMode mode, u32 warmupFrames = 0);
+	AllocationGuardMode GetAllocationGuardMode();
+
+	// Rolls the per-frame counts over, the renderer calls this at the end of every frame.
+	void EndAllocationGuardFrame();
+	AllocationGuardStats GetAllocationGuardStats();
+
+	// Logs every call site that allocated in a guarded region and returns the number of guarded allocations,
+	// a test can fail when this is not zero.
+	u64 ReportAllocationGuard();
+	void ResetAllocationGuard();
+
+	// Marks the current thread's scope as allocation-free, regions can be nested.
+	class ScopedAllocationGuard
+	{
+	public:
+#if GECKO_ALLOCATION_GUARD
+		explicit ScopedAllocationGuard(const char* region);
+		~ScopedAllocationGuard();
+#else
+		explicit ScopedAllocationGuard(const char*) {}
+		~ScopedAllocationGuard() {}
+#endif
+
+		ScopedAllocationGuard(const ScopedAllocationGuard&) = delete;
+		ScopedAllocationGuard& operator=(const ScopedAllocationGuard&) = delete;
+
+	private:
+#if GECKO_ALLOCATION_GUARD
+		const char* m_PreviousRegion;
+#endif
+	};
+
+#if GECKO_ALLOCATION_GUARD
+	// Called by Memory::Allocate/Reallocate, returns quickly when the thread is not in a guarded region.
+	void OnGuardedAllocation(size_t size, MemoryTag tag);
+#endif
+
+} }
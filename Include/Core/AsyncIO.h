@@ -0,0 +1,79 @@
+#pragma once
+#include "Defines.h"
+
+// Reads whole files in the background. Requests are started in priority order, their callbacks run on the
+// thread that calls ProcessCompletions or Wait, so a loader can decode one file while the next ones are still being read.
+// On Linux loose files are read with io_uring, files in packs and every file on other platforms are
+// mapped and paged in by a pool of worker threads. Paths are FileSystem paths.
+
+namespace Gecko { namespace IO
+{
+
+	enum class IOPriority : u8
+	{
+		High = 0,
+		Normal,
+		Low,
+
+		MaxPriorities
+	};
+
+	enum class IOStatus : u8
+	{
+		Pending = 0,
+		Completed,
+		Failed,
+		Cancelled
+	};
+
+	// Same scheme as Event::ListenerHandle, a handle to a finished request never matches the request that reuses its slot.
+	struct IORequestHandle
+	{
+		static constexpr u32 INVALID_INDEX = 0xFFFFFFFF;
+
+		u32 Index{ INVALID_INDEX };
+		u32 Generation{ 0 };
+
+		inline bool IsValid() const { return Index != INVALID_INDEX; }
+	};
+
+	struct IOResult
+	{
+		IORequestHandle Handle;
+		IOStatus Status{ IOStatus::Pending };
+		// Owned by the service and only valid during the callback, nullptr unless the status is Completed.
+		const u8* Data{ nullptr };
+		u64 Size{ 0 };
+		const char* Path{ nullptr };
+	};
+
+	// Called exactly once for every request, also when it failed or was cancelled.
+	using IOCallback = void(*)(const IOResult& result, void* userData);
+
+	struct IOServiceDesc
+	{
+		// Worker threads for mapped files and the fallback backend.
+		u32 NumThreads{ 2 };
+		// Reads in flight at once on io_uring.
+		u32 QueueDepth{ 64 };
+		bool UseIOUring{ true };
+	};
+
+	bool Init(const IOServiceDesc& desc = IOServiceDesc());
+	// Cancels what has not started, waits for the reads in flight and runs the remaining callbacks.
+	void Shutdown();
+
+	IORequestHandle ReadFile(const std::string& path, IOPriority priority, IOCallback callback, void* userData = nullptr);
+	// A request that has not started is dropped right away, one in flight reports Cancelled when it finishes.
+	// False when the request already finished.
+	bool Cancel(IORequestHandle handle);
+
+	// Runs the callbacks of finished requests on the calling thread and returns how many ran.
+	u32 ProcessCompletions();
+	// Blocks until the request finished and its callback ran, callbacks of other finished requests run as well.
+	void Wait(IORequestHandle handle);
+	void WaitAll();
+
+	const char* GetBackendName();
+
+} }
@@ -0,0 +1,83 @@
+#pragma once
+#include "Defines.h"
+#include "Core/Logger.h"
+
+#include <stdarg.h>
+
+// The binary log written in LogMode::Binary. Every LOG_* call site registers its format string once,
+// after that a message only stores its format ID and the raw printf arguments. GeckoLogDecoder turns the file back into text.
+//
+// File layout: BINARY_LOG_MAGIC, u32 BINARY_LOG_VERSION, then a stream of entries that each start with a BinaryLogEntry byte.
+//	Format:  u32 ID, u8 Level, u32 Line, u16 FileLength, File, u16 FormatLength, Format
+//	Message: u16 PayloadLength, u32 FormatID, u64 Timestamp in nanoseconds, arguments
+//	Text:    u8 Level, u16 TextLength, Text
+//	Dropped: u64 Count
+// A format entry is always written before the first message that uses it. Integer, float and pointer arguments take 8 bytes,
+// strings a u16 length followed by the characters.
+
+namespace Gecko { namespace Logger
+{
+
+	constexpr char BINARY_LOG_MAGIC[8] = { 'G', 'K', 'B', 'L', 'O', 'G', '0', '1' };
+	constexpr u32 BINARY_LOG_VERSION = 1;
+	constexpr u32 MAX_FORMAT_ARGUMENTS = 16;
+	constexpr u32 MAX_BINARY_STRING_LENGTH = 1024;
+	constexpr u32 INVALID_FORMAT_ID = 0xFFFFFFFF;
+
+	enum class BinaryLogEntry : u8
+	{
+		Format = 1,
+		Message,
+		Text,
+		Dropped
+	};
+
+	// How an argument is read from the va_list, integers that are not promoted to int are read with their own type.
+	enum class FormatArgument : u8
+	{
+		Int = 0,
+		Long,
+		LongLong,
+		Size,
+		IntMax,
+		PtrDiff,
+		Double,
+		LongDouble,
+		Pointer,
+		String
+	};
+
+	struct FormatSpec
+	{
+		FormatArgument Argument;
+		// Position of the conversion specification in the format string, starting at the '%'.
+		u16 Offset;
+		u16 Length;
+	};
+
+	struct FormatInfo
+	{
+		// The pointer passed at the call site, a message with a different format pointer is logged as text.
+		const char* CallSiteFormat{ nullptr };
+		// Owned copies, the call site may pass a temporary.
+		char* Format{ nullptr };
+		char* File{ nullptr };
+		u32 Line{ 0 };
+		eLogLevel Level{ LOG_LEVEL_INFO };
+		// False when the format uses something the binary log can't store, like '*' widths or %n.
+		bool Binary{ false };
+		u32 NumArguments{ 0 };
+		FormatSpec Arguments[MAX_FORMAT_ARGUMENTS];
+	};
+
+	// Fills specs with the conversions in format and returns how many there are, or -1 when the format can't be logged in binary.
+	i32 ParseFormat(const char* format, FormatSpec* specs, u32 maxSpecs);
+
+	// Formats that are registered so far, IDs are handed out in order starting at 0.
+	u32 GetNumFormats();
+	const FormatInfo& GetFormatInfo(u32 formatID);
+
+	// Writes the Message payload for a call site, returns the number of bytes written or 0 when it did not fit.
+	size_t EncodeMessage(const FormatInfo& info, u32 formatID, u64 timestamp, u8* buffer, size_t bufferSize, va_list args);
+
+} }
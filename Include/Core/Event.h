@@ -2,6 +2,10 @@
 #include "Defines.h"
 #include "Core/Logger.h"
 
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
 namespace Gecko { namespace Event 
 {
 
@@ -19,6 +23,8 @@ namespace Gecko { namespace Event
 
 		CODE_IMGUI_EVENT = 0x09,
 
+		CODE_MEMORY_PRESSURE = 0x0A,
+
 		MAX_EVENT_CODE = 0xFF
 	};
 
@@ -26,21 +32,22 @@ namespace Gecko { namespace Event
 	{
 		u32 Code{ SystemEvent::CODE_NONE };
 		void* Sender;
+		// The types are qualified, GCC rejects members that change the meaning of the type name they are declared with.
 		union
 		{
-			i64 i64[2];
-			u64 u64[2];
-			f64 f64[2];
+			Gecko::i64 i64[2];
+			Gecko::u64 u64[2];
+			Gecko::f64 f64[2];
 
-			i32 i32[4];
-			u32 u32[4];
-			f32 f32[4];
+			Gecko::i32 i32[4];
+			Gecko::u32 u32[4];
+			Gecko::f32 f32[4];
 
-			i16 i16[8];
-			u16 u16[8];
+			Gecko::i16 i16[8];
+			Gecko::u16 u16[8];
 
-			i8 i8[16];
-			u8 u8[16];
+			Gecko::i8 i8[16];
+			Gecko::u8 u8[16];
 
 			char c[16];
 		} Data;
@@ -48,102 +55,207 @@ namespace Gecko { namespace Event
 
 	bool Init();
 	void Shutdown();
+
+	// Calls every listener right away, only call this from the main thread.
 	void FireEvent(u32 code, const EventData& data);
 
-	class EventCallbackInterface;
-	void EventRegister(u32 code, EventCallbackInterface* eventCallback);
-	void EventUnregister(u32 code, EventCallbackInterface* eventCallback);
+	// Queues the event for the next DispatchQueuedEvents, can be called from any thread.
+	void PostEvent(u32 code, const EventData& data);
+	// Fires every event posted since the last call, the main loop calls this once per frame.
+	// Of the events with a coalesced code only the last one in the queue is fired.
+	void DispatchQueuedEvents();
+	// CODE_MOUSE_MOVED and CODE_RESIZED are coalesced by default.
+	void SetEventCoalescing(u32 code, bool coalesce);
 
-	class EventCallbackInterface
-	{
-	public:
-		EventCallbackInterface() = default;
-		virtual ~EventCallbackInterface() {};
-		virtual bool operator() (const EventData& data) = 0;
-		virtual bool operator == (const EventCallbackInterface& other) const = 0;
-	};
-
-	template<typename T>
-	class EventListener;
+	// Typed events are plain structs that declare their id with GECKO_TYPED_EVENT, for example:
+	//
+	//	struct AssetLoadedEvent
+	//	{
+	//		GECKO_TYPED_EVENT(AssetLoadedEvent);
+	//		MeshHandle Mesh;
+	//		char Path[48];
+	//	};
+	//
+	// They are copied by value into the event queue, so they have to be trivially copyable and fit in MAX_TYPED_EVENT_SIZE.
+	constexpr size_t MAX_TYPED_EVENT_SIZE = 64;
+	constexpr u32 TYPED_EVENT_BIT = 0x80000000;
 
-	template<typename T>
-	class EventCallback : public EventCallbackInterface
+	// FNV-1a of the name, with the top bit set so typed ids never collide with the system codes.
+	constexpr u32 TypedEventID(const char* name)
 	{
-	public:
-		EventCallback(u32 code, T* listener, bool (T::* callback)(const EventData& data))
-			: m_Listener(listener)
-			, m_Callback(callback)
-			, m_Code(code)
+		u32 hash = 0x811C9DC5;
+		while (*name != '\0')
 		{
-			EventRegister(m_Code, this);
+			hash ^= static_cast<u8>(*name++);
+			hash *= 0x01000193;
 		}
+		return hash | TYPED_EVENT_BIT;
+	}
 
-		virtual ~EventCallback() override
-		{
-			EventUnregister(m_Code, this);
-		}
+#define GECKO_TYPED_EVENT(name) static constexpr Gecko::u32 EventID = Gecko::Event::TypedEventID(#name)
+
+	template<typename E>
+	constexpr void ValidateTypedEvent()
+	{
+		STATIC_ASSERT((E::EventID & TYPED_EVENT_BIT) != 0, "Typed event ids have to come from GECKO_TYPED_EVENT.");
+		STATIC_ASSERT(std::is_trivially_copyable<E>::value, "Typed events have to be trivially copyable.");
+		STATIC_ASSERT(sizeof(E) <= MAX_TYPED_EVENT_SIZE, "Typed event is larger than MAX_TYPED_EVENT_SIZE.");
+		STATIC_ASSERT(alignof(E) <= alignof(std::max_align_t), "Typed events can not be over-aligned.");
+	}
+
+	// Untyped entry points behind the typed API, the payload is an EventData for system codes and the event struct for typed ids.
+	void FirePayload(u32 code, const void* payload);
+	void PostPayload(u32 code, const void* payload, size_t size);
 
-		virtual bool operator () (const EventData& data) override
+	template<typename E>
+	void Fire(const E& event)
+	{
+		ValidateTypedEvent<E>();
+		FirePayload(E::EventID, &event);
+	}
+
+	template<typename E>
+	void Post(const E& event)
+	{
+		ValidateTypedEvent<E>();
+		PostPayload(E::EventID, &event, sizeof(E));
+	}
+
+	// Identifies one registered callback. The generation is bumped whenever a slot is released,
+	// so a handle to a removed callback never matches the callback that reuses its slot.
+	struct ListenerHandle
+	{
+		static constexpr u32 INVALID_INDEX = 0xFFFFFFFF;
+
+		u32 Index{ INVALID_INDEX };
+		u32 Generation{ 0 };
+
+		inline bool IsValid() const { return Index != INVALID_INDEX; }
+	};
+
+	// A member function callback together with the instance it is called on, stored by value.
+	// Invoke is a function instantiated for the exact listener and payload type, there is no virtual call involved.
+	struct EventDelegate
+	{
+		static constexpr size_t MAX_CALLBACK_SIZE = 16;
+		using InvokeFunction = bool(*)(const EventDelegate& delegate, const void* payload);
+
+		void* Instance{ nullptr };
+		InvokeFunction Invoke{ nullptr };
+		alignas(void*) u8 Callback[MAX_CALLBACK_SIZE]{};
+
+		// P is EventData for system events or the typed event struct.
+		template<typename T, typename P>
+		static EventDelegate Create(T* instance, bool (T::* callback)(const P& payload))
 		{
-			return (m_Listener->*m_Callback)(data);
+			STATIC_ASSERT(sizeof(callback) <= MAX_CALLBACK_SIZE, "Member function pointer does not fit in an EventDelegate.");
+
+			EventDelegate delegate;
+			delegate.Instance = instance;
+			delegate.Invoke = &InvokeMember<T, P>;
+			memcpy(delegate.Callback, &callback, sizeof(callback));
+			return delegate;
 		}
 
-		virtual bool operator == (const EventCallbackInterface& other) const override
+		inline bool operator() (const void* payload) const { return Invoke(*this, payload); }
+
+		inline bool HasSameCallback(const EventDelegate& other) const
 		{
-			const EventCallback<T>* otherEventCallback = reinterpret_cast<const EventCallback<T>*>(&other);
-			
-			if (otherEventCallback == nullptr)
-				return false;
-			
-			return (this->m_Callback == otherEventCallback->m_Callback) &&
-				   (this->m_Listener == otherEventCallback->m_Listener) &&
-				   (this->m_Code == otherEventCallback->m_Code);
+			return Instance == other.Instance && Invoke == other.Invoke && memcmp(Callback, other.Callback, MAX_CALLBACK_SIZE) == 0;
 		}
 
 	private:
-		bool (T::* m_Callback)(const EventData& data);
-		T* m_Listener;
-		u32 m_Code;
-		friend class EventListener<T>;
+		template<typename T, typename P>
+		static bool InvokeMember(const EventDelegate& delegate, const void* payload)
+		{
+			bool (T::* callback)(const P& payload);
+			memcpy(&callback, delegate.Callback, sizeof(callback));
+			return (static_cast<T*>(delegate.Instance)->*callback)(*static_cast<const P*>(payload));
+		}
 	};
 
+	[[nodiscard]] ListenerHandle EventRegister(u32 code, const EventDelegate& delegate);
+	void EventUnregister(ListenerHandle handle);
+
 	template<typename T>
 	class EventListener
 	{
 	protected:
 		EventListener() = default;
-		virtual ~EventListener() = default;
+		virtual ~EventListener()
+		{
+			for (const Registration& registration : m_Registrations)
+			{
+				EventUnregister(registration.Handle);
+			}
+		}
 
 		void AddEventListener(u32 code, bool(T::* callback)(const EventData& data))
 		{
-			for (std::vector<Ref<EventCallback<T>>>::iterator it = m_EventListeners.begin(); it != m_EventListeners.end(); it++)
+			AddListener(code, EventDelegate::Create(reinterpret_cast<T*>(this), callback));
+		}
+
+		void RemoveEventListener(u32 code, bool(T::* callback)(const EventData& data))
+		{
+			RemoveListener(code, EventDelegate::Create(reinterpret_cast<T*>(this), callback));
+		}
+
+		template<typename E>
+		void AddEventListener(bool(T::* callback)(const E& event))
+		{
+			ValidateTypedEvent<E>();
+			AddListener(E::EventID, EventDelegate::Create(reinterpret_cast<T*>(this), callback));
+		}
+
+		template<typename E>
+		void RemoveEventListener(bool(T::* callback)(const E& event))
+		{
+			RemoveListener(E::EventID, EventDelegate::Create(reinterpret_cast<T*>(this), callback));
+		}
+
+	private:
+		void AddListener(u32 code, const EventDelegate& delegate)
+		{
+			for (const Registration& registration : m_Registrations)
 			{
-				if ((*it)->m_Code == code && (*it)->m_Listener == reinterpret_cast<T*>(this) && (*it)->m_Callback == callback)
+				if (registration.Code == code && registration.Delegate.HasSameCallback(delegate))
 				{
-					LOG_WARN("Event callback already exist in this EventListener");
+					LOG_CHANNEL_WARN(Event, "Event callback already exist in this EventListener");
 					return;
 				}
 			}
 
-			m_EventListeners.push_back(
-				CreateRef<EventCallback<T>>(code, reinterpret_cast<T*>(this), callback)
-			);
+			Registration registration;
+			registration.Code = code;
+			registration.Delegate = delegate;
+			registration.Handle = EventRegister(code, delegate);
+			m_Registrations.push_back(registration);
 		}
-		void RemoveEventListener(u32 code, bool(T::* callback)(const EventData& data))
+
+		void RemoveListener(u32 code, const EventDelegate& delegate)
 		{
-			for (std::vector<Ref<EventCallback<T>>>::iterator it = m_EventListeners.begin(); it != m_EventListeners.end(); it++)
+			for (size_t i = 0; i < m_Registrations.size(); i++)
 			{
-				if ((*it)->m_Code == code && (*it)->m_Listener == reinterpret_cast<T*>(this) && (*it)->m_Callback == callback)
+				if (m_Registrations[i].Code == code && m_Registrations[i].Delegate.HasSameCallback(delegate))
 				{
-					m_EventListeners.erase(it);
+					EventUnregister(m_Registrations[i].Handle);
+					m_Registrations[i] = m_Registrations.back();
+					m_Registrations.pop_back();
 					return;
 				}
 			}
-			LOG_WARN("Event doesn't exist on this EventListener!");
+			LOG_CHANNEL_WARN(Event, "Event doesn't exist on this EventListener!");
 		}
 
 	private:
-		std::vector<Ref<EventCallback<T>>> m_EventListeners;
+		struct Registration
+		{
+			u32 Code;
+			EventDelegate Delegate;
+			ListenerHandle Handle;
+		};
+
+		std::vector<Registration> m_Registrations;
 	};
 
-} }
\ No newline at end of file
+} }
@@ -0,0 +1,46 @@
+#pragma once
+#include "Defines.h"
+
+namespace Gecko { namespace FileSystem
+{
+
+	struct MappedFile;
+
+	// A read-only view of a whole file. Copies share the mapping, which is released when the last view is destroyed,
+	// so a view stays valid after its mount is removed.
+	class FileView
+	{
+	public:
+		FileView() = default;
+		FileView(Ref<MappedFile> mapping, const u8* data, u64 size, std::string nativePath);
+
+		const u8* GetData() const { return m_Data; }
+		u64 GetSize() const { return m_Size; }
+		bool IsValid() const { return m_Mapping != nullptr; }
+
+		// The file on disk for views from a mounted directory, empty for files inside a pack.
+		const std::string& GetNativePath() const { return m_NativePath; }
+
+	private:
+		Ref<MappedFile> m_Mapping{ nullptr };
+		const u8* m_Data{ nullptr };
+		u64 m_Size{ 0 };
+		std::string m_NativePath;
+	};
+
+	// Virtual paths use '/' and are relative, for example "Assets/sponza/glb/Sponza.glb".
+	// A mount point is a virtual directory prefix, "" mounts at the root. When several mounts contain a path
+	// the most recent mount wins, so a pack mounted over a directory overrides the loose files.
+	bool MountDirectory(const std::string& mountPoint, const std::string& directory);
+	bool MountPack(const std::string& mountPoint, const std::string& packPath);
+	// Removes the most recent mount at this mount point.
+	bool Unmount(const std::string& mountPoint);
+	void UnmountAll();
+
+	bool Exists(const std::string& path);
+	// Maps the file, an invalid view when no mount has it.
+	FileView Open(const std::string& path);
+	// For APIs that only take paths, empty when the file is not a loose file in a mounted directory.
+	std::string GetNativePath(const std::string& path);
+
+} }
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Defines.h"
+#include "Core/Time.h"
+
+namespace Gecko { namespace Time {
+
+	struct FramePacerDesc
+	{
+		// Frame interval in ticks, see Time::FromFrequency. 0 only measures frames and never waits.
+		u64 TargetFrameTime{ 0 };
+		// The pacer sleeps until this long before a deadline and spins for the rest. It grows when the OS
+		// oversleeps, up to half the frame interval, and shrinks back towards this value when sleeps get accurate again.
+		u64 MinSpinMargin{ 500 * TICKS_PER_MICROSECOND };
+	};
+
+	// All times are in ticks.
+	struct FramePacerStats
+	{
+		u64 NumFrames{ 0 };
+		// Time between the start of the last two frames.
+		u64 LastFrameTime{ 0 };
+		// How late the last paced frame started compared to its deadline, this is the pacer's own error.
+		u64 LastOvershoot{ 0 };
+		u64 MaxOvershoot{ 0 };
+		// Exponential moving average over roughly the last 64 paced frames.
+		f64 AverageOvershoot{ 0. };
+		// Frames that were already late when they asked to wait, their deadline was moved instead of catching up.
+		u64 NumMissedFrames{ 0 };
+		u64 SpinMargin{ 0 };
+	};
+
+	// Starts frames on a fixed interval. Deadlines are absolute, every frame is scheduled one interval after the
+	// previous deadline rather than after the previous wake-up, so small errors do not accumulate into drift.
+	class FramePacer
+	{
+	public:
+		FramePacer(const FramePacerDesc& desc = FramePacerDesc());
+		~FramePacer() {};
+
+		void SetTargetFrameTime(u64 ticks);
+		u64 GetTargetFrameTime() const;
+
+		// Waits until the next frame is due and returns the ticks since the previous call, 0 on the first call.
+		u64 WaitForNextFrame();
+
+		const FramePacerStats& GetStats() const;
+		void ResetStats();
+
+	private:
+		void UpdateSpinMargin(u64 sleepError);
+
+	private:
+		FramePacerDesc m_Desc;
+		FramePacerStats m_Stats;
+
+		u64 m_LastFrameStart{ 0 };
+		u64 m_NextDeadline{ 0 };
+		u64 m_SpinMargin{ 0 };
+		bool m_Started{ false };
+	};
+
+} }
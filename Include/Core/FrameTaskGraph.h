@@ -0,0 +1,122 @@
+#pragma once
+
+#include "Defines.h"
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Runs the phases of a frame as a graph instead of a fixed sequence. Phases name the resources they read and write,
+// a phase waits for the last earlier phase that wrote what it touches and writers also wait for the readers before them.
+// Everything else runs at the same time on the job system. Phases that must stay on the main thread (window messages,
+// the UI, GPU submission) are run by Execute itself, which works on queued jobs while it waits for them.
+
+namespace Gecko
+{
+
+	using FrameResource = u32;
+
+	enum class PhaseThread : u8
+	{
+		// A job system worker or the main thread, whichever is free first.
+		Any = 0,
+		Main
+	};
+
+	struct FramePhaseDesc
+	{
+		std::string Name;
+		std::function<void()> Function;
+		std::vector<FrameResource> Reads;
+		std::vector<FrameResource> Writes;
+		PhaseThread Thread{ PhaseThread::Any };
+	};
+
+	// Ticks since the start of Execute, see Core/Time.h.
+	struct FramePhaseTiming
+	{
+		u64 Start{ 0 };
+		u64 End{ 0 };
+		// See Jobs::GetThreadIndex.
+		u32 ThreadIndex{ 0 };
+	};
+
+	struct FrameTaskReport
+	{
+		u64 FrameIndex{ 0 };
+		u64 FrameTime{ 0 };
+		// Indexed by phase.
+		std::vector<FramePhaseTiming> Phases;
+		// The phases that held up the end of the frame, first to last. Every phase on it started once the one before it
+		// finished, either because it depends on it or because it ran on the same thread.
+		std::vector<u32> CriticalPath;
+		// Time on the critical path not spent in a phase, scheduling and waiting for a free thread.
+		u64 CriticalPathIdle{ 0 };
+		// The longest phase on the critical path, making it shorter is what shortens the frame.
+		u32 BoundingPhase{ 0 };
+	};
+
+	class FrameTaskGraph
+	{
+	public:
+		FrameTaskGraph() = default;
+		~FrameTaskGraph() {};
+
+		FrameTaskGraph(const FrameTaskGraph&) = delete;
+		FrameTaskGraph& operator=(const FrameTaskGraph&) = delete;
+
+		// Resources are only names for the dependencies, the graph never touches what they stand for.
+		FrameResource AddResource(const std::string& name);
+		// Phases are ordered by registration, a phase can only depend on the ones added before it. Returns the phase index.
+		u32 AddPhase(const FramePhaseDesc& desc);
+
+		// Runs every phase once, must be called from the thread that initialized the job system.
+		void Execute();
+
+		u32 GetPhaseCount() const;
+		const std::string& GetPhaseName(u32 phase) const;
+		// Phases the given phase waits for.
+		const std::vector<u32>& GetPhaseDependencies(u32 phase) const;
+
+		const FrameTaskReport& GetLastReport() const;
+		void LogReport() const;
+
+	private:
+		struct Phase
+		{
+			FramePhaseDesc Desc;
+			std::vector<u32> Dependencies;
+			std::vector<u32> Dependents;
+		};
+
+		struct PhaseJobData
+		{
+			FrameTaskGraph* Graph;
+			u32 PhaseIndex;
+		};
+
+		void Build();
+		void RunPhase(u32 phase);
+		void BuildReport(u64 frameTime);
+
+		static void ExecutePhaseJob(void* data);
+
+	private:
+		std::vector<std::string> m_Resources;
+		std::vector<Phase> m_Phases;
+		std::vector<u32> m_MainPhases;
+		std::vector<PhaseJobData> m_JobData;
+		bool m_Dirty{ false };
+
+		// Per frame state, sized by Build so Execute does not allocate.
+		std::vector<std::atomic<u32>> m_PendingDependencies;
+		std::vector<u8> m_MainPhaseDone;
+		std::atomic<u32> m_NumRemaining{ 0 };
+		u64 m_FrameStart{ 0 };
+		u64 m_FrameIndex{ 0 };
+
+		FrameTaskReport m_Report;
+	};
+
+}
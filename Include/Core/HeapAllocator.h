@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Defines.h"
+
+namespace Gecko { namespace Memory {
+
+	// General purpose size-class allocator, Memory::Allocate sits on top of it.
+	// Small blocks come from 64 KiB spans that are handed out to per-thread caches in batches,
+	// so the common path never takes a lock. Blocks above the largest size class get their own pages, which are
+	// kept in a small cache after they are freed when they are at most 1 MiB.
+	constexpr size_t HEAP_DEFAULT_ALIGNMENT = 16;
+	constexpr size_t HEAP_SPAN_SIZE = 64 * 1024;
+	// Blocks from this size on get huge pages, see Platform::AllocateHugePages. Decoded images and mesh buffers
+	// are well above it, and at this size rounding up to whole huge pages wastes at most a third of the block.
+	constexpr size_t HEAP_HUGE_PAGE_THRESHOLD = 4 * 1024 * 1024;
+
+	[[nodiscard]] void* HeapAllocate(size_t size, size_t alignment = HEAP_DEFAULT_ALIGNMENT);
+	[[nodiscard]] void* HeapReallocate(void* mem, size_t size);
+	void HeapFree(void* mem);
+
+	// Number of bytes that can be used in a block, this is at least the requested size.
+	size_t HeapUsableSize(void* mem);
+
+} }
@@ -0,0 +1,186 @@
+#pragma once
+#include "Defines.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+// Runs small jobs on a pool of worker threads. Every worker has its own queue: it takes its newest job first,
+// idle workers steal the oldest jobs of the others. Jobs are tracked with counters, Wait on a counter runs other jobs
+// until it drops to zero, so the waiting thread helps instead of blocking. RunAfter starts a job once a counter is done.
+
+namespace Gecko { namespace Jobs
+{
+
+	using JobFunction = void(*)(void* data);
+
+	struct Job
+	{
+		JobFunction Function{ nullptr };
+		void* Data{ nullptr };
+	};
+
+	// Number of jobs that have not finished yet. Must outlive the jobs it tracks, a counter can be reused once Wait returned.
+	struct JobCounter
+	{
+		JobCounter() = default;
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		inline bool IsDone() const { return Value.load(std::memory_order_acquire) == 0; }
+
+		// Only touched by the job system.
+		struct Continuation
+		{
+			Job ContinuationJob;
+			JobCounter* Counter;
+		};
+
+		std::atomic<u32> Value{ 0 };
+		std::atomic_flag Lock = ATOMIC_FLAG_INIT;
+		std::vector<Continuation> Continuations;
+	};
+
+	struct JobSystemDesc
+	{
+		// 0 takes Threading::GetWorkerCount.
+		u32 NumWorkers{ 0 };
+	};
+
+	// The thread that calls Init gets a queue of its own, jobs it runs are worked on by Wait as well.
+	bool Init(const JobSystemDesc& desc = JobSystemDesc());
+	// Expects all jobs to be finished.
+	void Shutdown();
+
+	// Counters are incremented before the jobs are queued and decremented after they ran.
+	void Run(JobFunction function, void* data, JobCounter* counter = nullptr);
+	void Run(const Job* jobs, u32 numJobs, JobCounter* counter = nullptr);
+	// Queues the job once the dependency reached zero, right away when it already is. The counter is incremented immediately.
+	void RunAfter(JobCounter& dependency, JobFunction function, void* data, JobCounter* counter = nullptr);
+	void Wait(JobCounter& counter);
+	// Runs one queued job on the calling thread, false when there was none. For threads that wait on something other than a counter.
+	bool RunPendingJob();
+
+	u32 GetNumWorkers();
+	// 0 for the thread that called Init, 1 to NumWorkers for the workers and NumWorkers + 1 for every other thread.
+	u32 GetThreadIndex();
+
+	// Splits [begin, end) into ranges of grainSize elements and calls function(rangeBegin, rangeEnd) for each of them
+	// on the workers, returns once all ranges are done. A grainSize of 0 makes about four ranges per thread.
+	template<typename Function>
+	void ParallelFor(u32 begin, u32 end, u32 grainSize, const Function& function);
+
+	// Maps every range to a T with map(rangeBegin, rangeEnd) and combines the results with reduce(T, T), in range order,
+	// so the result is the same on every run as long as reduce is associative.
+	template<typename T, typename MapFunction, typename ReduceFunction>
+	T ParallelReduce(u32 begin, u32 end, u32 grainSize, T identity, const MapFunction& map, const ReduceFunction& reduce);
+
+	namespace Internal
+	{
+		inline u32 GetGrainSize(u32 count, u32 grainSize)
+		{
+			if (grainSize > 0)
+				return grainSize;
+
+			u32 numRanges = (GetNumWorkers() + 1) * 4;
+			return std::max(1u, (count + numRanges - 1) / numRanges);
+		}
+
+		template<typename Function>
+		struct ParallelForRange
+		{
+			const Function* RangeFunction;
+			u32 Begin;
+			u32 End;
+
+			static void Execute(void* data)
+			{
+				ParallelForRange* range = static_cast<ParallelForRange*>(data);
+				(*range->RangeFunction)(range->Begin, range->End);
+			}
+		};
+
+		template<typename T, typename MapFunction>
+		struct ParallelReduceRange
+		{
+			const MapFunction* Map;
+			u32 Begin;
+			u32 End;
+			T Result;
+
+			static void Execute(void* data)
+			{
+				ParallelReduceRange* range = static_cast<ParallelReduceRange*>(data);
+				range->Result = (*range->Map)(range->Begin, range->End);
+			}
+		};
+
+		// The calling thread runs the first range itself instead of queueing it and waiting right away.
+		template<typename Range>
+		void RunRanges(std::vector<Range>& ranges)
+		{
+			std::vector<Job> jobs(ranges.size() - 1);
+			for (u32 i = 1; i < ranges.size(); i++)
+			{
+				jobs[i - 1].Function = Range::Execute;
+				jobs[i - 1].Data = &ranges[i];
+			}
+
+			JobCounter counter;
+			Run(jobs.data(), static_cast<u32>(jobs.size()), &counter);
+			Range::Execute(&ranges[0]);
+			Wait(counter);
+		}
+	}
+
+	template<typename Function>
+	void ParallelFor(u32 begin, u32 end, u32 grainSize, const Function& function)
+	{
+		if (begin >= end)
+			return;
+
+		u32 count = end - begin;
+		grainSize = Internal::GetGrainSize(count, grainSize);
+		if (grainSize >= count)
+		{
+			function(begin, end);
+			return;
+		}
+
+		std::vector<Internal::ParallelForRange<Function>> ranges;
+		ranges.reserve((count + grainSize - 1) / grainSize);
+		for (u32 rangeBegin = begin; rangeBegin < end; rangeBegin += std::min(grainSize, end - rangeBegin))
+		{
+			ranges.push_back({ &function, rangeBegin, rangeBegin + std::min(grainSize, end - rangeBegin) });
+		}
+		Internal::RunRanges(ranges);
+	}
+
+	template<typename T, typename MapFunction, typename ReduceFunction>
+	T ParallelReduce(u32 begin, u32 end, u32 grainSize, T identity, const MapFunction& map, const ReduceFunction& reduce)
+	{
+		if (begin >= end)
+			return identity;
+
+		u32 count = end - begin;
+		grainSize = Internal::GetGrainSize(count, grainSize);
+		if (grainSize >= count)
+			return reduce(identity, map(begin, end));
+
+		std::vector<Internal::ParallelReduceRange<T, MapFunction>> ranges;
+		ranges.reserve((count + grainSize - 1) / grainSize);
+		for (u32 rangeBegin = begin; rangeBegin < end; rangeBegin += std::min(grainSize, end - rangeBegin))
+		{
+			ranges.push_back({ &map, rangeBegin, rangeBegin + std::min(grainSize, end - rangeBegin), identity });
+		}
+		Internal::RunRanges(ranges);
+
+		T result = identity;
+		for (const Internal::ParallelReduceRange<T, MapFunction>& range : ranges)
+		{
+			result = reduce(result, range.Result);
+		}
+		return result;
+	}
+
+} }
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Defines.h"
+#include "Core/Memory.h"
+
+#include <cstddef>
+
+namespace Gecko { namespace Memory {
+
+	// Bump allocator, individual allocations are never freed, everything is released at once by Reset().
+	// When the current block runs out a new block is chained on, Reset() then merges all blocks into one
+	// so the next frame with the same workload does not touch the general heap.
+	class LinearAllocator
+	{
+	public:
+		LinearAllocator(size_t blockSize, MemoryTag tag);
+		~LinearAllocator();
+
+		LinearAllocator(const LinearAllocator&) = delete;
+		LinearAllocator& operator=(const LinearAllocator&) = delete;
+
+		[[nodiscard]] void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		template<typename T>
+		[[nodiscard]] T* Allocate(size_t count)
+		{
+			return reinterpret_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+		}
+
+		void Reset();
+		void Release();
+
+		inline size_t GetUsed() const { return m_Used; }
+		inline size_t GetPeak() const { return m_Peak; }
+		inline size_t GetCapacity() const { return m_Capacity; }
+
+	private:
+		struct Block
+		{
+			Block* Next;
+			size_t Size;
+			size_t Offset;
+		};
+
+		Block* AllocateBlock(size_t size);
+
+	private:
+		Block* m_Head{ nullptr };
+		Block* m_Current{ nullptr };
+
+		size_t m_BlockSize;
+		size_t m_Used{ 0 };
+		size_t m_Peak{ 0 };
+		size_t m_Capacity{ 0 };
+
+		MemoryTag m_Tag;
+	};
+
+	// Allocator shared by everything that only lives for the current frame on the thread that renders.
+	// The renderer resets it at the end of every frame, with a RenderThread running the main thread must not use it.
+	LinearAllocator& GetFrameAllocator();
+
+	// Lets standard containers allocate from a LinearAllocator, deallocation is a no-op.
+	// There is no default constructor, the allocator is always named so a container cannot end up in the frame allocator by accident.
+	template<typename T>
+	class LinearAllocatorAdapter
+	{
+	public:
+		using value_type = T;
+
+		LinearAllocatorAdapter(LinearAllocator& allocator)
+			: m_Allocator(&allocator)
+		{}
+
+		template<typename U>
+		LinearAllocatorAdapter(const LinearAllocatorAdapter<U>& other)
+			: m_Allocator(other.GetAllocator())
+		{}
+
+		[[nodiscard]] T* allocate(size_t count)
+		{
+			return m_Allocator->Allocate<T>(count);
+		}
+
+		void deallocate(T*, size_t) {}
+
+		inline LinearAllocator* GetAllocator() const { return m_Allocator; }
+
+	private:
+		LinearAllocator* m_Allocator;
+	};
+
+	template<typename T, typename U>
+	bool operator==(const LinearAllocatorAdapter<T>& a, const LinearAllocatorAdapter<U>& b)
+	{
+		return a.GetAllocator() == b.GetAllocator();
+	}
+
+	template<typename T, typename U>
+	bool operator!=(const LinearAllocatorAdapter<T>& a, const LinearAllocatorAdapter<U>& b)
+	{
+		return a.GetAllocator() != b.GetAllocator();
+	}
+
+}
+
+	template<typename T>
+	using FrameVector = std::vector<T, Memory::LinearAllocatorAdapter<T>>;
+
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include "Defines.h"
 
+#include <atomic>
 #include <string>
 
 #define LOG_WARN_ENABLED 1
@@ -27,51 +28,155 @@ namespace Gecko { namespace Logger
         LOG_LEVEL_TRACE = 5
     };
 
-    bool Init();
+    // Every channel has its own runtime level, messages above it are skipped before their arguments are evaluated.
+    // The LOG_* macros log to General, the LOG_CHANNEL_* macros take the channel name.
+    enum class LogChannel : u8
+    {
+        General = 0,
+        Render,
+        Scene,
+        GLTF,
+        DX12,
+        Event,
+        MaxChannels
+    };
+
+    enum class LogMode : u8
+    {
+        // Messages are formatted and written to the console on the calling thread.
+        Immediate = 0,
+        // Messages are formatted into a ring buffer of the calling thread, a sink thread writes them to the console.
+        Async,
+        // Like Async, but messages only store their format ID and raw arguments and the sink writes them to BinaryLogPath.
+        // Errors and fatal messages are still formatted and also written to the console. See Core/BinaryLog.h.
+        Binary
+    };
+
+    // What happens to a message when the ring buffer of its thread is full, fatal messages always block.
+    enum class OverflowPolicy : u8
+    {
+        // The message is dropped and counted, the sink logs how many were dropped.
+        Drop = 0,
+        // The calling thread waits until the sink made room.
+        Block
+    };
+
+    struct LoggerDesc
+    {
+        LogMode Mode{ LogMode::Immediate };
+        OverflowPolicy Overflow{ OverflowPolicy::Drop };
+        // Size of every thread's ring buffer, rounded up to a power of two.
+        u32 ThreadBufferSize{ 64 * 1024 };
+        // All ring buffers are allocated in Init, threads past this count log immediately.
+        u32 MaxThreads{ 16 };
+        const char* BinaryLogPath{ "Gecko.glog" };
+    };
+
+    bool Init(const LoggerDesc& desc = LoggerDesc());
     void Shutdown();
-    void LogOutput(eLogLevel level, std::string message, ...);
+    void LogOutput(eLogLevel level, const char* message, ...);
+
+    // Used by the LOG_* macros, every call site registers its format once and logs with the returned ID.
+    u32 RegisterFormat(eLogLevel level, const char* format, const char* file, u32 line);
+    void LogFormat(u32 formatID, eLogLevel level, const char* message, ...);
+
+    void SetChannelLevel(LogChannel channel, eLogLevel level);
+    eLogLevel GetChannelLevel(LogChannel channel);
+    const char* GetChannelName(LogChannel channel);
+    const char* GetLevelName(eLogLevel level);
+    // Sets channel levels from a string like "GLTF=trace,Render=warn", "*" sets every channel.
+    // Init applies the GECKO_LOG_CHANNELS environment variable this way, so a single machine can log more without a rebuild.
+    bool ConfigureChannels(const char* config);
+
+    namespace Internal
+    {
+        extern std::atomic<u8> ChannelLevels[static_cast<u8>(LogChannel::MaxChannels)];
+    }
+
+    inline bool IsChannelEnabled(LogChannel channel, eLogLevel level)
+    {
+        return static_cast<u8>(level) <= Internal::ChannelLevels[static_cast<u8>(channel)].load(std::memory_order_relaxed);
+    }
+
+    // Blocks until every message logged before the call is written to the console.
+    void Flush();
+    u64 GetDroppedMessageCount();
 
     void ConsoleWrite(char* msg, Logger::eLogLevel level);
 } }
 
+// The channel check is the only thing that runs when the level is filtered out.
+// The format ID is a function local static, so a call site is registered the first time it logs.
+// The message is part of __VA_ARGS__, a call without arguments would otherwise need the non standard ##__VA_ARGS__.
+#define GECKO_LOG_EXPAND(x) x
+#define GECKO_LOG_FORMAT_IMPL(message, ...) message
+#define GECKO_LOG_FORMAT(...) GECKO_LOG_EXPAND(GECKO_LOG_FORMAT_IMPL(__VA_ARGS__, 0))
+
+#define GECKO_LOG_TO_CHANNEL(channel, level, ...) \
+    do \
+    { \
+        if (Gecko::Logger::IsChannelEnabled(channel, level)) \
+        { \
+            static const Gecko::u32 s_GeckoLogFormatID = Gecko::Logger::RegisterFormat(level, GECKO_LOG_FORMAT(__VA_ARGS__), __FILE__, __LINE__); \
+            Gecko::Logger::LogFormat(s_GeckoLogFormatID, level, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define GECKO_LOG(level, ...) GECKO_LOG_TO_CHANNEL(Gecko::Logger::LogChannel::General, level, __VA_ARGS__)
+
 #ifndef LOG_FATAL
-#define LOG_FATAL(message, ...) Gecko::Logger::LogOutput(Gecko::Logger::eLogLevel::LOG_LEVEL_FATAL, message, ##__VA_ARGS__);
+#define LOG_FATAL(...) GECKO_LOG(Gecko::Logger::eLogLevel::LOG_LEVEL_FATAL, __VA_ARGS__);
 #endif
 
 
 #ifndef LOG_ERROR
 // Logs an error-level message.
-#define LOG_ERROR(message, ...) Gecko::Logger::LogOutput(Gecko::Logger::eLogLevel::LOG_LEVEL_ERROR, message, ##__VA_ARGS__);
+#define LOG_ERROR(...) GECKO_LOG(Gecko::Logger::eLogLevel::LOG_LEVEL_ERROR, __VA_ARGS__);
 #endif
 
 #if LOG_WARN_ENABLED == 1
 // Logs a warning-level message.
-#define LOG_WARN(message, ...) Gecko::Logger::LogOutput(Gecko::Logger::eLogLevel::LOG_LEVEL_WARN, message, ##__VA_ARGS__);
+#define LOG_WARN(...) GECKO_LOG(Gecko::Logger::eLogLevel::LOG_LEVEL_WARN, __VA_ARGS__);
 #else
 // Does nothing when LOG_WARN_ENABLED != 1
-#define LOG_WARN(message, ...)
+#define LOG_WARN(...)
 #endif
 
 #if LOG_INFO_ENABLED == 1
 // Logs a info-level message.
-#define LOG_INFO(message, ...) Gecko::Logger::LogOutput(Gecko::Logger::eLogLevel::LOG_LEVEL_INFO, message, ##__VA_ARGS__);
+#define LOG_INFO(...) GECKO_LOG(Gecko::Logger::eLogLevel::LOG_LEVEL_INFO, __VA_ARGS__);
 #else
 // Does nothing when LOG_INFO_ENABLED != 1
-#define LOG_INFO(message, ...)
+#define LOG_INFO(...)
 #endif
 
 #if LOG_DEBUG_ENABLED == 1
 // Logs a debug-level message.
-#define LOG_DEBUG(message, ...) Gecko::Logger::LogOutput(Gecko::Logger::eLogLevel::LOG_LEVEL_DEBUG, message, ##__VA_ARGS__);
+#define LOG_DEBUG(...) GECKO_LOG(Gecko::Logger::eLogLevel::LOG_LEVEL_DEBUG, __VA_ARGS__);
 #else
 // Does nothing when LOG_DEBUG_ENABLED != 1
-#define LOG_DEBUG(message, ...)
+#define LOG_DEBUG(...)
 #endif
 
 #if LOG_TRACE_ENABLED == 1
 // Logs a trace-level message.
-#define LOG_TRACE(message, ...) Gecko::Logger::LogOutput(Gecko::Logger::eLogLevel::LOG_LEVEL_TRACE, message, ##__VA_ARGS__);
+#define LOG_TRACE(...) GECKO_LOG(Gecko::Logger::eLogLevel::LOG_LEVEL_TRACE, __VA_ARGS__);
 #else
 // Does nothing when LOG_TRACE_ENABLED != 1
-#define LOG_TRACE(message, ...)
-#endif
\ No newline at end of file
+#define LOG_TRACE(...)
+#endif
+
+// Channel messages are prefixed with the channel name, so their message has to be a string literal.
+// Debug and trace channel messages are compiled into every build and stay off unless their channel level is raised.
+#define GECKO_LOG_CHANNEL(channel, level, ...) GECKO_LOG_TO_CHANNEL(Gecko::Logger::LogChannel::channel, level, "[" #channel "] " __VA_ARGS__)
+
+// Logs an error-level message to a channel, for example LOG_CHANNEL_ERROR(GLTF, "Failed to load %s", path).
+#define LOG_CHANNEL_ERROR(channel, ...) GECKO_LOG_CHANNEL(channel, Gecko::Logger::eLogLevel::LOG_LEVEL_ERROR, __VA_ARGS__);
+// Logs a warning-level message to a channel.
+#define LOG_CHANNEL_WARN(channel, ...) GECKO_LOG_CHANNEL(channel, Gecko::Logger::eLogLevel::LOG_LEVEL_WARN, __VA_ARGS__);
+// Logs an info-level message to a channel.
+#define LOG_CHANNEL_INFO(channel, ...) GECKO_LOG_CHANNEL(channel, Gecko::Logger::eLogLevel::LOG_LEVEL_INFO, __VA_ARGS__);
+// Logs a debug-level message to a channel.
+#define LOG_CHANNEL_DEBUG(channel, ...) GECKO_LOG_CHANNEL(channel, Gecko::Logger::eLogLevel::LOG_LEVEL_DEBUG, __VA_ARGS__);
+// Logs a trace-level message to a channel.
+#define LOG_CHANNEL_TRACE(channel, ...) GECKO_LOG_CHANNEL(channel, Gecko::Logger::eLogLevel::LOG_LEVEL_TRACE, __VA_ARGS__);
@@ -1,7 +1,64 @@
 #pragma once
 
 #include "Defines.h"
+#include "Core/HeapAllocator.h"
+
+// Memory tracking is compiled out of production builds, every allocation then goes straight to the platform.
+#ifndef GECKO_MEMORY_TRACKING
+#ifdef PRODUCTION_BUILD
+#define GECKO_MEMORY_TRACKING 0
+#else
+#define GECKO_MEMORY_TRACKING 1
+#endif
+#endif
 
 namespace Gecko { namespace Memory {
 
-} }
\ No newline at end of file
+	enum class MemoryTag : u8
+	{
+		General = 0,
+		Scene,
+		ResourceManager,
+		GLTFLoader,
+		Logger,
+		Event,
+		Frame,
+
+		MaxTags
+	};
+
+	struct MemoryTagStats
+	{
+		u64 LiveBytes{ 0 };
+		u64 LiveAllocations{ 0 };
+		u64 TotalAllocations{ 0 };
+		u64 HighWaterMark{ 0 };
+	};
+
+	// Allocations made through these functions are accounted to the given tag.
+	// The global operator new/delete route through them with the tag of the current scope.
+	// Reallocate keeps the alignment the block was allocated with. Alignments must stay below 64 KiB.
+	void* Allocate(size_t size, MemoryTag tag, size_t alignment = HEAP_DEFAULT_ALIGNMENT);
+	void* Reallocate(void* mem, size_t size, MemoryTag tag);
+	void Free(void* mem);
+
+	MemoryTag GetCurrentTag();
+	const char* GetTagName(MemoryTag tag);
+	MemoryTagStats GetTagStats(MemoryTag tag);
+	void LogMemoryUsage();
+
+	// Sets the tag used by operator new on the current thread for the lifetime of this object.
+	class ScopedMemoryTag
+	{
+	public:
+		explicit ScopedMemoryTag(MemoryTag tag);
+		~ScopedMemoryTag();
+
+		ScopedMemoryTag(const ScopedMemoryTag&) = delete;
+		ScopedMemoryTag& operator=(const ScopedMemoryTag&) = delete;
+
+	private:
+		MemoryTag m_PreviousTag;
+	};
+
+} }
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Defines.h"
+
+namespace Gecko { namespace Memory {
+
+	enum class BudgetType : u8
+	{
+		// Everything allocated through Gecko::Memory.
+		CPU = 0,
+		// Textures, meshes and render targets created through the ResourceManager.
+		GPU,
+
+		MaxTypes
+	};
+
+	enum class GPUResourceCategory : u8
+	{
+		Texture = 0,
+		Mesh,
+		RenderTarget,
+
+		MaxCategories
+	};
+
+	enum class MemoryPressure : u8
+	{
+		None = 0,
+		Soft,
+		Hard
+	};
+
+	// A limit of 0 means there is no limit.
+	struct BudgetLimits
+	{
+		u64 SoftLimit{ 0 };
+		u64 HardLimit{ 0 };
+	};
+
+	// Tracks usage against the configured limits and posts Event::CODE_MEMORY_PRESSURE whenever the pressure level
+	// of a budget changes. The event data holds the BudgetType in u32[0], the MemoryPressure in u32[1]
+	// and the usage in bytes in u64[1], the sender is the MemoryBudget.
+	class MemoryBudget
+	{
+	public:
+		MemoryBudget() = default;
+		~MemoryBudget() {};
+
+		void SetLimits(BudgetType type, const BudgetLimits& limits);
+		const BudgetLimits& GetLimits(BudgetType type) const;
+
+		void TrackGPU(GPUResourceCategory category, i64 bytes);
+		void Reset();
+
+		// Re-reads the CPU usage from Gecko::Memory and fires events for every budget whose pressure level changed.
+		void Update();
+
+		u64 GetUsage(BudgetType type) const;
+		u64 GetGPUUsage(GPUResourceCategory category) const;
+		MemoryPressure GetPressure(BudgetType type) const;
+
+		// False when allocating this many bytes would push the budget over its hard limit.
+		bool CanAllocate(BudgetType type, u64 bytes) const;
+
+		static const char* GetBudgetTypeName(BudgetType type);
+		static const char* GetPressureName(MemoryPressure pressure);
+
+	private:
+		static constexpr u32 NUM_BUDGET_TYPES = static_cast<u32>(BudgetType::MaxTypes);
+		static constexpr u32 NUM_GPU_CATEGORIES = static_cast<u32>(GPUResourceCategory::MaxCategories);
+
+		BudgetLimits m_Limits[NUM_BUDGET_TYPES]{};
+		u64 m_Usage[NUM_BUDGET_TYPES]{};
+		MemoryPressure m_Pressure[NUM_BUDGET_TYPES]{};
+		u64 m_GPUUsage[NUM_GPU_CATEGORIES]{};
+	};
+
+} }
@@ -0,0 +1,41 @@
+#pragma once
+#include "Defines.h"
+
+// Pack files bundle many assets into one file that FileSystem::MountPack maps once. Every file inside is a view
+// into that mapping. GeckoPackBuilder creates them from a directory.
+//
+// File layout: PackHeader, PackEntry[NumEntries], the names, then the file data.
+// Names are relative paths with '/' separators. Every file starts at a multiple of PACK_DATA_ALIGNMENT,
+// so the data of a file can be read as floats or ints straight from the view.
+
+namespace Gecko { namespace FileSystem
+{
+
+	constexpr char PACK_MAGIC[8] = { 'G', 'K', 'P', 'A', 'C', 'K', '0', '1' };
+	constexpr u32 PACK_VERSION = 1;
+	constexpr u64 PACK_DATA_ALIGNMENT = 16;
+
+	struct PackHeader
+	{
+		char Magic[8];
+		u32 Version;
+		u32 NumEntries;
+		// Offset and size of the names, from the start of the file.
+		u64 NamesOffset;
+		u64 NamesSize;
+	};
+
+	struct PackEntry
+	{
+		// Offset of the data from the start of the file.
+		u64 Offset;
+		u64 Size;
+		// Offset of the name from NamesOffset.
+		u32 NameOffset;
+		u32 NameLength;
+	};
+
+	STATIC_ASSERT(sizeof(PackHeader) == 32, "PackHeader is written to disk as is.");
+	STATIC_ASSERT(sizeof(PackEntry) == 24, "PackEntry is written to disk as is.");
+
+} }
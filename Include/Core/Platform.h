@@ -1,5 +1,6 @@
 #pragma once
 #include "Defines.h"
+#include "Core/MemoryBudget.h"
 
 
 namespace Gecko { namespace Platform 
@@ -13,6 +14,11 @@ namespace Gecko { namespace Platform
 		i32 X = 0;
 		i32 Y = 0;
 		u32 NumBackBuffers = 2;
+		// Limits the ResourceManager's memory budget starts with, a limit of 0 turns that check off.
+		Memory::BudgetLimits CPUMemoryBudget = { 1536ull << 20, 2048ull << 20 };
+		Memory::BudgetLimits GPUMemoryBudget = { 3072ull << 20, 4096ull << 20 };
+		// Record and present frames on a RenderThread while the main thread prepares the next one.
+		bool UseRenderThread = true;
 
 		std::string Name = "Gecko";
 		std::string WorkingDir = "";
@@ -25,13 +31,82 @@ namespace Gecko { namespace Platform
 	bool PumpMessage();
 	bool IsRunning();
 	float GetScreenAspectRatio();
+	// Seconds since Init, loses sub-millisecond precision after a few hours, use GetTicks for frame timing.
 	float GetTime();
+	// Monotonic nanoseconds since Init, see Core/Time.h for conversions.
+	u64 GetTicks();
+	// Puts the thread to sleep for at least the given number of nanoseconds, the OS decides how much longer.
+	void SleepFor(u64 nanoseconds);
 
-	// TODO: memory tracking
+	// Raw platform allocation, use Gecko::Memory for tracked allocations.
 	void* CustomAllocate(size_t size);
 	void* CustomRealloc(void* mem, size_t size);
 	void CustomFree(void* mem);
+	// Committed pages straight from the OS, aligned to at least 64 KiB.
+	void* AllocatePages(size_t size);
+	void FreePages(void* mem, size_t size);
+	// Pages for large, short-lived blocks, backed by huge pages when the OS has them to spare to cut down on TLB misses.
+	// Falls back to regular pages, the result is aligned to at least 64 KiB either way. Sizes are rounded up to GetHugePageSize.
+	void* AllocateHugePages(size_t size);
+	void FreeHugePages(void* mem, size_t size);
+	size_t GetHugePageSize();
+	// Return addresses of the calling thread, the caller itself is not included.
+	u32 CaptureCallStack(void** frames, u32 maxFrames);
+	std::string GetSymbolName(void* address);
 	std::string GetLocalPath(std::string filePath);
 
+	// Read-only memory mapping of a whole file. Empty files map successfully with a nullptr Data.
+	struct FileMapping
+	{
+		const void* Data{ nullptr };
+		u64 Size{ 0 };
+		void* Handle{ nullptr };
+	};
+	bool MapFile(const std::string& filePath, FileMapping& outMapping);
+	void UnmapFile(FileMapping& mapping);
+
+	// Processor layout as reported by the OS, see Core/Threading.h for placing threads on it.
+	struct LogicalCore
+	{
+		// Number the OS uses for this processor, this is what the affinity functions take.
+		u32 Index{ 0 };
+		// Indices below are numbered from 0 without gaps. Logical cores on the same physical core are SMT siblings.
+		u32 PhysicalCore{ 0 };
+		u32 Package{ 0 };
+		u32 NUMANode{ 0 };
+		// Logical cores that share the last level cache.
+		u32 CacheGroup{ 0 };
+	};
+
+	struct CPUCache
+	{
+		u32 Level{ 0 };
+		u64 Size{ 0 };
+		u32 LineSize{ 0 };
+		// Logical cores sharing one instance of this cache.
+		u32 NumSharingCores{ 1 };
+	};
+
+	struct CPUTopology
+	{
+		u32 NumLogicalCores{ 1 };
+		u32 NumPhysicalCores{ 1 };
+		u32 NumPackages{ 1 };
+		u32 NumNUMANodes{ 1 };
+		u32 NumCacheGroups{ 1 };
+		u32 CacheLineSize{ 64 };
+		// Data and unified caches of the first core, from L1 up.
+		std::vector<CPUCache> Caches;
+		// Only the cores this process may run on, sorted by Index.
+		std::vector<LogicalCore> LogicalCores;
+	};
+
+	// Queried on first use, can be called before Init.
+	const CPUTopology& GetCPUTopology();
+	// Pins the calling thread to the given logical core indices, an empty list lets it run on any core again.
+	bool SetCurrentThreadAffinity(const std::vector<u32>& logicalCores);
+	// Shows up in debuggers and profilers, Linux cuts it off after 15 characters.
+	void SetCurrentThreadName(const std::string& name);
+
 
 } }
\ No newline at end of file
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "Defines.h"
+#include "Core/Memory.h"
+#include "Core/Asserts.h"
+
+#include <algorithm>
+#include <new>
+
+namespace Gecko { namespace Memory {
+
+	// Typed object pool, objects are placed next to each other in chunks of SlotsPerChunk slots.
+	// Destroyed slots go on a free list and are reused before a new chunk is allocated.
+	// Clear() destroys every live object and releases all chunks at once.
+	template<typename T, u32 SlotsPerChunk = 256>
+	class PoolAllocator
+	{
+		STATIC_ASSERT(SlotsPerChunk > 0, "A pool chunk needs at least one slot.");
+
+	public:
+		explicit PoolAllocator(MemoryTag tag)
+			: m_Tag(tag)
+		{}
+
+		~PoolAllocator()
+		{
+			Clear();
+		}
+
+		PoolAllocator(const PoolAllocator&) = delete;
+		PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+		template<typename ... Args>
+		[[nodiscard]] T* Create(Args&& ... args)
+		{
+			Slot* slot = m_FreeList;
+			if (slot != nullptr)
+			{
+				m_FreeList = slot->NextFree;
+			}
+			else
+			{
+				if (m_LastChunk == nullptr || m_NextSlotInChunk == SlotsPerChunk)
+				{
+					AllocateChunk();
+				}
+				slot = &m_LastChunk->Slots[m_NextSlotInChunk++];
+			}
+
+			m_LiveCount++;
+			return new (slot->Storage) T(std::forward<Args>(args)...);
+		}
+
+		void Destroy(T* object)
+		{
+			if (object == nullptr)
+				return;
+
+			ASSERT_MSG(m_LiveCount > 0, "Destroying an object that does not belong to this pool!");
+
+			object->~T();
+
+			Slot* slot = reinterpret_cast<Slot*>(object);
+			slot->NextFree = m_FreeList;
+			m_FreeList = slot;
+			m_LiveCount--;
+		}
+
+		// Calls func on every live object, in the order their slots are laid out in memory.
+		template<typename Func>
+		void ForEach(Func&& func)
+		{
+			if (m_LiveCount == 0)
+				return;
+
+			if (m_FreeList == nullptr)
+			{
+				for (Chunk* chunk = m_FirstChunk; chunk != nullptr; chunk = chunk->Next)
+				{
+					u32 usedSlots = chunk == m_LastChunk ? m_NextSlotInChunk : SlotsPerChunk;
+					for (u32 i = 0; i < usedSlots; i++)
+					{
+						func(reinterpret_cast<T*>(chunk->Slots[i].Storage));
+					}
+				}
+				return;
+			}
+
+			// Slots on the free list have to be skipped, mark them first.
+			std::vector<Chunk*> chunks;
+			chunks.reserve(m_ChunkCount);
+			for (Chunk* chunk = m_FirstChunk; chunk != nullptr; chunk = chunk->Next)
+			{
+				chunks.push_back(chunk);
+			}
+			std::sort(chunks.begin(), chunks.end());
+
+			std::vector<bool> isFree(static_cast<size_t>(m_ChunkCount) * SlotsPerChunk, false);
+			for (Slot* slot = m_FreeList; slot != nullptr; slot = slot->NextFree)
+			{
+				typename std::vector<Chunk*>::iterator it = std::upper_bound(chunks.begin(), chunks.end(), reinterpret_cast<Chunk*>(slot)) - 1;
+				size_t chunkIndex = static_cast<size_t>(it - chunks.begin());
+				size_t slotIndex = static_cast<size_t>(slot - (*it)->Slots);
+				isFree[chunkIndex * SlotsPerChunk + slotIndex] = true;
+			}
+
+			for (size_t chunkIndex = 0; chunkIndex < chunks.size(); chunkIndex++)
+			{
+				Chunk* chunk = chunks[chunkIndex];
+				u32 usedSlots = chunk == m_LastChunk ? m_NextSlotInChunk : SlotsPerChunk;
+				for (u32 i = 0; i < usedSlots; i++)
+				{
+					if (!isFree[chunkIndex * SlotsPerChunk + i])
+					{
+						func(reinterpret_cast<T*>(chunk->Slots[i].Storage));
+					}
+				}
+			}
+		}
+
+		void Clear()
+		{
+			ForEach([](T* object) { object->~T(); });
+
+			Chunk* chunk = m_FirstChunk;
+			while (chunk != nullptr)
+			{
+				Chunk* next = chunk->Next;
+				Memory::Free(chunk);
+				chunk = next;
+			}
+
+			m_FirstChunk = nullptr;
+			m_LastChunk = nullptr;
+			m_FreeList = nullptr;
+			m_NextSlotInChunk = 0;
+			m_ChunkCount = 0;
+			m_LiveCount = 0;
+		}
+
+		inline u32 GetLiveCount() const { return m_LiveCount; }
+		inline u32 GetCapacity() const { return m_ChunkCount * SlotsPerChunk; }
+
+	private:
+		union Slot
+		{
+			Slot* NextFree;
+			alignas(T) u8 Storage[sizeof(T)];
+		};
+
+		struct Chunk
+		{
+			Chunk* Next;
+			Slot Slots[SlotsPerChunk];
+		};
+
+		void AllocateChunk()
+		{
+			Chunk* chunk = reinterpret_cast<Chunk*>(Memory::Allocate(sizeof(Chunk), m_Tag, alignof(Chunk)));
+			ASSERT_MSG(chunk != nullptr, "PoolAllocator is out of memory!");
+			chunk->Next = nullptr;
+
+			if (m_LastChunk == nullptr)
+			{
+				m_FirstChunk = chunk;
+			}
+			else
+			{
+				m_LastChunk->Next = chunk;
+			}
+			m_LastChunk = chunk;
+			m_NextSlotInChunk = 0;
+			m_ChunkCount++;
+		}
+
+	private:
+		Chunk* m_FirstChunk{ nullptr };
+		Chunk* m_LastChunk{ nullptr };
+		Slot* m_FreeList{ nullptr };
+
+		u32 m_NextSlotInChunk{ 0 };
+		u32 m_ChunkCount{ 0 };
+		u32 m_LiveCount{ 0 };
+
+		MemoryTag m_Tag;
+	};
+
+} }
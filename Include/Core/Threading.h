@@ -0,0 +1,37 @@
+#pragma once
+#include "Defines.h"
+
+// Places the engine's threads on the cores Platform::GetCPUTopology reports. Every thread registers itself with its role,
+// which names it and pins it to the cores of that role. Until cores are assigned to a role its threads run wherever the OS puts them.
+
+namespace Gecko { namespace Threading
+{
+
+	enum class ThreadRole : u8
+	{
+		Main = 0,
+		Render,
+		Worker,
+		IO,
+
+		MaxRoles
+	};
+
+	const char* GetRoleName(ThreadRole role);
+
+	// Takes logical core indices, see Platform::LogicalCore::Index. Threads that already registered keep their old cores.
+	void SetRoleCores(ThreadRole role, const std::vector<u32>& logicalCores);
+	std::vector<u32> GetRoleCores(ThreadRole role);
+
+	// Keeps every role on the NUMA node of the first core so threads do not share data across sockets:
+	// main and render get a physical core each, IO threads their SMT siblings, workers one logical core on each remaining physical core.
+	void UseDefaultLayout();
+
+	// Names the calling thread after its role and index and pins it. Workers and IO threads get a single core of their role,
+	// chosen round robin by index, main and render threads may use all cores of their role.
+	void RegisterCurrentThread(ThreadRole role, u32 index = 0);
+
+	// One worker per core assigned to workers, or per physical core when they have none.
+	u32 GetWorkerCount();
+
+} }
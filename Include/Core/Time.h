@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Defines.h"
+
+namespace Gecko { namespace Time {
+
+	// Ticks are the nanoseconds returned by Platform::GetTicks. A u64 holds centuries of them and an f64 represents
+	// them exactly for over a hundred days, so deltas keep their precision no matter how long the application runs.
+	constexpr u64 TICKS_PER_SECOND = 1000000000ull;
+	constexpr u64 TICKS_PER_MILLISECOND = 1000000ull;
+	constexpr u64 TICKS_PER_MICROSECOND = 1000ull;
+
+	constexpr f64 ToSeconds(u64 ticks)
+	{
+		return static_cast<f64>(ticks) / static_cast<f64>(TICKS_PER_SECOND);
+	}
+
+	constexpr f64 ToMilliseconds(u64 ticks)
+	{
+		return static_cast<f64>(ticks) / static_cast<f64>(TICKS_PER_MILLISECOND);
+	}
+
+	constexpr f64 ToMicroseconds(u64 ticks)
+	{
+		return static_cast<f64>(ticks) / static_cast<f64>(TICKS_PER_MICROSECOND);
+	}
+
+	// Negative durations become 0.
+	constexpr u64 FromSeconds(f64 seconds)
+	{
+		return seconds > 0. ? static_cast<u64>(seconds * static_cast<f64>(TICKS_PER_SECOND) + .5) : 0;
+	}
+
+	constexpr u64 FromMilliseconds(f64 milliseconds)
+	{
+		return milliseconds > 0. ? static_cast<u64>(milliseconds * static_cast<f64>(TICKS_PER_MILLISECOND) + .5) : 0;
+	}
+
+	constexpr u64 FromMicroseconds(f64 microseconds)
+	{
+		return microseconds > 0. ? static_cast<u64>(microseconds * static_cast<f64>(TICKS_PER_MICROSECOND) + .5) : 0;
+	}
+
+	// Frame interval for a refresh rate, 0 Hz means the frame rate is not limited.
+	constexpr u64 FromFrequency(f64 hertz)
+	{
+		return hertz > 0. ? static_cast<u64>(static_cast<f64>(TICKS_PER_SECOND) / hertz + .5) : 0;
+	}
+
+} }
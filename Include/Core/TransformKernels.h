@@ -0,0 +1,62 @@
+#pragma once
+#include "Defines.h"
+
+// Transform math over arrays, written with SIMD intrinsics for the instruction set the engine is compiled for: AVX2,
+// SSE4.1, NEON on 64 bit ARM, or plain scalar code on anything else. Matrices are glm::mat4, column major, so glm
+// arrays are passed in directly. Results match glm up to float rounding.
+
+namespace Gecko { namespace Math
+{
+
+	constexpr u32 NO_PARENT_MATRIX = 0xFFFFFFFF;
+
+	// Transforms with one array per component, consecutive transforms fill the SIMD lanes.
+	struct TRSArrays
+	{
+		const f32* Position[3]{ nullptr, nullptr, nullptr };
+		// Euler angles in degrees, turned into a rotation like NodeTransform::GetMat4 does.
+		const f32* Rotation[3]{ nullptr, nullptr, nullptr };
+		const f32* Scale[3]{ nullptr, nullptr, nullptr };
+	};
+
+	// Boxes with one array per component, as center and half size in the space of their transform.
+	struct BoxArrays
+	{
+		const f32* Center[3]{ nullptr, nullptr, nullptr };
+		const f32* Extents[3]{ nullptr, nullptr, nullptr };
+	};
+
+	// Planes as (normal, distance), a point p is on the inside of a plane when dot(normal, p) + distance >= 0.
+	struct Frustum
+	{
+		glm::vec4 Planes[6];
+	};
+
+	// "AVX2", "SSE4.1", "NEON" or "Scalar".
+	const char* GetKernelInstructionSet();
+
+	// out[i] = translate(Position) * toMat4(quat(radians(Rotation))) * scale(Scale)
+	void ComposeTRS(const TRSArrays& transforms, glm::mat4* out, u32 count);
+
+	// out[i] = a[i] * b[i], out may be a or b.
+	void MultiplyMatrices(const glm::mat4* a, const glm::mat4* b, glm::mat4* out, u32 count);
+
+	// world[index] = world[parents[index]] * local[index] for every index in indices, in order. The indices have to list
+	// a parent before its children, like a hierarchy in depth first order. An index without a parent (NO_PARENT_MATRIX)
+	// copies its local matrix.
+	void MultiplyByParents(const u32* indices, u32 count, const u32* parents, const glm::mat4* local, glm::mat4* world);
+
+	// Inverse of matrices with (0, 0, 0, 1) as the last row, like view and model matrices, out may be in.
+	// Cheaper than glm::inverse, which handles any matrix.
+	void InvertAffine(const glm::mat4* in, glm::mat4* out, u32 count);
+
+	// The left, right, bottom, top, near and far planes of a view projection matrix, in world space. The near plane is
+	// the one of a -1 to 1 depth range, with a 0 to 1 projection it keeps a little more than it has to, never less.
+	Frustum ExtractFrustum(const glm::mat4& viewProjection);
+
+	// Writes the indices of the boxes that are at least partly inside the frustum to visible, in order, and returns how
+	// many there are. Box i is moved by transforms[i] first and tested as the axis aligned box around it, so a box just
+	// outside a corner of the frustum can pass. visible needs room for count indices.
+	u32 CullBoxes(const Frustum& frustum, const BoxArrays& boxes, const glm::mat4* transforms, u32 count, u32* visible);
+
+} }
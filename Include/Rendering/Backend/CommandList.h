@@ -21,8 +21,8 @@ namespace Gecko {
 		virtual void CopyFromTexture(Texture src, RenderTarget dst, RenderTargetType dstType) = 0;
 
 		virtual void BindRenderTarget(RenderTarget renderTarget) = 0;
-		virtual void BindVertexBuffer(VertexBuffer vertexBuffer) = 0;
-		virtual void BindIndexBuffer(IndexBuffer indexBuffer) = 0;
+		virtual void BindVertexBuffer(const VertexBuffer& vertexBuffer) = 0;
+		virtual void BindIndexBuffer(const IndexBuffer& indexBuffer) = 0;
 		virtual void BindTexture(u32 slot, Texture texture) = 0;
 		virtual void BindTexture(u32 slot, Texture texture, u32 mipLevel) = 0;
 		virtual void BindTexture(u32 slot, RenderTarget renderTarget, RenderTargetType type) = 0;
@@ -30,13 +30,13 @@ namespace Gecko {
 		virtual void BindAsRWTexture(u32 slot, Texture texture, u32 mipLevel) = 0;
 		virtual void BindAsRWTexture(u32 slot, RenderTarget renderTarget, RenderTargetType type) = 0;
 
-		virtual void BindGraphicsPipeline(GraphicsPipeline Pipeline) = 0;
-		virtual void BindComputePipeline(ComputePipeline Pipeline) = 0;
-		virtual void BindRaytracingPipeline(RaytracingPipeline Pipeline) = 0;
+		virtual void BindGraphicsPipeline(const GraphicsPipeline& Pipeline) = 0;
+		virtual void BindComputePipeline(const ComputePipeline& Pipeline) = 0;
+		virtual void BindRaytracingPipeline(const RaytracingPipeline& Pipeline) = 0;
 
 		virtual void BindConstantBuffer(u32 slot, ConstantBuffer Buffer) = 0;
 
-		virtual void BindTLAS(TLAS tlas) = 0;
+		virtual void BindTLAS(const TLAS& tlas) = 0;
 
 		virtual void SetDynamicCallData(u32 size, void* data) = 0;
 
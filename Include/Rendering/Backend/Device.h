@@ -3,19 +3,25 @@
 
 #include "Rendering/Backend/Objects.h"
 
+struct ImDrawData;
+
 namespace Gecko {
 	
 	enum class RenderAPI
 	{
 		None = 0,
+		// Headless device without a GPU, see Rendering/Null/Device_Null.h.
+		Null,
 #ifdef WIN32
 		DX12,
 #endif
 	};
 
 	static constexpr RenderAPI s_RenderAPI =
-#ifdef WIN32
+#if defined(WIN32) && !defined(GECKO_HEADLESS)
 		RenderAPI::DX12;
+#else
+		RenderAPI::Null;
 #endif
 
 	class CommandList;
@@ -56,7 +62,11 @@ namespace Gecko {
 
 		virtual void DrawTextureInImGui(Texture texture, u32 width = 0, u32 height = 0) = 0;
 		virtual void DrawRenderTargetInImGui(RenderTarget renderTarget, u32 width = 0, u32 height = 0, RenderTargetType type = RenderTargetType::Target0) = 0;
-		virtual void ImGuiRender(Ref<CommandList> commandList) = 0;
+		// ImGuiNewFrame and ImGuiEndFrame bracket the UI on the thread that builds it, the draw data of the ended frame stays
+		// valid until the next ImGuiNewFrame. ImGuiRender only reads the draw data it is given and can run on another thread.
+		virtual void ImGuiEndFrame() = 0;
+		virtual void ImGuiNewFrame() = 0;
+		virtual void ImGuiRender(Ref<CommandList> commandList, ImDrawData* drawData) = 0;
 
 		virtual bool Destroy() = 0;
 
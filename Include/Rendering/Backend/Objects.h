@@ -188,7 +188,7 @@ namespace Gecko {
 	{
 		VertexAttribute() = default;
 
-		VertexAttribute(Format format, const char* name)
+		VertexAttribute(Gecko::Format format, const char* name)
 			: Name(name)
 			, Format(format)
 			, Size(FormatSizeInBytes(format))
@@ -196,7 +196,7 @@ namespace Gecko {
 		{}
 
 		const char* Name;
-		Format Format;
+		Gecko::Format Format;
 		u32 Size;
 		u32 Offset;
 
@@ -266,7 +266,7 @@ namespace Gecko {
 
 	struct TextureDesc
 	{
-		Format Format{ Format::None };
+		Gecko::Format Format{ Gecko::Format::None };
 		u32 Width{ 1 };
 		u32 Height{ 1 };
 		u32 Depth{ 1 };
@@ -275,6 +275,10 @@ namespace Gecko {
 		TextureType Type;
 	};
 
+	// Estimated size of the resource in GPU memory, without any padding the API might add.
+	u64 CalculateTextureSizeInBytes(const TextureDesc& textureDesc);
+	u64 CalculateRenderTargetSizeInBytes(const RenderTargetDesc& renderTargetDesc);
+
 	struct Texture
 	{
 		TextureDesc Desc;
@@ -335,18 +339,18 @@ namespace Gecko {
 			*/
 		const char* ShaderVersion{ "" };
 
-		VertexLayout VertexLayout;
+		Gecko::VertexLayout VertexLayout;
 
 		Format RenderTargetFormats[8]{ Format::None };
 		Format DepthStencilFormat{ Format::None };
 
-		CullMode CullMode{ CullMode::None };
-		WindingOrder WindingOrder{ WindingOrder::ClockWise };
-		PrimitiveType PrimitiveType{ PrimitiveType::Triangles };
+		Gecko::CullMode CullMode{ Gecko::CullMode::None };
+		Gecko::WindingOrder WindingOrder{ Gecko::WindingOrder::ClockWise };
+		Gecko::PrimitiveType PrimitiveType{ Gecko::PrimitiveType::Triangles };
 		
 		std::vector<ShaderVisibility> ConstantBufferVisibilities;
 
-		DynamicCallData DynamicCallData;
+		Gecko::DynamicCallData DynamicCallData;
 
 		std::vector<ShaderVisibility> TextureShaderVisibilities;
 
@@ -381,7 +385,7 @@ namespace Gecko {
 		const char* EntryPoint{ "main" };
 		
 		u32 NumConstantBuffers{ 0 };
-		DynamicCallData DynamicCallData;
+		Gecko::DynamicCallData DynamicCallData;
 		u32 NumTextures{ 0 };
 		u32 NumUAVs{ 0 };
 		std::vector<SamplerDesc> SamplerDescs;
@@ -404,7 +408,7 @@ namespace Gecko {
 		const char* RaytraceShaderPath{ nullptr };
 
 		u32 NumConstantBuffers{ 0 };
-		DynamicCallData DynamicCallData;
+		Gecko::DynamicCallData DynamicCallData;
 		u32 NumTextures{ 0 };
 		u32 NumUAVs{ 0 };
 
@@ -419,8 +423,8 @@ namespace Gecko {
 
 	struct BLASDesc
 	{
-		VertexBuffer VertexBuffer;
-		IndexBuffer IndexBuffer;
+		Gecko::VertexBuffer VertexBuffer;
+		Gecko::IndexBuffer IndexBuffer;
 	};
 
 	struct BLAS
@@ -433,7 +437,7 @@ namespace Gecko {
 
 	struct BLASInstanceData
 	{
-		BLAS BLAS;
+		Gecko::BLAS BLAS;
 		glm::mat4 Transform;
 	};
 
@@ -3,6 +3,7 @@
 #include "Defines.h"
 
 #include "Rendering/Frontend/Renderer/Renderer.h"
+#include "Rendering/Frontend/Renderer/RenderThread.h"
 #include "Rendering/Frontend/ResourceManager/ResourceManager.h"
 #include "Rendering/Frontend/Scene/SceneManager.h"
 #include "Core/Platform.h"
@@ -25,6 +26,8 @@ public:
 
 	ResourceManager* GetResourceManager() { return &m_ResourceManager; }
 	Renderer* GetRenderer() { return &m_Renderer; }
+	// Not started by Init, frames are rendered on the calling thread until RenderThread::Start.
+	RenderThread* GetRenderThread() { return &m_RenderThread; }
 	SceneManager* GetSceneManager() { return &m_SceneManager; }
 
 private:
@@ -33,6 +36,7 @@ private:
 
 	ResourceManager m_ResourceManager;
 	Renderer m_Renderer;
+	RenderThread m_RenderThread;
 	SceneManager m_SceneManager;
 
 };
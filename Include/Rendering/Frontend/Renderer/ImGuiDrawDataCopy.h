@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Defines.h"
+
+#include <imgui.h>
+
+namespace Gecko
+{
+
+	// A copy of ImGui's draw data that stays valid after ImGui::NewFrame, so the UI can be drawn on another thread
+	// while the next frame is built. The draw lists are owned by the copy and reused, copying the next frame
+	// only allocates when the UI grew.
+	class ImGuiDrawDataCopy
+	{
+	public:
+		ImGuiDrawDataCopy() = default;
+		~ImGuiDrawDataCopy();
+
+		ImGuiDrawDataCopy(const ImGuiDrawDataCopy&) = delete;
+		ImGuiDrawDataCopy& operator=(const ImGuiDrawDataCopy&) = delete;
+
+		void Copy(const ImDrawData& drawData);
+		void Clear();
+
+		// Null until valid draw data was copied.
+		ImDrawData* Get();
+
+	private:
+		ImDrawData m_DrawData;
+		ImVector<ImDrawList*> m_DrawLists;
+	};
+
+}
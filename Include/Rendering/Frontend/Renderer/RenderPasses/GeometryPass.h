@@ -15,8 +15,8 @@ public:
 	GeometryPass() = default;
 	virtual ~GeometryPass() {}
 
-	virtual const void Init(Platform::AppInfo& appInfo, ResourceManager* resourceManager) override;
-	virtual const void Render(const SceneRenderInfo& sceneRenderInfo, ResourceManager* resourceManager, Ref<CommandList> commandList) override;
+	virtual void Init(Platform::AppInfo& appInfo, ResourceManager* resourceManager) override;
+	virtual void Render(const SceneRenderInfo& sceneRenderInfo, ResourceManager* resourceManager, Ref<CommandList> commandList) override;
 
 
 protected:
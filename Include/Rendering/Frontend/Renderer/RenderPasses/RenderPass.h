@@ -12,6 +12,7 @@
 #include "Rendering/Frontend/Scene/SceneRenderInfo.h"
 
 #include "Core/Platform.h"
+#include "Core/LinearAllocator.h"
 
 namespace Gecko
 {
@@ -25,10 +26,16 @@ public:
 	RenderPass() = default;
 	virtual ~RenderPass() {}
 
-	virtual const void Init(Platform::AppInfo& appInfo, ResourceManager* resourceManager) = 0;
-	virtual const void Render(const SceneRenderInfo& sceneRenderInfo,ResourceManager* resourceManager, Ref<CommandList> commandList) = 0;
+	virtual void Init(Platform::AppInfo& appInfo, ResourceManager* resourceManager) = 0;
+	virtual void Render(const SceneRenderInfo& sceneRenderInfo,ResourceManager* resourceManager, Ref<CommandList> commandList) = 0;
 
 protected:
+	// Scratch memory for temporaries of a single Render call, it is released when the frame ends.
+	template<typename T>
+	[[nodiscard]] T* AllocateFrameScratch(size_t count)
+	{
+		return Memory::GetFrameAllocator().Allocate<T>(count);
+	}
 
 private:
 	
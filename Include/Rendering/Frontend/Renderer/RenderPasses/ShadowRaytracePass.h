@@ -13,8 +13,8 @@ namespace Gecko
 		ShadowRaytracePass() = default;
 		virtual ~ShadowRaytracePass() {}
 
-		virtual const void Init(Platform::AppInfo& appInfo, ResourceManager* resourceManager) override;
-		virtual const void Render(const SceneRenderInfo& sceneRenderInfo, ResourceManager* resourceManager, Ref<CommandList> commandList) override;
+		virtual void Init(Platform::AppInfo& appInfo, ResourceManager* resourceManager) override;
+		virtual void Render(const SceneRenderInfo& sceneRenderInfo, ResourceManager* resourceManager, Ref<CommandList> commandList) override;
 
 
 	protected:
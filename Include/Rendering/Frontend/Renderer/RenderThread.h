@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Defines.h"
+
+#include "Core/Event.h"
+#include "Core/LinearAllocator.h"
+#include "Rendering/Frontend/Renderer/ImGuiDrawDataCopy.h"
+#include "Rendering/Frontend/ResourceManager/ResourceObjects.h"
+#include "Rendering/Frontend/Scene/SceneRenderInfo.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace Gecko
+{
+
+	class Renderer;
+	class Scene;
+
+	// Everything the render thread needs from the main thread for one frame. The main thread fills it, after
+	// SubmitFrame it is only read by the render thread until the frame was presented.
+	struct FrameSnapshot
+	{
+		FrameSnapshot();
+
+		// Extracts the scene into the snapshot's own allocator, the frame allocator belongs to the render thread.
+		// Copies the draw data of the last ended ImGui frame, so the next UI can be built while this one is drawn.
+		void Capture(const Scene& scene, Renderer& renderer);
+
+		Memory::LinearAllocator Allocator;
+		std::optional<SceneRenderInfo> RenderInfo;
+		SceneDataStruct SceneData;
+		ImGuiDrawDataCopy UIDrawData;
+		u64 FrameIndex{ 0 };
+	};
+
+	// All times are in ticks, for the last frame.
+	struct RenderThreadStats
+	{
+		u64 NumFrames{ 0 };
+		// The main thread waiting in BeginFrame for the render thread to free a snapshot.
+		u64 MainThreadWait{ 0 };
+		// The render thread waiting for the main thread to submit a frame.
+		u64 RenderThreadWait{ 0 };
+		// From SubmitFrame until the frame was presented.
+		u64 FrameLatency{ 0 };
+	};
+
+	// Runs Renderer::RecordFrame and SubmitFrame on a thread of its own, so the main thread can update and extract
+	// frame N + 1 while frame N is recorded and presented. There are two snapshots: the main thread is at most one frame
+	// ahead, BeginFrame for frame N + 1 waits until frame N - 1 was presented.
+	//
+	// While it runs, the render thread owns the frame allocator. ImGui stays on the main thread, the render thread only
+	// draws the copy of the draw data in the snapshot.
+	class RenderThread : public Event::EventListener<RenderThread>
+	{
+	public:
+		RenderThread() = default;
+		~RenderThread();
+
+		RenderThread(const RenderThread&) = delete;
+		RenderThread& operator=(const RenderThread&) = delete;
+
+		// Call before the device is created, the resize listener has to run before the swap chain is resized.
+		void Init(Renderer* renderer);
+		void Shutdown();
+
+		void Start();
+		// Renders the frames that were already submitted, then joins the thread.
+		void Stop();
+		bool IsRunning() const;
+
+		[[nodiscard]] FrameSnapshot& BeginFrame();
+		void SubmitFrame();
+
+		// Returns once every submitted frame was presented.
+		void WaitIdle();
+
+		RenderThreadStats GetStats() const;
+
+	private:
+		void ThreadMain();
+		bool OnResize(const Event::EventData& data);
+
+	private:
+		Renderer* m_Renderer{ nullptr };
+		FrameSnapshot m_Snapshots[2];
+		u64 m_SubmitTicks[2]{ 0, 0 };
+
+		std::thread m_Thread;
+		mutable std::mutex m_Mutex;
+		std::condition_variable m_Condition;
+
+		// Frames handed over by SubmitFrame and presented.
+		u64 m_SubmittedFrames{ 0 };
+		u64 m_PresentedFrames{ 0 };
+		bool m_Running{ false };
+		bool m_Stop{ false };
+
+		RenderThreadStats m_Stats;
+	};
+
+}
@@ -8,6 +8,7 @@
 
 #include "Core/Platform.h"
 
+struct ImDrawData;
 
 namespace Gecko {
 
@@ -35,11 +36,28 @@ public:
 	void ConfigureRenderPasses(std::vector<Ref<RenderPass>> renderPassStack)
 	{
 		m_RenderPassStack = renderPassStack;
+		m_OutputTargetHandle = m_ResourceManager->GetRenderTargetHandle("ToneMappingGammaCorrection");
 	}
 
-	void RenderScene(const SceneRenderInfo& sceneRenderInfo);
+	void RenderScene(SceneRenderInfo& sceneRenderInfo);
 	void Present();
 
+	// The UI is built between these two on the main thread, RenderScene draws the last ended frame.
+	void BeginImGuiFrame();
+	void EndImGuiFrame();
+
+	// RenderScene in steps, so a frame can be prepared on the main thread and rendered on the render thread.
+	// Updates the scene constants from the camera and lights, the light direction carries over between frames.
+	const SceneDataStruct& PrepareSceneData(const SceneRenderInfo& sceneRenderInfo);
+	// Fills the visible render objects of the render info, every object without a camera or without mesh bounds.
+	void CullScene(SceneRenderInfo& sceneRenderInfo, const SceneDataStruct& sceneData);
+	// Records the render passes and copies the result to the back buffer.
+	Ref<CommandList> RecordFrame(const SceneRenderInfo& sceneRenderInfo, const SceneDataStruct& sceneData);
+	// Draws the UI on top, the draw data is ImGui's own or a copy of it. Null draws nothing.
+	void RecordImGui(Ref<CommandList> commandList, ImDrawData* drawData);
+	// Submits and presents the frame, then resets the frame allocator.
+	void SubmitFrame(Ref<CommandList> commandList);
+
 private:
 	Device* device;
 
@@ -51,6 +69,9 @@ private:
 	GraphicsPipelineHandle FullScreenTexturePipelineHandle;
 
 	MeshHandle quadMeshHandle{ 0 };
+	RenderTargetHandle m_OutputTargetHandle{ 0 };
+
+	SceneDataStruct m_SceneData;
 
 	Platform::AppInfo m_Info;
 };
@@ -5,6 +5,7 @@
 #include "Rendering/Backend/Device.h"
 #include "Core/Platform.h"
 #include "Core/Event.h"
+#include "Core/MemoryBudget.h"
 
 #include <unordered_map>
 
@@ -22,7 +23,7 @@ public:
 	void Init(Device* device);
 	void Shutdown();
 
-	MeshHandle CreateMesh(VertexBufferDesc vertexDesc, IndexBufferDesc indexDesc, bool CreateBLAS);
+	MeshHandle CreateMesh(VertexBufferDesc vertexDesc, IndexBufferDesc indexDesc, bool CreateBLAS, const BoundingBox* bounds = nullptr);
 	TextureHandle CreateTexture(TextureDesc textureDesc, void* imageData = nullptr, bool mipMap = false);
 	MaterialHandle CreateMaterial();
 	RenderTargetHandle CreateRenderTarget(RenderTargetDesc renderTargetDesc, std::string name, bool KeepWindowAspectRatio);
@@ -48,11 +49,16 @@ public:
 
 	u32 GetCurrentBackBufferIndex() { return m_Device->GetCurrentBackBufferIndex(); }
 
+	// Textures, meshes and render targets are accounted to the GPU budget when they are created.
+	Memory::MemoryBudget& GetMemoryBudget() { return m_MemoryBudget; }
+
 	// TEMP
 	std::vector<ConstantBuffer> SceneDataBuffer;
 	std::vector<SceneDataStruct*> SceneData;
 
 	bool ResizeEvent(const Event::EventData& eventData);
+	// Under GPU memory pressure new mip mapped textures only get their top level.
+	bool MemoryPressureEvent(const Event::EventData& eventData);
 
 private:
 	void MipMapTexture(Texture texture);
@@ -90,6 +96,9 @@ private:
 
 	std::unordered_map<std::string, RenderTargetHandle> m_RenderTargateHandles;
 
+	Memory::MemoryBudget m_MemoryBudget;
+	bool m_SkipTextureMips{ false };
+
 };
 
 }
\ No newline at end of file
@@ -16,12 +16,22 @@ namespace Gecko
 	using ComputePipelineHandle = u32;
 	using RaytracingPipelineHandle = u32;
 
+	// Axis aligned box in the space of the vertices, as center and half size.
+	struct BoundingBox
+	{
+		glm::vec3 Center{ 0.f };
+		glm::vec3 Extents{ 0.f };
+	};
+
 	struct Mesh
 	{
-		VertexBuffer VertexBuffer;
-		IndexBuffer IndexBuffer;
+		Gecko::VertexBuffer VertexBuffer;
+		Gecko::IndexBuffer IndexBuffer;
+		// Meshes without bounds are never culled.
+		bool HasBounds{ false };
+		BoundingBox Bounds;
 		bool HasBLAS{ false };
-		BLAS BLAS;
+		Gecko::BLAS BLAS;
 	};
 
 	enum class MaterialTextureFlags : u32
@@ -101,7 +111,7 @@ namespace Gecko
 
 	struct RenderTargetResource
 	{
-		RenderTarget RenderTarget;
+		Gecko::RenderTarget RenderTarget;
 		bool KeepWindowAspectRatio{ false };
 		f32 WidthScale{ 1.f };
 	};
@@ -5,7 +5,10 @@
 #include "Rendering/Frontend/Scene/SceneObjects/SceneCamera.h"
 #include "Rendering/Frontend/Scene/SceneObjects/SceneLight.h"
 #include "Rendering/Frontend/Scene/SceneObjects/SceneRenderObject.h"
+#include "Rendering/Frontend/Scene/SceneHierarchy.h"
 #include "Core/Event.h"
+#include "Core/LinearAllocator.h"
+#include "Core/PoolAllocator.h"
 
 namespace Gecko {
 
@@ -22,13 +25,18 @@ namespace Gecko {
 		glm::vec3 Rotation{ 0.f };
 		glm::vec3 Scale{ 1.f };
 
+		// translate * rotate * scale, written out instead of multiplying three matrices. Many transforms at once go
+		// through Math::ComposeTRS.
 		inline glm::mat4 GetMat4() const
 		{
-			glm::mat4 nodeTranslationMatrix = glm::translate(glm::mat4(1.), Position);
-			glm::mat4 nodeRotationMatrix = glm::toMat4(glm::quat(glm::radians(Rotation)));
-			glm::mat4 nodeScaleMatrix = glm::scale(glm::mat4(1.), Scale);
-
-			return nodeTranslationMatrix * nodeRotationMatrix * nodeScaleMatrix;
+			glm::mat3 rotationMatrix = glm::toMat3(glm::quat(glm::radians(Rotation)));
+
+			return glm::mat4(
+				glm::vec4(rotationMatrix[0] * Scale.x, 0.f),
+				glm::vec4(rotationMatrix[1] * Scale.y, 0.f),
+				glm::vec4(rotationMatrix[2] * Scale.z, 0.f),
+				glm::vec4(Position, 1.f)
+			);
 		}
 	};
 
@@ -40,8 +48,9 @@ namespace Gecko {
 	{
 	public:
 		friend class Scene;
+		friend class SceneHierarchy;
 
-		SceneNode() = default;
+		explicit SceneNode(Scene* scene) : m_Scene(scene) {};
 		~SceneNode() {};
 
 		[[nodiscard]] SceneNode* AddNode(const std::string& name);
@@ -54,23 +63,37 @@ namespace Gecko {
 		u32 GetChildrenCount();
 		SceneNode* GetChild(u32 nodeIndex);
 
-		const void SetName(const std::string& name);
+		void SetName(const std::string& name);
 		const std::string& GetName();
 
-	public:
-		NodeTransform Transform;
+		const NodeTransform& GetTransform() const { return m_Transform; }
+		void SetTransform(const NodeTransform& transform);
+		// Marks the node as moved and returns its transform to change in place. Do not hold on to the reference,
+		// changes made after the next scene render info was built are not picked up.
+		[[nodiscard]] NodeTransform& EditTransform();
+		// Cached, only recomputed after the transform was changed.
+		const glm::mat4& GetLocalMatrix() const;
 
 	private:
-		const void PopulateSceneRenderInfo(SceneRenderInfo& sceneRenderInfo, glm::mat4 transform) const;
+		// Adds what is attached to this node, the children are added by the scene through its flattened hierarchy.
+		void PopulateSceneRenderInfo(SceneRenderInfo& sceneRenderInfo, const glm::mat4& worldMatrix) const;
 
 	private:
-		std::vector<Scope<SceneNode>> m_Children;
+		// Nodes are owned by the node pool of the scene they were created in.
+		Scene* m_Scene;
+		std::vector<SceneNode*> m_Children;
 
 		std::vector<Scene*> m_Scenes;
 		std::vector<SceneRenderObject*> m_SceneRenderObjects;
 		std::vector<SceneLight*> m_Lights;
 		SceneCamera* m_Camera{ nullptr };
 
+		NodeTransform m_Transform;
+		// Bumped on every change of the transform, the hierarchy compares it to notice moved nodes.
+		u32 m_TransformVersion{ 1 };
+		mutable glm::mat4 m_LocalMatrix{ 1.f };
+		mutable u32 m_LocalMatrixVersion{ 0 };
+
 		std::string m_Name{ "Node" };
 	};
 
@@ -79,6 +102,7 @@ namespace Gecko {
 	public:
 		friend class SceneNode;
 		friend class SceneManager;
+		friend class SceneHierarchy;
 
 		Scene() = default;
 		~Scene() {};
@@ -94,29 +118,47 @@ namespace Gecko {
 		[[nodiscard]] ScenePointLight* CreatePointLight();
 		[[nodiscard]] SceneSpotLight* CreateSpotLight();
 		
-		[[nodiscard]] const SceneRenderInfo GetSceneRenderInfo() const;
+		// Builds the render info in the given allocator, usually Memory::GetFrameAllocator() on the thread that renders.
+		[[nodiscard]] SceneRenderInfo GetSceneRenderInfo(Memory::LinearAllocator& allocator) const;
 
 		EnvironmentMapHandle GetEnvironmentMapHandle() const;
 		void SetEnvironmentMapHandle(EnvironmentMapHandle handle);
 
 		const std::string& GetName() { return m_Name; };
 
-		bool Scene::OnResize(const Event::EventData& data);
+		bool OnResize(const Event::EventData& data);
 
 	private:
-		const void PopulateSceneRenderInfo(SceneRenderInfo& sceneRenderInfo, glm::mat4 transform) const;
-	
-	private:
-		Scope<SceneNode> m_RootNode;
+		SceneNode* m_RootNode{ nullptr };
+
+		// Bumped whenever a node or an appended scene is added, the flattened hierarchy is rebuilt when it changes.
+		u64 m_StructureVersion{ 0 };
+		mutable SceneHierarchy m_Hierarchy;
 
-		std::vector<Scope<SceneRenderObject>> m_SceneRenderObject;
-		std::vector<Scope<SceneLight>> m_Lights;
-		std::vector<Scope<SceneCamera>> m_Cameras;
+		// Scene objects are stored in pools so objects of one type sit next to each other
+		// and the whole scene is torn down chunk by chunk.
+		Memory::PoolAllocator<SceneNode> m_NodePool{ Memory::MemoryTag::Scene };
+		Memory::PoolAllocator<SceneRenderObject> m_SceneRenderObjectPool{ Memory::MemoryTag::Scene };
+		Memory::PoolAllocator<SceneDirectionalLight> m_DirectionalLightPool{ Memory::MemoryTag::Scene };
+		Memory::PoolAllocator<ScenePointLight> m_PointLightPool{ Memory::MemoryTag::Scene };
+		Memory::PoolAllocator<SceneSpotLight> m_SpotLightPool{ Memory::MemoryTag::Scene };
+		Memory::PoolAllocator<SceneCamera, 16> m_CameraPool{ Memory::MemoryTag::Scene };
 
 		EnvironmentMapHandle m_EnvironmentMapHandle{ 0 };
 
 		std::string m_Name{ "Scene" };
 
+		// Sizes of the last render info, used to reserve up front so the arrays never regrow.
+		struct RenderInfoSizes
+		{
+			size_t RenderObjects{ 0 };
+			size_t DirectionalLights{ 0 };
+			size_t PointLights{ 0 };
+			size_t SpotLights{ 0 };
+			size_t ChangedRenderObjects{ 0 };
+		};
+		mutable RenderInfoSizes m_LastRenderInfoSizes;
+
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Defines.h"
+
+#include "Core/TransformKernels.h"
+
+#include <vector>
+
+namespace Gecko {
+
+	class Scene;
+	class SceneNode;
+
+	// The node tree of a scene flattened into arrays, appended scenes included. Entries are in depth first order so a
+	// parent always comes before its children, the world transforms are then computed in a single pass over the arrays.
+	// A scene that is appended more than once gets an entry per instance.
+	class SceneHierarchy
+	{
+	public:
+		static constexpr u32 NO_PARENT = Math::NO_PARENT_MATRIX;
+
+		SceneHierarchy() = default;
+		~SceneHierarchy() {};
+
+		// Flattens the tree below the root node of the scene.
+		void Build(const Scene& scene);
+		// True when nodes or scenes were added to any of the flattened scenes since the last Build.
+		bool IsOutdated() const;
+
+		// Recomputes the world transforms of the nodes that moved and of everything below them since the last update.
+		// After a Build every node counts as moved.
+		void UpdateTransforms();
+
+		u32 GetNodeCount() const { return static_cast<u32>(m_Nodes.size()); }
+		const SceneNode* GetNode(u32 index) const { return m_Nodes[index]; }
+		u32 GetParent(u32 index) const { return m_Parents[index]; }
+		const glm::mat4& GetLocalTransform(u32 index) const { return m_LocalTransforms[index]; }
+		const glm::mat4& GetWorldTransform(u32 index) const { return m_WorldTransforms[index]; }
+		bool HasWorldTransformChanged(u32 index) const { return m_WorldChanged[index] != 0; }
+		// Entries whose world transform changed in the last update, in hierarchy order.
+		const std::vector<u32>& GetChangedNodes() const { return m_ChangedNodes; }
+
+		// The scene flattened last, it decides the environment map of the render info.
+		const Scene* GetLastScene() const;
+
+	private:
+		// Composes the local matrices of the moved nodes with the SIMD kernels.
+		void ComposeLocalTransforms();
+
+	private:
+		struct SceneVersion
+		{
+			const Gecko::Scene* Source{ nullptr };
+			u64 StructureVersion{ 0 };
+		};
+
+		// Built once per structure change.
+		std::vector<const SceneNode*> m_Nodes;
+		std::vector<u32> m_Parents;
+		// Scenes in the order they were flattened, to notice when one of them changed.
+		std::vector<SceneVersion> m_Scenes;
+
+		// Kept between updates, only the entries below a moved node are rewritten.
+		std::vector<glm::mat4> m_LocalTransforms;
+		std::vector<glm::mat4> m_WorldTransforms;
+		// Transform version of the node when its local transform was last read.
+		std::vector<u32> m_TransformVersions;
+		std::vector<u8> m_WorldChanged;
+		// Entries whose own transform changed, and entries whose world transform changed, in the last update.
+		std::vector<u32> m_MovedNodes;
+		std::vector<u32> m_ChangedNodes;
+	};
+
+}
@@ -3,6 +3,7 @@
 #include "Defines.h"
 
 #include "Rendering/Frontend/ResourceManager/ResourceObjects.h"
+#include "Core/LinearAllocator.h"
 
 #include "glm/common.hpp"
 
@@ -10,8 +11,8 @@ namespace Gecko {
 
 	struct RenderObjectRenderInfo
 	{
-		MeshHandle MeshHandle{ 0 };
-		MaterialHandle MaterialHandle{ 0 };
+		Gecko::MeshHandle MeshHandle{ 0 };
+		Gecko::MaterialHandle MaterialHandle{ 0 };
 		glm::mat4 Transform{ 0.f };
 	};
 
@@ -45,19 +46,37 @@ namespace Gecko {
 		f32 SpotAngle{ 0.f };
 	};
 
+	// Only valid for the frame it was created in, its arrays live in a LinearAllocator that is reset every frame.
 	struct SceneRenderInfo
 	{
-		std::vector<RenderObjectRenderInfo> RenderObjects;
-		std::vector<DirectionalLightRenderInfo> DirectionalLights;
-		std::vector<PointLightRenderInfo> PointLights;
-		std::vector<SpotLightRenderInfo> SpotLights;
+		explicit SceneRenderInfo(Memory::LinearAllocator& allocator)
+			: RenderObjects(Memory::LinearAllocatorAdapter<RenderObjectRenderInfo>(allocator))
+			, DirectionalLights(Memory::LinearAllocatorAdapter<DirectionalLightRenderInfo>(allocator))
+			, PointLights(Memory::LinearAllocatorAdapter<PointLightRenderInfo>(allocator))
+			, SpotLights(Memory::LinearAllocatorAdapter<SpotLightRenderInfo>(allocator))
+			, ChangedRenderObjects(Memory::LinearAllocatorAdapter<u32>(allocator))
+			, VisibleRenderObjects(Memory::LinearAllocatorAdapter<u32>(allocator))
+		{}
+
+		FrameVector<RenderObjectRenderInfo> RenderObjects;
+		FrameVector<DirectionalLightRenderInfo> DirectionalLights;
+		FrameVector<PointLightRenderInfo> PointLights;
+		FrameVector<SpotLightRenderInfo> SpotLights;
+
+		// Indices of the render objects that moved since the previous render info of the scene, for work that can be
+		// kept between frames like acceleration structures and shadow maps. Every object is listed after the scene
+		// changed structurally, indices are only comparable between frames without such a change.
+		FrameVector<u32> ChangedRenderObjects;
+
+		// Indices of the render objects inside the camera frustum, in order, filled by Renderer::CullScene.
+		FrameVector<u32> VisibleRenderObjects;
 
 		bool HasCamera{ false };
 		CameraRenderInfo Camera;
 	
 		EnvironmentMapHandle EnvironmentMap{ 0 };
 	
-		TLAS* TLAS;
+		Gecko::TLAS* TLAS;
 	};
 
 }
\ No newline at end of file
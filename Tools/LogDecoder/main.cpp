@@ -0,0 +1,308 @@
+#include "Core/BinaryLog.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Turns a binary log written with Logger::LogMode::Binary back into text.
+// Usage: GeckoLogDecoder <log.glog> [output.txt]
+
+namespace
+{
+	using namespace Gecko;
+
+	const char* s_LevelStrings[6] = { "[FATAL]: ", "[ERROR]: ", "[WARN]:  ", "[INFO]:  ", "[DEBUG]: ", "[TRACE]: " };
+
+	struct DecodedFormat
+	{
+		bool Registered{ false };
+		u8 Level{ 0 };
+		u32 Line{ 0 };
+		std::string File;
+		std::string Format;
+		i32 NumArguments{ -1 };
+		Logger::FormatSpec Arguments[Logger::MAX_FORMAT_ARGUMENTS];
+	};
+
+	template<typename T>
+	bool Read(FILE* file, T& value)
+	{
+		return fread(&value, sizeof(T), 1, file) == 1;
+	}
+
+	bool ReadString(FILE* file, std::string& string)
+	{
+		u16 length;
+		if (!Read(file, length))
+			return false;
+
+		string.resize(length);
+		return length == 0 || fread(&string[0], 1, length, file) == length;
+	}
+
+	template<typename T>
+	bool ReadPayload(const u8*& cursor, const u8* end, T& value)
+	{
+		if (static_cast<size_t>(end - cursor) < sizeof(T))
+			return false;
+
+		memcpy(&value, cursor, sizeof(T));
+		cursor += sizeof(T);
+		return true;
+	}
+
+	template<typename T>
+	void AppendFormatted(std::string& text, const std::string& spec, T value)
+	{
+		char buffer[1024];
+		int written = snprintf(buffer, sizeof(buffer), spec.c_str(), value);
+		if (written > 0)
+		{
+			text.append(buffer, static_cast<size_t>(written) < sizeof(buffer) ? static_cast<size_t>(written) : sizeof(buffer) - 1);
+		}
+	}
+
+	// Integers are stored as 64 bits, replace the length modifier so printf reads a long long.
+	std::string WidenIntegerSpec(const std::string& spec)
+	{
+		size_t conversion = spec.size() - 1;
+		size_t modifier = conversion;
+		while (modifier > 0 && strchr("hlzjtL", spec[modifier - 1]) != nullptr)
+		{
+			modifier--;
+		}
+		return spec.substr(0, modifier) + "ll" + spec[conversion];
+	}
+
+	std::string StripLongDouble(const std::string& spec)
+	{
+		std::string result = spec;
+		result.erase(result.size() - 2, 1);
+		return result;
+	}
+
+	// Appends the text between two conversions, "%%" is the only escape that can appear there.
+	void AppendLiteral(std::string& text, const std::string& format, size_t start, size_t end)
+	{
+		for (size_t i = start; i < end; i++)
+		{
+			text.push_back(format[i]);
+			if (format[i] == '%' && i + 1 < end && format[i + 1] == '%')
+			{
+				i++;
+			}
+		}
+	}
+
+	bool DecodeMessage(const DecodedFormat& format, const u8* cursor, const u8* end, std::string& text)
+	{
+		size_t literalStart = 0;
+		for (i32 i = 0; i < format.NumArguments; i++)
+		{
+			const Logger::FormatSpec& argument = format.Arguments[i];
+			AppendLiteral(text, format.Format, literalStart, argument.Offset);
+			literalStart = argument.Offset + argument.Length;
+
+			std::string spec = format.Format.substr(argument.Offset, argument.Length);
+			switch (argument.Argument)
+			{
+			case Logger::FormatArgument::Int:
+			{
+				i64 value;
+				if (!ReadPayload(cursor, end, value))
+					return false;
+				AppendFormatted(text, spec, static_cast<int>(value));
+				break;
+			}
+			case Logger::FormatArgument::Long:
+			case Logger::FormatArgument::LongLong:
+			case Logger::FormatArgument::Size:
+			case Logger::FormatArgument::IntMax:
+			case Logger::FormatArgument::PtrDiff:
+			{
+				i64 value;
+				if (!ReadPayload(cursor, end, value))
+					return false;
+				AppendFormatted(text, WidenIntegerSpec(spec), static_cast<long long>(value));
+				break;
+			}
+			case Logger::FormatArgument::Double:
+			case Logger::FormatArgument::LongDouble:
+			{
+				f64 value;
+				if (!ReadPayload(cursor, end, value))
+					return false;
+				AppendFormatted(text, argument.Argument == Logger::FormatArgument::LongDouble ? StripLongDouble(spec) : spec, value);
+				break;
+			}
+			case Logger::FormatArgument::Pointer:
+			{
+				u64 value;
+				if (!ReadPayload(cursor, end, value))
+					return false;
+				AppendFormatted(text, spec, reinterpret_cast<void*>(static_cast<uintptr_t>(value)));
+				break;
+			}
+			case Logger::FormatArgument::String:
+			{
+				u16 length;
+				if (!ReadPayload(cursor, end, length) || static_cast<size_t>(end - cursor) < length)
+					return false;
+				std::string string(reinterpret_cast<const char*>(cursor), length);
+				cursor += length;
+				AppendFormatted(text, spec, string.c_str());
+				break;
+			}
+			}
+		}
+
+		AppendLiteral(text, format.Format, literalStart, format.Format.size());
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		printf("Usage: GeckoLogDecoder <log.glog> [output.txt]\n");
+		return 1;
+	}
+
+	FILE* input = fopen(argv[1], "rb");
+	if (input == nullptr)
+	{
+		printf("Failed to open %s\n", argv[1]);
+		return 1;
+	}
+
+	FILE* output = argc > 2 ? fopen(argv[2], "w") : stdout;
+	if (output == nullptr)
+	{
+		printf("Failed to open %s\n", argv[2]);
+		fclose(input);
+		return 1;
+	}
+
+	char magic[sizeof(Logger::BINARY_LOG_MAGIC)];
+	u32 version = 0;
+	if (fread(magic, 1, sizeof(magic), input) != sizeof(magic) || memcmp(magic, Logger::BINARY_LOG_MAGIC, sizeof(magic)) != 0
+		|| !Read(input, version) || version != Logger::BINARY_LOG_VERSION)
+	{
+		printf("%s is not a binary log of version %u\n", argv[1], Logger::BINARY_LOG_VERSION);
+		fclose(input);
+		return 1;
+	}
+
+	std::vector<DecodedFormat> formats;
+	std::vector<u8> payload;
+	std::string text;
+	u64 firstTimestamp = 0;
+	bool corrupt = false;
+
+	Logger::BinaryLogEntry entry;
+	while (!corrupt && Read(input, entry))
+	{
+		switch (entry)
+		{
+		case Logger::BinaryLogEntry::Format:
+		{
+			u32 formatID;
+			DecodedFormat format;
+			if (!Read(input, formatID) || !Read(input, format.Level) || !Read(input, format.Line)
+				|| !ReadString(input, format.File) || !ReadString(input, format.Format) || format.Level > Logger::LOG_LEVEL_TRACE)
+			{
+				corrupt = true;
+				break;
+			}
+
+			format.Registered = true;
+			format.NumArguments = Logger::ParseFormat(format.Format.c_str(), format.Arguments, Logger::MAX_FORMAT_ARGUMENTS);
+			if (formatID >= formats.size())
+			{
+				formats.resize(formatID + 1);
+			}
+			formats[formatID] = format;
+			break;
+		}
+		case Logger::BinaryLogEntry::Message:
+		{
+			u16 length;
+			u32 formatID;
+			u64 timestamp;
+			payload.resize(0xFFFF);
+			if (!Read(input, length) || fread(payload.data(), 1, length, input) != length || length < sizeof(formatID) + sizeof(timestamp))
+			{
+				corrupt = true;
+				break;
+			}
+
+			const u8* cursor = payload.data();
+			const u8* end = cursor + length;
+			ReadPayload(cursor, end, formatID);
+			ReadPayload(cursor, end, timestamp);
+			if (firstTimestamp == 0)
+			{
+				firstTimestamp = timestamp;
+			}
+
+			text.clear();
+			if (formatID >= formats.size() || !formats[formatID].Registered || formats[formatID].NumArguments < 0)
+			{
+				fprintf(output, "<message with unknown format %u>\n", formatID);
+				break;
+			}
+
+			const DecodedFormat& format = formats[formatID];
+			if (!DecodeMessage(format, cursor, end, text))
+			{
+				fprintf(output, "<corrupt message for %s:%u>\n", format.File.c_str(), format.Line);
+				break;
+			}
+			fprintf(output, "%12.6f %s%s\n", static_cast<f64>(timestamp - firstTimestamp) / 1e9, s_LevelStrings[format.Level], text.c_str());
+			break;
+		}
+		case Logger::BinaryLogEntry::Text:
+		{
+			u8 level;
+			if (!Read(input, level) || !ReadString(input, text))
+			{
+				corrupt = true;
+				break;
+			}
+			// Text records were formatted when they were logged and already carry their level and newline.
+			fprintf(output, "%12s %s", "", text.c_str());
+			break;
+		}
+		case Logger::BinaryLogEntry::Dropped:
+		{
+			u64 count;
+			if (!Read(input, count))
+			{
+				corrupt = true;
+				break;
+			}
+			fprintf(output, "%12s %s%llu log messages were dropped, the log buffer was full.\n", "", s_LevelStrings[Logger::LOG_LEVEL_WARN], static_cast<unsigned long long>(count));
+			break;
+		}
+		default:
+			corrupt = true;
+			break;
+		}
+	}
+
+	if (corrupt)
+	{
+		fprintf(output, "<the log is corrupt or truncated from here on>\n");
+	}
+
+	fclose(input);
+	if (output != stdout)
+	{
+		fclose(output);
+	}
+	return corrupt ? 1 : 0;
+}
@@ -0,0 +1,147 @@
+#include "Core/PackFile.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Bundles every file below a directory into a pack file that FileSystem::MountPack can mount.
+// Usage: GeckoPackBuilder <directory> <output.gkpack>
+
+namespace
+{
+	using namespace Gecko;
+
+	struct InputFile
+	{
+		std::filesystem::path Path;
+		std::string Name;
+		u64 Size{ 0 };
+	};
+
+	u64 AlignUp(u64 value, u64 alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	bool WritePadding(FILE* file, u64 from, u64 to)
+	{
+		static const u8 zeros[FileSystem::PACK_DATA_ALIGNMENT] = {};
+		return to == from || fwrite(zeros, 1, static_cast<size_t>(to - from), file) == to - from;
+	}
+
+	bool CopyFileData(FILE* output, const InputFile& inputFile, std::vector<u8>& buffer)
+	{
+		FILE* input = fopen(inputFile.Path.string().c_str(), "rb");
+		if (input == nullptr)
+		{
+			printf("Failed to open %s\n", inputFile.Path.string().c_str());
+			return false;
+		}
+
+		u64 remaining = inputFile.Size;
+		while (remaining > 0)
+		{
+			size_t chunk = static_cast<size_t>(std::min<u64>(remaining, buffer.size()));
+			if (fread(buffer.data(), 1, chunk, input) != chunk || fwrite(buffer.data(), 1, chunk, output) != chunk)
+			{
+				printf("Failed to copy %s\n", inputFile.Path.string().c_str());
+				fclose(input);
+				return false;
+			}
+			remaining -= chunk;
+		}
+
+		fclose(input);
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		printf("Usage: GeckoPackBuilder <directory> <output.gkpack>\n");
+		return 1;
+	}
+
+	std::filesystem::path root = argv[1];
+	std::error_code error;
+	if (!std::filesystem::is_directory(root, error))
+	{
+		printf("%s is not a directory\n", argv[1]);
+		return 1;
+	}
+
+	std::vector<InputFile> files;
+	for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(root, error))
+	{
+		if (!entry.is_regular_file())
+			continue;
+
+		InputFile file;
+		file.Path = entry.path();
+		file.Name = entry.path().lexically_relative(root).generic_string();
+		file.Size = static_cast<u64>(entry.file_size());
+		files.push_back(file);
+	}
+
+	// Sorted, so packing the same directory twice gives the same file.
+	std::sort(files.begin(), files.end(), [](const InputFile& a, const InputFile& b) { return a.Name < b.Name; });
+
+	FileSystem::PackHeader header;
+	memcpy(header.Magic, FileSystem::PACK_MAGIC, sizeof(header.Magic));
+	header.Version = FileSystem::PACK_VERSION;
+	header.NumEntries = static_cast<u32>(files.size());
+	header.NamesOffset = sizeof(FileSystem::PackHeader) + files.size() * sizeof(FileSystem::PackEntry);
+
+	std::string names;
+	std::vector<FileSystem::PackEntry> entries(files.size());
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		entries[i].NameOffset = static_cast<u32>(names.size());
+		entries[i].NameLength = static_cast<u32>(files[i].Name.size());
+		entries[i].Size = files[i].Size;
+		names += files[i].Name;
+	}
+	header.NamesSize = names.size();
+
+	u64 offset = AlignUp(header.NamesOffset + header.NamesSize, FileSystem::PACK_DATA_ALIGNMENT);
+	for (FileSystem::PackEntry& entry : entries)
+	{
+		entry.Offset = offset;
+		offset = AlignUp(offset + entry.Size, FileSystem::PACK_DATA_ALIGNMENT);
+	}
+
+	FILE* output = fopen(argv[2], "wb");
+	if (output == nullptr)
+	{
+		printf("Failed to open %s\n", argv[2]);
+		return 1;
+	}
+
+	bool written = fwrite(&header, sizeof(header), 1, output) == 1
+		&& (entries.empty() || fwrite(entries.data(), sizeof(FileSystem::PackEntry), entries.size(), output) == entries.size())
+		&& (names.empty() || fwrite(names.data(), 1, names.size(), output) == names.size());
+
+	u64 position = header.NamesOffset + header.NamesSize;
+	std::vector<u8> buffer(1024 * 1024);
+	for (size_t i = 0; written && i < files.size(); i++)
+	{
+		written = WritePadding(output, position, entries[i].Offset) && CopyFileData(output, files[i], buffer);
+		position = entries[i].Offset + entries[i].Size;
+	}
+
+	fclose(output);
+	if (!written)
+	{
+		printf("Failed to write %s\n", argv[2]);
+		return 1;
+	}
+
+	printf("Packed %zu files into %s\n", files.size(), argv[2]);
+	return 0;
+}
@@ -0,0 +1,252 @@
+#include "Core/AllocationGuard.h"
+
+#include "Core/Platform.h"
+#include "Core/Logger.h"
+#include "Core/Asserts.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace Gecko { namespace Memory {
+
+#if GECKO_ALLOCATION_GUARD
+	namespace
+	{
+		constexpr u32 MAX_CALL_STACK_DEPTH = 16;
+		constexpr u32 MAX_CALL_SITES = 128;
+
+		struct CallSite
+		{
+			u64 Hash;
+			const char* Region;
+			MemoryTag Tag;
+			u64 Count;
+			u64 Bytes;
+			u64 FirstFrame;
+			u32 Depth;
+			void* CallStack[MAX_CALL_STACK_DEPTH];
+		};
+
+		// Fixed storage, recording a guarded allocation must not allocate itself.
+		static CallSite s_CallSites[MAX_CALL_SITES];
+		static u32 s_NumCallSites = 0;
+		static u64 s_DroppedCallSites = 0;
+		static std::mutex s_CallSiteMutex;
+
+		static std::atomic<u8> s_Mode{ static_cast<u8>(AllocationGuardMode::Disabled) };
+		static std::atomic<u64> s_WarmupFrames{ 0 };
+		static std::atomic<u64> s_FrameIndex{ 0 };
+		static std::atomic<u64> s_AllocationsThisFrame{ 0 };
+		static std::atomic<u64> s_BytesThisFrame{ 0 };
+		static std::atomic<u64> s_AllocationsLastFrame{ 0 };
+		static std::atomic<u64> s_BytesLastFrame{ 0 };
+		static std::atomic<u64> s_TotalAllocations{ 0 };
+
+		thread_local const char* t_Region = nullptr;
+		// Set while recording, capturing a call stack or logging may allocate.
+		thread_local bool t_InGuardHook = false;
+
+		u64 HashCallStack(void** callStack, u32 depth)
+		{
+			// FNV-1a over the return addresses.
+			u64 hash = 0xCBF29CE484222325ull;
+			for (u32 i = 0; i < depth; i++)
+			{
+				hash ^= static_cast<u64>(reinterpret_cast<uintptr_t>(callStack[i]));
+				hash *= 0x100000001B3ull;
+			}
+			return hash;
+		}
+
+		// Returns true when this is the first allocation seen from this call site.
+		bool RecordCallSite(const char* region, size_t size, MemoryTag tag)
+		{
+			void* callStack[MAX_CALL_STACK_DEPTH];
+			u32 depth = Platform::CaptureCallStack(callStack, MAX_CALL_STACK_DEPTH);
+			u64 hash = HashCallStack(callStack, depth);
+
+			std::lock_guard<std::mutex> lock(s_CallSiteMutex);
+			for (u32 i = 0; i < s_NumCallSites; i++)
+			{
+				CallSite& callSite = s_CallSites[i];
+				if (callSite.Hash == hash && callSite.Region == region)
+				{
+					callSite.Count++;
+					callSite.Bytes += size;
+					return false;
+				}
+			}
+
+			if (s_NumCallSites == MAX_CALL_SITES)
+			{
+				s_DroppedCallSites++;
+				return true;
+			}
+
+			CallSite& callSite = s_CallSites[s_NumCallSites++];
+			callSite.Hash = hash;
+			callSite.Region = region;
+			callSite.Tag = tag;
+			callSite.Count = 1;
+			callSite.Bytes = size;
+			callSite.FirstFrame = s_FrameIndex.load(std::memory_order_relaxed);
+			callSite.Depth = depth;
+			for (u32 i = 0; i < depth; i++)
+			{
+				callSite.CallStack[i] = callStack[i];
+			}
+			return true;
+		}
+	}
+
+	void OnGuardedAllocation(size_t size, MemoryTag tag)
+	{
+		const char* region = t_Region;
+		if (region == nullptr || t_InGuardHook)
+			return;
+
+		AllocationGuardMode mode = static_cast<AllocationGuardMode>(s_Mode.load(std::memory_order_relaxed));
+		if (mode == AllocationGuardMode::Disabled)
+			return;
+
+		if (s_FrameIndex.load(std::memory_order_relaxed) < s_WarmupFrames.load(std::memory_order_relaxed))
+			return;
+
+		t_InGuardHook = true;
+
+		s_AllocationsThisFrame.fetch_add(1, std::memory_order_relaxed);
+		s_BytesThisFrame.fetch_add(size, std::memory_order_relaxed);
+		s_TotalAllocations.fetch_add(1, std::memory_order_relaxed);
+
+		bool newCallSite = RecordCallSite(region, size, tag);
+		if (mode == AllocationGuardMode::Assert && newCallSite)
+		{
+			LOG_ERROR("Allocation of %llu bytes in allocation-free region %s", static_cast<unsigned long long>(size), region);
+			ASSERT_MSG(false, "Allocation in an allocation-free region!");
+		}
+
+		t_InGuardHook = false;
+	}
+
+	ScopedAllocationGuard::ScopedAllocationGuard(const char* region)
+		: m_PreviousRegion(t_Region)
+	{
+		t_Region = region;
+	}
+
+	ScopedAllocationGuard::~ScopedAllocationGuard()
+	{
+		t_Region = m_PreviousRegion;
+	}
+#endif // GECKO_ALLOCATION_GUARD
+
+	void SetAllocationGuardMode(AllocationGuardMode mode, u32 warmupFrames)
+	{
+#if GECKO_ALLOCATION_GUARD
+		s_WarmupFrames.store(s_FrameIndex.load(std::memory_order_relaxed) + warmupFrames, std::memory_order_relaxed);
+		s_Mode.store(static_cast<u8>(mode), std::memory_order_relaxed);
+#else
+		(void)mode;
+		(void)warmupFrames;
+#endif
+	}
+
+	AllocationGuardMode GetAllocationGuardMode()
+	{
+#if GECKO_ALLOCATION_GUARD
+		return static_cast<AllocationGuardMode>(s_Mode.load(std::memory_order_relaxed));
+#else
+		return AllocationGuardMode::Disabled;
+#endif
+	}
+
+	void EndAllocationGuardFrame()
+	{
+#if GECKO_ALLOCATION_GUARD
+		s_AllocationsLastFrame.store(s_AllocationsThisFrame.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+		s_BytesLastFrame.store(s_BytesThisFrame.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+		s_FrameIndex.fetch_add(1, std::memory_order_relaxed);
+#endif
+	}
+
+	AllocationGuardStats GetAllocationGuardStats()
+	{
+		AllocationGuardStats stats;
+#if GECKO_ALLOCATION_GUARD
+		stats.FrameIndex = s_FrameIndex.load(std::memory_order_relaxed);
+		stats.AllocationsThisFrame = s_AllocationsThisFrame.load(std::memory_order_relaxed);
+		stats.AllocationsLastFrame = s_AllocationsLastFrame.load(std::memory_order_relaxed);
+		stats.BytesLastFrame = s_BytesLastFrame.load(std::memory_order_relaxed);
+		stats.TotalAllocations = s_TotalAllocations.load(std::memory_order_relaxed);
+#endif
+		return stats;
+	}
+
+	u64 ReportAllocationGuard()
+	{
+#if GECKO_ALLOCATION_GUARD
+		u64 totalAllocations = s_TotalAllocations.load(std::memory_order_relaxed);
+		if (totalAllocations == 0)
+		{
+			LOG_INFO("Allocation guard: no allocations in guarded regions.");
+			return 0;
+		}
+
+		// Copy the call sites out first, resolving symbols and logging allocate.
+		u32 numCallSites;
+		u64 droppedCallSites;
+		static CallSite callSites[MAX_CALL_SITES];
+		{
+			std::lock_guard<std::mutex> lock(s_CallSiteMutex);
+			numCallSites = s_NumCallSites;
+			droppedCallSites = s_DroppedCallSites;
+			for (u32 i = 0; i < numCallSites; i++)
+			{
+				callSites[i] = s_CallSites[i];
+			}
+		}
+
+		LOG_WARN("Allocation guard: %llu allocations in guarded regions from %u call sites:",
+			static_cast<unsigned long long>(totalAllocations), numCallSites);
+		for (u32 i = 0; i < numCallSites; i++)
+		{
+			const CallSite& callSite = callSites[i];
+			LOG_WARN("  %s: %llu allocations, %llu bytes, tag %s, first seen in frame %llu",
+				callSite.Region,
+				static_cast<unsigned long long>(callSite.Count),
+				static_cast<unsigned long long>(callSite.Bytes),
+				GetTagName(callSite.Tag),
+				static_cast<unsigned long long>(callSite.FirstFrame));
+
+			for (u32 frame = 0; frame < callSite.Depth; frame++)
+			{
+				LOG_WARN("    %s", Platform::GetSymbolName(callSite.CallStack[frame]).c_str());
+			}
+		}
+		if (droppedCallSites > 0)
+		{
+			LOG_WARN("  %llu call sites were not recorded, the call site table is full.", static_cast<unsigned long long>(droppedCallSites));
+		}
+
+		return totalAllocations;
+#else
+		LOG_INFO("The allocation guard is disabled in this build.");
+		return 0;
+#endif
+	}
+
+	void ResetAllocationGuard()
+	{
+#if GECKO_ALLOCATION_GUARD
+		std::lock_guard<std::mutex> lock(s_CallSiteMutex);
+		s_NumCallSites = 0;
+		s_DroppedCallSites = 0;
+		s_AllocationsThisFrame.store(0, std::memory_order_relaxed);
+		s_BytesThisFrame.store(0, std::memory_order_relaxed);
+		s_AllocationsLastFrame.store(0, std::memory_order_relaxed);
+		s_BytesLastFrame.store(0, std::memory_order_relaxed);
+		s_TotalAllocations.store(0, std::memory_order_relaxed);
+#endif
+	}
+
+} }
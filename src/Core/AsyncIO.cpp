@@ -0,0 +1,407 @@
+#include "Core/AsyncIO.h"
+
+#include "AsyncIOInternal.h"
+
+#include "Core/Asserts.h"
+#include "Core/Logger.h"
+#include "Core/Threading.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace Gecko { namespace IO
+{
+
+	namespace
+	{
+		using Internal::Request;
+
+		constexpr u32 NUM_PRIORITIES = static_cast<u32>(IOPriority::MaxPriorities);
+		// Touching one byte per page is enough to have the kernel read the page in.
+		constexpr u64 PREFAULT_STRIDE = 4096;
+
+		struct IOState
+		{
+			IOServiceDesc Desc;
+			bool UseIOUring{ false };
+
+			std::mutex Mutex;
+			std::condition_variable WorkAvailable;
+			std::condition_variable CompletionAvailable;
+			bool Stop{ false };
+
+			// Slots never move, a request pointer stays valid until its slot is released.
+			std::vector<Scope<Request>> Requests;
+			std::vector<u32> FreeSlots;
+			u32 NumLiveRequests{ 0 };
+
+			std::deque<Request*> WorkerQueues[NUM_PRIORITIES];
+			std::deque<Request*> IOUringQueues[NUM_PRIORITIES];
+			std::vector<Request*> Completed;
+
+			std::vector<std::thread> Workers;
+		};
+
+		static Scope<IOState> s_State{ nullptr };
+
+		// Expects the lock to be held.
+		Request* GetRequest(IORequestHandle handle)
+		{
+			if (!handle.IsValid() || handle.Index >= s_State->Requests.size())
+				return nullptr;
+
+			Request* request = s_State->Requests[handle.Index].get();
+			return request->Generation == handle.Generation ? request : nullptr;
+		}
+
+		// Expects the lock to be held.
+		Request* PopQueue(std::deque<Request*>* queues)
+		{
+			for (u32 priority = 0; priority < NUM_PRIORITIES; priority++)
+			{
+				if (!queues[priority].empty())
+				{
+					Request* request = queues[priority].front();
+					queues[priority].pop_front();
+					return request;
+				}
+			}
+			return nullptr;
+		}
+
+		// Expects the lock to be held.
+		bool RemoveFromQueue(std::deque<Request*>* queues, Request* request)
+		{
+			for (u32 priority = 0; priority < NUM_PRIORITIES; priority++)
+			{
+				for (auto it = queues[priority].begin(); it != queues[priority].end(); it++)
+				{
+					if (*it == request)
+					{
+						queues[priority].erase(it);
+						return true;
+					}
+				}
+			}
+			return false;
+		}
+
+		// Expects the lock to be held.
+		void ReleaseRequest(Request* request)
+		{
+			if (request->Buffer != nullptr)
+			{
+				Memory::Free(request->Buffer);
+			}
+
+			request->Path.clear();
+			request->NativePath.clear();
+			request->Callback = nullptr;
+			request->UserData = nullptr;
+			request->CancelRequested.store(false, std::memory_order_relaxed);
+			request->Status = IOStatus::Pending;
+			request->View = FileSystem::FileView();
+			request->Buffer = nullptr;
+			request->Size = 0;
+			request->BytesRead = 0;
+			request->File = -1;
+			request->Generation++;
+
+			s_State->FreeSlots.push_back(request->Slot);
+			s_State->NumLiveRequests--;
+		}
+
+		void WorkerThread(u32 index)
+		{
+			Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::General);
+			// Index 0 is the io_uring thread.
+			Threading::RegisterCurrentThread(Threading::ThreadRole::IO, index + 1);
+
+			while (true)
+			{
+				Request* request = nullptr;
+				{
+					std::unique_lock<std::mutex> lock(s_State->Mutex);
+					s_State->WorkAvailable.wait(lock, [&request]()
+						{
+							request = PopQueue(s_State->WorkerQueues);
+							return request != nullptr || s_State->Stop;
+						});
+					if (request == nullptr)
+						return;
+				}
+
+				if (request->CancelRequested.load(std::memory_order_relaxed))
+				{
+					Internal::CompleteRequest(request, IOStatus::Cancelled);
+					continue;
+				}
+
+				request->View = FileSystem::Open(request->Path);
+				if (!request->View.IsValid())
+				{
+					Internal::CompleteRequest(request, IOStatus::Failed);
+					continue;
+				}
+
+				// Page the file in here, so the callback does not stall on page faults.
+				const volatile u8* data = request->View.GetData();
+				u8 sum = 0;
+				for (u64 offset = 0; offset < request->View.GetSize(); offset += PREFAULT_STRIDE)
+				{
+					sum = static_cast<u8>(sum + data[offset]);
+				}
+				(void)sum;
+
+				Internal::CompleteRequest(request, IOStatus::Completed);
+			}
+		}
+
+		// Takes the finished requests and runs their callbacks without holding the lock, callbacks may start new reads.
+		u32 RunCompletions(std::unique_lock<std::mutex>& lock)
+		{
+			std::vector<Request*> completed;
+			completed.swap(s_State->Completed);
+			lock.unlock();
+
+			for (Request* request : completed)
+			{
+				IOResult result;
+				result.Handle.Index = request->Slot;
+				result.Handle.Generation = request->Generation;
+				result.Status = request->Status;
+				result.Path = request->Path.c_str();
+				if (request->Status == IOStatus::Completed)
+				{
+					result.Data = request->Buffer != nullptr ? request->Buffer : request->View.GetData();
+					result.Size = request->Buffer != nullptr ? request->BytesRead : request->View.GetSize();
+				}
+
+				if (request->Callback != nullptr)
+				{
+					request->Callback(result, request->UserData);
+				}
+			}
+
+			lock.lock();
+			for (Request* request : completed)
+			{
+				ReleaseRequest(request);
+			}
+			// Wakes threads waiting for one of these requests while this thread ran its callback.
+			s_State->CompletionAvailable.notify_all();
+			return static_cast<u32>(completed.size());
+		}
+	}
+
+	namespace Internal
+	{
+		Request* PopIOUringRequest()
+		{
+			std::lock_guard<std::mutex> lock(s_State->Mutex);
+			return PopQueue(s_State->IOUringQueues);
+		}
+
+		void CompleteRequest(Request* request, IOStatus status)
+		{
+			{
+				std::lock_guard<std::mutex> lock(s_State->Mutex);
+				// A read that finishes after it was cancelled is still reported as cancelled.
+				if (request->CancelRequested.load(std::memory_order_relaxed))
+				{
+					status = IOStatus::Cancelled;
+				}
+				request->Status = status;
+				s_State->Completed.push_back(request);
+			}
+			s_State->CompletionAvailable.notify_all();
+		}
+	}
+
+	bool Init(const IOServiceDesc& desc)
+	{
+		ASSERT_MSG(s_State == nullptr, "IO service already initialized!");
+
+		s_State = CreateScope<IOState>();
+		s_State->Desc = desc;
+
+#ifdef __linux__
+		if (desc.UseIOUring)
+		{
+			s_State->UseIOUring = Internal::StartIOUring(desc.QueueDepth > 0 ? desc.QueueDepth : 1);
+			if (!s_State->UseIOUring)
+			{
+				LOG_WARN("io_uring is not available, reading files with %u worker threads.", desc.NumThreads);
+			}
+		}
+#endif
+
+		u32 numThreads = desc.NumThreads > 0 ? desc.NumThreads : 1;
+		for (u32 i = 0; i < numThreads; i++)
+		{
+			s_State->Workers.emplace_back(WorkerThread, i);
+		}
+
+		return true;
+	}
+
+	void Shutdown()
+	{
+		ASSERT_MSG(s_State != nullptr, "IO service not initialized!");
+
+		{
+			std::lock_guard<std::mutex> lock(s_State->Mutex);
+			for (u32 priority = 0; priority < NUM_PRIORITIES; priority++)
+			{
+				for (std::deque<Request*>* queues : { s_State->WorkerQueues, s_State->IOUringQueues })
+				{
+					for (Request* request : queues[priority])
+					{
+						request->Status = IOStatus::Cancelled;
+						s_State->Completed.push_back(request);
+					}
+					queues[priority].clear();
+				}
+			}
+			s_State->Stop = true;
+		}
+		s_State->WorkAvailable.notify_all();
+
+#ifdef __linux__
+		if (s_State->UseIOUring)
+		{
+			Internal::StopIOUring();
+		}
+#endif
+		for (std::thread& worker : s_State->Workers)
+		{
+			worker.join();
+		}
+
+		ProcessCompletions();
+		ASSERT_MSG(s_State->NumLiveRequests == 0, "IO requests are still in flight after shutdown!");
+
+		s_State.reset();
+	}
+
+	IORequestHandle ReadFile(const std::string& path, IOPriority priority, IOCallback callback, void* userData)
+	{
+		ASSERT_MSG(s_State != nullptr, "IO service not initialized!");
+
+		// Only loose files go to io_uring, files in packs are already mapped.
+		std::string nativePath = s_State->UseIOUring ? FileSystem::GetNativePath(path) : std::string();
+
+		IORequestHandle handle;
+		{
+			std::lock_guard<std::mutex> lock(s_State->Mutex);
+
+			u32 slot;
+			if (!s_State->FreeSlots.empty())
+			{
+				slot = s_State->FreeSlots.back();
+				s_State->FreeSlots.pop_back();
+			}
+			else
+			{
+				slot = static_cast<u32>(s_State->Requests.size());
+				s_State->Requests.push_back(CreateScope<Request>());
+				s_State->Requests[slot]->Slot = slot;
+			}
+			s_State->NumLiveRequests++;
+
+			Request* request = s_State->Requests[slot].get();
+			request->Path = path;
+			request->NativePath = nativePath;
+			request->Priority = priority;
+			request->Callback = callback;
+			request->UserData = userData;
+			request->Tag = Memory::GetCurrentTag();
+
+			std::deque<Request*>* queues = nativePath.empty() ? s_State->WorkerQueues : s_State->IOUringQueues;
+			queues[static_cast<u32>(priority)].push_back(request);
+
+			handle.Index = slot;
+			handle.Generation = request->Generation;
+		}
+
+		if (nativePath.empty())
+		{
+			s_State->WorkAvailable.notify_one();
+		}
+#ifdef __linux__
+		else
+		{
+			Internal::WakeIOUring();
+		}
+#endif
+
+		return handle;
+	}
+
+	bool Cancel(IORequestHandle handle)
+	{
+		ASSERT_MSG(s_State != nullptr, "IO service not initialized!");
+
+		{
+			std::lock_guard<std::mutex> lock(s_State->Mutex);
+
+			Request* request = GetRequest(handle);
+			if (request == nullptr || request->Status != IOStatus::Pending)
+				return false;
+
+			request->CancelRequested.store(true, std::memory_order_relaxed);
+			if (!RemoveFromQueue(s_State->WorkerQueues, request) && !RemoveFromQueue(s_State->IOUringQueues, request))
+				return true;
+
+			request->Status = IOStatus::Cancelled;
+			s_State->Completed.push_back(request);
+		}
+		s_State->CompletionAvailable.notify_all();
+		return true;
+	}
+
+	u32 ProcessCompletions()
+	{
+		ASSERT_MSG(s_State != nullptr, "IO service not initialized!");
+
+		std::unique_lock<std::mutex> lock(s_State->Mutex);
+		if (s_State->Completed.empty())
+			return 0;
+
+		return RunCompletions(lock);
+	}
+
+	void Wait(IORequestHandle handle)
+	{
+		ASSERT_MSG(s_State != nullptr, "IO service not initialized!");
+
+		std::unique_lock<std::mutex> lock(s_State->Mutex);
+		while (GetRequest(handle) != nullptr)
+		{
+			s_State->CompletionAvailable.wait(lock, [handle]() { return !s_State->Completed.empty() || GetRequest(handle) == nullptr; });
+			RunCompletions(lock);
+		}
+	}
+
+	void WaitAll()
+	{
+		ASSERT_MSG(s_State != nullptr, "IO service not initialized!");
+
+		std::unique_lock<std::mutex> lock(s_State->Mutex);
+		while (s_State->NumLiveRequests > 0)
+		{
+			s_State->CompletionAvailable.wait(lock, []() { return !s_State->Completed.empty() || s_State->NumLiveRequests == 0; });
+			RunCompletions(lock);
+		}
+	}
+
+	const char* GetBackendName()
+	{
+		ASSERT_MSG(s_State != nullptr, "IO service not initialized!");
+
+		return s_State->UseIOUring ? "io_uring" : "thread pool";
+	}
+
+} }
@@ -0,0 +1,48 @@
+#pragma once
+#include "Core/AsyncIO.h"
+#include "Core/FileSystem.h"
+#include "Core/Memory.h"
+
+#include <atomic>
+
+// Shared between the request queue in AsyncIO.cpp and the io_uring backend.
+
+namespace Gecko { namespace IO { namespace Internal
+{
+
+	struct Request
+	{
+		std::string Path;
+		// Set for loose files when io_uring reads them, mapped files leave it empty.
+		std::string NativePath;
+		IOPriority Priority{ IOPriority::Normal };
+		IOCallback Callback{ nullptr };
+		void* UserData{ nullptr };
+		// Buffers are allocated with the tag that was current when the request was made.
+		Memory::MemoryTag Tag{ Memory::MemoryTag::General };
+		std::atomic<bool> CancelRequested{ false };
+		IOStatus Status{ IOStatus::Pending };
+		u32 Slot{ 0 };
+		u32 Generation{ 0 };
+
+		// Result of a mapped read.
+		FileSystem::FileView View;
+		// Result of an io_uring read.
+		u8* Buffer{ nullptr };
+		u64 Size{ 0 };
+		u64 BytesRead{ 0 };
+		int File{ -1 };
+	};
+
+	// Highest priority request waiting for io_uring, nullptr when there is none. Never blocks.
+	Request* PopIOUringRequest();
+	void CompleteRequest(Request* request, IOStatus status);
+
+#ifdef __linux__
+	bool StartIOUring(u32 queueDepth);
+	void StopIOUring();
+	// Called whenever a request is queued for io_uring.
+	void WakeIOUring();
+#endif
+
+} } }
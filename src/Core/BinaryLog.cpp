@@ -0,0 +1,286 @@
+#include "Core/BinaryLog.h"
+
+#include "Core/Asserts.h"
+#include "Core/Memory.h"
+
+#include <string.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+namespace Gecko { namespace Logger
+{
+
+	namespace
+	{
+		constexpr u32 FORMATS_PER_CHUNK = 256;
+		constexpr u32 MAX_FORMAT_CHUNKS = 64;
+
+		// Chunks never move once they are allocated, so a registered FormatInfo can be read without the lock.
+		static std::atomic<FormatInfo*> s_FormatChunks[MAX_FORMAT_CHUNKS];
+		static std::atomic<u32> s_NumFormats{ 0 };
+		static std::mutex s_FormatMutex;
+
+		char* CopyString(const char* string)
+		{
+			size_t length = strlen(string);
+			char* copy = static_cast<char*>(Memory::Allocate(length + 1, Memory::MemoryTag::Logger));
+			memcpy(copy, string, length + 1);
+			return copy;
+		}
+
+		template<typename T>
+		bool Write(u8*& cursor, const u8* end, const T& value)
+		{
+			if (static_cast<size_t>(end - cursor) < sizeof(T))
+				return false;
+
+			memcpy(cursor, &value, sizeof(T));
+			cursor += sizeof(T);
+			return true;
+		}
+
+		bool IsFlag(char c)
+		{
+			return c == '-' || c == '+' || c == ' ' || c == '#' || c == '0';
+		}
+
+		bool IsDigit(char c)
+		{
+			return c >= '0' && c <= '9';
+		}
+	}
+
+	i32 ParseFormat(const char* format, FormatSpec* specs, u32 maxSpecs)
+	{
+		if (strlen(format) > 0xFFFF)
+			return -1;
+
+		u32 numSpecs = 0;
+		for (const char* c = format; *c != '\0'; c++)
+		{
+			if (*c != '%')
+				continue;
+
+			const char* start = c++;
+			if (*c == '%')
+				continue;
+
+			while (IsFlag(*c))
+				c++;
+
+			// Widths and precisions passed as arguments are not supported.
+			if (*c == '*')
+				return -1;
+			while (IsDigit(*c))
+				c++;
+
+			if (*c == '.')
+			{
+				c++;
+				if (*c == '*')
+					return -1;
+				while (IsDigit(*c))
+					c++;
+			}
+
+			FormatArgument integerArgument = FormatArgument::Int;
+			bool longDouble = false;
+			switch (*c)
+			{
+			case 'h':
+				c++;
+				if (*c == 'h')
+					c++;
+				break;
+			case 'l':
+				c++;
+				integerArgument = FormatArgument::Long;
+				if (*c == 'l')
+				{
+					c++;
+					integerArgument = FormatArgument::LongLong;
+				}
+				break;
+			case 'z':
+				c++;
+				integerArgument = FormatArgument::Size;
+				break;
+			case 'j':
+				c++;
+				integerArgument = FormatArgument::IntMax;
+				break;
+			case 't':
+				c++;
+				integerArgument = FormatArgument::PtrDiff;
+				break;
+			case 'L':
+				c++;
+				longDouble = true;
+				break;
+			default:
+				break;
+			}
+
+			FormatArgument argument;
+			switch (*c)
+			{
+			case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+				argument = integerArgument;
+				break;
+			case 'c':
+				// Wide characters are not supported.
+				if (integerArgument != FormatArgument::Int)
+					return -1;
+				argument = FormatArgument::Int;
+				break;
+			case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+				argument = longDouble ? FormatArgument::LongDouble : FormatArgument::Double;
+				break;
+			case 's':
+				// Wide strings are not supported.
+				if (integerArgument != FormatArgument::Int)
+					return -1;
+				argument = FormatArgument::String;
+				break;
+			case 'p':
+				argument = FormatArgument::Pointer;
+				break;
+			default:
+				// %n, unknown conversions and a '%' at the end of the format.
+				return -1;
+			}
+
+			if (numSpecs == maxSpecs)
+				return -1;
+
+			FormatSpec& spec = specs[numSpecs++];
+			spec.Argument = argument;
+			spec.Offset = static_cast<u16>(start - format);
+			spec.Length = static_cast<u16>(c - start + 1);
+		}
+
+		return static_cast<i32>(numSpecs);
+	}
+
+	u32 RegisterFormat(eLogLevel level, const char* format, const char* file, u32 line)
+	{
+		Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::Logger);
+
+		std::lock_guard<std::mutex> lock(s_FormatMutex);
+
+		u32 formatID = s_NumFormats.load(std::memory_order_relaxed);
+		if (formatID == FORMATS_PER_CHUNK * MAX_FORMAT_CHUNKS)
+			return INVALID_FORMAT_ID;
+
+		FormatInfo* chunk = s_FormatChunks[formatID / FORMATS_PER_CHUNK].load(std::memory_order_relaxed);
+		if (chunk == nullptr)
+		{
+			void* memory = Memory::Allocate(sizeof(FormatInfo) * FORMATS_PER_CHUNK, Memory::MemoryTag::Logger, alignof(FormatInfo));
+			chunk = new (memory) FormatInfo[FORMATS_PER_CHUNK];
+			s_FormatChunks[formatID / FORMATS_PER_CHUNK].store(chunk, std::memory_order_release);
+		}
+
+		FormatInfo& info = chunk[formatID % FORMATS_PER_CHUNK];
+		info.CallSiteFormat = format;
+		info.Format = CopyString(format);
+		info.File = CopyString(file);
+		info.Line = line;
+		info.Level = level;
+
+		i32 numArguments = ParseFormat(format, info.Arguments, MAX_FORMAT_ARGUMENTS);
+		info.Binary = numArguments >= 0;
+		info.NumArguments = info.Binary ? static_cast<u32>(numArguments) : 0;
+
+		s_NumFormats.store(formatID + 1, std::memory_order_release);
+		return formatID;
+	}
+
+	u32 GetNumFormats()
+	{
+		return s_NumFormats.load(std::memory_order_acquire);
+	}
+
+	const FormatInfo& GetFormatInfo(u32 formatID)
+	{
+		ASSERT_MSG(formatID < GetNumFormats(), "Log format is not registered!");
+
+		FormatInfo* chunk = s_FormatChunks[formatID / FORMATS_PER_CHUNK].load(std::memory_order_acquire);
+		return chunk[formatID % FORMATS_PER_CHUNK];
+	}
+
+	size_t EncodeMessage(const FormatInfo& info, u32 formatID, u64 timestamp, u8* buffer, size_t bufferSize, va_list args)
+	{
+		u8* cursor = buffer;
+		const u8* end = buffer + bufferSize;
+
+		if (!Write(cursor, end, formatID) || !Write(cursor, end, timestamp))
+			return 0;
+
+		for (u32 i = 0; i < info.NumArguments; i++)
+		{
+			bool written = true;
+			switch (info.Arguments[i].Argument)
+			{
+			case FormatArgument::Int:
+				written = Write(cursor, end, static_cast<i64>(va_arg(args, int)));
+				break;
+			case FormatArgument::Long:
+				written = Write(cursor, end, static_cast<i64>(va_arg(args, long)));
+				break;
+			case FormatArgument::LongLong:
+				written = Write(cursor, end, static_cast<i64>(va_arg(args, long long)));
+				break;
+			case FormatArgument::Size:
+				written = Write(cursor, end, static_cast<i64>(va_arg(args, size_t)));
+				break;
+			case FormatArgument::IntMax:
+				written = Write(cursor, end, static_cast<i64>(va_arg(args, intmax_t)));
+				break;
+			case FormatArgument::PtrDiff:
+				written = Write(cursor, end, static_cast<i64>(va_arg(args, ptrdiff_t)));
+				break;
+			case FormatArgument::Double:
+				written = Write(cursor, end, va_arg(args, double));
+				break;
+			case FormatArgument::LongDouble:
+				written = Write(cursor, end, static_cast<f64>(va_arg(args, long double)));
+				break;
+			case FormatArgument::Pointer:
+				written = Write(cursor, end, static_cast<u64>(reinterpret_cast<uintptr_t>(va_arg(args, void*))));
+				break;
+			case FormatArgument::String:
+			{
+				const char* string = va_arg(args, const char*);
+				if (string == nullptr)
+				{
+					string = "(null)";
+				}
+
+				u16 length = 0;
+				while (length < MAX_BINARY_STRING_LENGTH && string[length] != '\0')
+				{
+					length++;
+				}
+
+				written = Write(cursor, end, length) && static_cast<size_t>(end - cursor) >= length;
+				if (written)
+				{
+					memcpy(cursor, string, length);
+					cursor += length;
+				}
+				break;
+			}
+			}
+
+			if (!written)
+				return 0;
+		}
+
+		return static_cast<size_t>(cursor - buffer);
+	}
+
+} }
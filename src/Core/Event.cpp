@@ -1,113 +1,416 @@
 #include "Core/Event.h"
 
 #include "Core/Logger.h"
+#include "Core/Memory.h"
+#include "Core/Asserts.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
-namespace Gecko { namespace Event 
+namespace Gecko { namespace Event
 {
 
 	namespace
+	{
+		// Enough for a frame of posted input and system events, a full queue drops events and counts them.
+		constexpr u32 EVENT_QUEUE_CAPACITY = 256;
+		STATIC_ASSERT((EVENT_QUEUE_CAPACITY & (EVENT_QUEUE_CAPACITY - 1)) == 0, "The event queue capacity must be a power of two.");
+
+		// Payloads are copied in by value, system events take the first sizeof(EventData) bytes.
+		struct QueuedEvent
 		{
-		// TODO: create a system that will block events on systems on a lower level.
-		class Event
+			u32 Code;
+			u32 Size;
+			alignas(std::max_align_t) u8 Payload[MAX_TYPED_EVENT_SIZE];
+		};
+		STATIC_ASSERT(sizeof(EventData) <= MAX_TYPED_EVENT_SIZE, "EventData does not fit in a queued event.");
+
+		// Bounded multi-producer queue, every cell carries a sequence number that tells producers and
+		// the consumer whether the cell is free to write or ready to read, so posting never takes a lock.
+		class EventQueue
 		{
 		public:
-			Event() {};
-			~Event() {};
-
-			void AddListener(EventCallbackInterface* eventCallback)
+			EventQueue()
 			{
-				for (EventCallbackInterface* other : m_EventCallbacks)
+				for (u32 i = 0; i < EVENT_QUEUE_CAPACITY; i++)
 				{
-					if (*eventCallback == *other)
-					{
-						LOG_WARN("Event callback already exist in this event");
-						return;
-					}
+					m_Cells[i].Sequence.store(i, std::memory_order_relaxed);
 				}
-				m_EventCallbacks.push_back(eventCallback);
 			}
 
-			void RemoveListener(EventCallbackInterface* eventCallback)
+			bool Push(const QueuedEvent& queuedEvent)
 			{
-				for (CallbackArray::iterator it = m_EventCallbacks.begin(); it != m_EventCallbacks.end(); it++)
+				u64 position = m_EnqueuePosition.load(std::memory_order_relaxed);
+				for (;;)
 				{
-					if (*eventCallback == *(*it))
+					Cell& cell = m_Cells[position & (EVENT_QUEUE_CAPACITY - 1)];
+					u64 sequence = cell.Sequence.load(std::memory_order_acquire);
+					i64 difference = static_cast<i64>(sequence) - static_cast<i64>(position);
+					if (difference == 0)
+					{
+						if (m_EnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+						{
+							cell.Event.Code = queuedEvent.Code;
+							cell.Event.Size = queuedEvent.Size;
+							memcpy(cell.Event.Payload, queuedEvent.Payload, queuedEvent.Size);
+							cell.Sequence.store(position + 1, std::memory_order_release);
+							return true;
+						}
+					}
+					else if (difference < 0)
 					{
-						m_EventCallbacks.erase(it);
-						return;
+						// The consumer has not caught up with this cell yet, the queue is full.
+						return false;
+					}
+					else
+					{
+						position = m_EnqueuePosition.load(std::memory_order_relaxed);
 					}
 				}
-				LOG_WARN("Event doesn't exist on this event!");
 			}
 
-			void Fire(const EventData& data)
+			// Only the main thread pops.
+			bool Pop(QueuedEvent& outEvent)
 			{
-				for (EventCallbackInterface* eventCallback : m_EventCallbacks)
-				{
-					(*eventCallback)(data);
-				}
+				Cell& cell = m_Cells[m_DequeuePosition & (EVENT_QUEUE_CAPACITY - 1)];
+				if (cell.Sequence.load(std::memory_order_acquire) != m_DequeuePosition + 1)
+					return false;
+
+				outEvent.Code = cell.Event.Code;
+				outEvent.Size = cell.Event.Size;
+				memcpy(outEvent.Payload, cell.Event.Payload, cell.Event.Size);
+				cell.Sequence.store(m_DequeuePosition + EVENT_QUEUE_CAPACITY, std::memory_order_release);
+				m_DequeuePosition++;
+				return true;
 			}
 
 		private:
-			using CallbackArray = std::vector<EventCallbackInterface*>;
-			CallbackArray m_EventCallbacks;
+			struct Cell
+			{
+				std::atomic<u64> Sequence;
+				QueuedEvent Event;
+			};
+
+			Cell m_Cells[EVENT_QUEUE_CAPACITY];
+			alignas(64) std::atomic<u64> m_EnqueuePosition{ 0 };
+			alignas(64) u64 m_DequeuePosition{ 0 };
 		};
 
-		constexpr u32 MAX_MESSAGE_CODES = 16384;
+		struct ListenerSlot
+		{
+			EventDelegate Delegate;
+			u32 Code{ 0 };
+			u32 Generation{ 0 };
+			// Position in the listener list of the code, or the next free slot when this slot is unused.
+			u32 ListIndex{ 0 };
+			bool Used{ false };
+		};
 
 		struct EventSystemState
 		{
-			Event registeredEvents[MAX_MESSAGE_CODES];
+			// Slots are reused through a free list, handles stay valid until their slot is released.
+			std::vector<ListenerSlot> Slots;
+			u32 FirstFreeSlot{ ListenerHandle::INVALID_INDEX };
+
+			// Only codes that ever had a listener get a list.
+			std::unordered_map<u32, u32> CodeToList;
+			std::vector<std::vector<u32>> ListenerLists;
+
+			// Listeners removed while an event is being fired are released once firing is done,
+			// so the list that is being walked does not change under the walk.
+			u32 FireDepth{ 0 };
+			std::vector<u32> PendingRemovals;
+
+			EventQueue Queue;
+			std::atomic<u64> DroppedEvents{ 0 };
+			std::thread::id MainThread;
+			std::vector<u32> CoalescedCodes;
+
+			// Reused every dispatch, it grows to the largest burst once and draining does not allocate after that.
+			struct DispatchEntry
+			{
+				QueuedEvent Event;
+				bool Skip;
+			};
+			std::vector<DispatchEntry> DispatchScratch;
+			std::vector<u32> CoalescedSeen;
+			bool Dispatching{ false };
 		};
 
 		static Scope<EventSystemState> s_State;
+
+		void ReleaseSlot(u32 slotIndex)
+		{
+			ListenerSlot& slot = s_State->Slots[slotIndex];
+			std::vector<u32>& listeners = s_State->ListenerLists[s_State->CodeToList[slot.Code]];
+
+			// Swap the last listener of the code into the gap.
+			u32 movedSlotIndex = listeners.back();
+			listeners[slot.ListIndex] = movedSlotIndex;
+			s_State->Slots[movedSlotIndex].ListIndex = slot.ListIndex;
+			listeners.pop_back();
+
+			slot.Delegate = EventDelegate();
+			slot.Used = false;
+			slot.Generation++;
+			slot.ListIndex = s_State->FirstFreeSlot;
+			s_State->FirstFreeSlot = slotIndex;
+		}
 	}
 
 	bool Init()
 	{
+		Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::Event);
+
 		s_State = CreateScope<EventSystemState>();
+		s_State->MainThread = std::this_thread::get_id();
+		s_State->CoalescedCodes = { SystemEvent::CODE_MOUSE_MOVED, SystemEvent::CODE_RESIZED };
+		s_State->CoalescedSeen.reserve(s_State->CoalescedCodes.size());
 
 		return true;
 	}
 
 	void Shutdown()
 	{
-		s_State.release();
+		s_State.reset();
 	}
 
-	void EventRegister(u32 code, EventCallbackInterface* eventCallback)
+	ListenerHandle EventRegister(u32 code, const EventDelegate& delegate)
 	{
+		Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::Event);
+
 		if (!s_State)
 		{
-			LOG_WARN("Event system not initialized!");
-			return;
+			LOG_CHANNEL_WARN(Event, "Event system not initialized!");
+			return ListenerHandle();
 		}
-		s_State->registeredEvents[code].AddListener(eventCallback);
+
+		u32 slotIndex = s_State->FirstFreeSlot;
+		if (slotIndex != ListenerHandle::INVALID_INDEX)
+		{
+			s_State->FirstFreeSlot = s_State->Slots[slotIndex].ListIndex;
+		}
+		else
+		{
+			slotIndex = static_cast<u32>(s_State->Slots.size());
+			s_State->Slots.emplace_back();
+		}
+
+		std::unordered_map<u32, u32>::iterator it = s_State->CodeToList.find(code);
+		if (it == s_State->CodeToList.end())
+		{
+			it = s_State->CodeToList.emplace(code, static_cast<u32>(s_State->ListenerLists.size())).first;
+			s_State->ListenerLists.emplace_back();
+		}
+		std::vector<u32>& listeners = s_State->ListenerLists[it->second];
+
+		ListenerSlot& slot = s_State->Slots[slotIndex];
+		slot.Delegate = delegate;
+		slot.Code = code;
+		slot.ListIndex = static_cast<u32>(listeners.size());
+		slot.Used = true;
+		listeners.push_back(slotIndex);
+
+		ListenerHandle handle;
+		handle.Index = slotIndex;
+		handle.Generation = slot.Generation;
+		return handle;
 	}
 
-	void EventUnregister(u32 code, EventCallbackInterface* eventCallback)
+	void EventUnregister(ListenerHandle handle)
 	{
 		if (!s_State)
 		{
-			LOG_WARN("Event system not initialized!");
+			LOG_CHANNEL_WARN(Event, "Event system not initialized!");
+			return;
+		}
+
+		if (!handle.IsValid() || handle.Index >= s_State->Slots.size())
+		{
+			LOG_CHANNEL_WARN(Event, "Event doesn't exist on this event!");
+			return;
+		}
+
+		ListenerSlot& slot = s_State->Slots[handle.Index];
+		if (!slot.Used || slot.Generation != handle.Generation || slot.Delegate.Invoke == nullptr)
+		{
+			LOG_CHANNEL_WARN(Event, "Event doesn't exist on this event!");
 			return;
 		}
-		s_State->registeredEvents[code].RemoveListener(eventCallback);
+
+		if (s_State->FireDepth > 0)
+		{
+			// Keeps the slot in its list but stops it from being called.
+			slot.Delegate.Invoke = nullptr;
+			s_State->PendingRemovals.push_back(handle.Index);
+			return;
+		}
+
+		ReleaseSlot(handle.Index);
 	}
 
 	void FireEvent(u32 code, const EventData& data)
+	{
+		EventData SendData = data;
+		SendData.Code = code;
+		FirePayload(code, &SendData);
+	}
+
+	// TODO: create a system that will block events on systems on a lower level.
+	void FirePayload(u32 code, const void* payload)
 	{
 		if (!s_State)
 		{
-			LOG_WARN("Event system not initialized!");
+			LOG_CHANNEL_WARN(Event, "Event system not initialized!");
 			return;
 		}
+
+		std::unordered_map<u32, u32>::const_iterator it = s_State->CodeToList.find(code);
+		if (it == s_State->CodeToList.end())
+			return;
+
+		u32 listIndex = it->second;
+		s_State->FireDepth++;
+		// Indexed on purpose, callbacks may register new listeners which can grow both vectors.
+		for (size_t i = 0; i < s_State->ListenerLists[listIndex].size(); i++)
+		{
+			EventDelegate delegate = s_State->Slots[s_State->ListenerLists[listIndex][i]].Delegate;
+			if (delegate.Invoke != nullptr)
+			{
+				delegate(payload);
+			}
+		}
+		s_State->FireDepth--;
+
+		if (s_State->FireDepth == 0 && !s_State->PendingRemovals.empty())
+		{
+			for (u32 slotIndex : s_State->PendingRemovals)
+			{
+				ReleaseSlot(slotIndex);
+			}
+			s_State->PendingRemovals.clear();
+		}
+	}
+
+	void PostEvent(u32 code, const EventData& data)
+	{
 		EventData SendData = data;
 		SendData.Code = code;
-		s_State->registeredEvents[code].Fire(SendData);
+		PostPayload(code, &SendData, sizeof(EventData));
+	}
+
+	void PostPayload(u32 code, const void* payload, size_t size)
+	{
+		ASSERT_MSG(size <= MAX_TYPED_EVENT_SIZE, "Event payload does not fit in the event queue!");
+
+		if (!s_State)
+		{
+			LOG_CHANNEL_WARN(Event, "Event system not initialized!");
+			return;
+		}
+
+		QueuedEvent queuedEvent;
+		queuedEvent.Code = code;
+		queuedEvent.Size = static_cast<u32>(size);
+		memcpy(queuedEvent.Payload, payload, size);
+
+		if (s_State->Queue.Push(queuedEvent))
+			return;
+
+		// The main thread can make room itself, unless it is already dispatching. Other threads have to drop the event.
+		if (std::this_thread::get_id() == s_State->MainThread && !s_State->Dispatching)
+		{
+			DispatchQueuedEvents();
+			if (s_State->Queue.Push(queuedEvent))
+				return;
+		}
+
+		s_State->DroppedEvents.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void DispatchQueuedEvents()
+	{
+		if (!s_State)
+		{
+			LOG_CHANNEL_WARN(Event, "Event system not initialized!");
+			return;
+		}
+
+		ASSERT_MSG(std::this_thread::get_id() == s_State->MainThread, "Queued events can only be dispatched on the main thread!");
+		ASSERT_MSG(!s_State->Dispatching, "DispatchQueuedEvents called from an event listener!");
+
+		// Take everything out first, events posted by the listeners are fired next time.
+		std::vector<EventSystemState::DispatchEntry>& entries = s_State->DispatchScratch;
+		entries.clear();
+		EventSystemState::DispatchEntry entry;
+		entry.Skip = false;
+		while (entries.size() < EVENT_QUEUE_CAPACITY && s_State->Queue.Pop(entry.Event))
+		{
+			entries.push_back(entry);
+		}
+
+		// Walk backwards so the last event of every coalesced code is the one that is kept.
+		std::vector<u32>& seen = s_State->CoalescedSeen;
+		seen.clear();
+		for (size_t i = entries.size(); i > 0; i--)
+		{
+			u32 code = entries[i - 1].Event.Code;
+			if (std::find(s_State->CoalescedCodes.begin(), s_State->CoalescedCodes.end(), code) == s_State->CoalescedCodes.end())
+				continue;
+
+			if (std::find(seen.begin(), seen.end(), code) != seen.end())
+			{
+				entries[i - 1].Skip = true;
+			}
+			else
+			{
+				seen.push_back(code);
+			}
+		}
+
+		s_State->Dispatching = true;
+		for (const EventSystemState::DispatchEntry& dispatchEntry : entries)
+		{
+			if (!dispatchEntry.Skip)
+			{
+				FirePayload(dispatchEntry.Event.Code, dispatchEntry.Event.Payload);
+			}
+		}
+		s_State->Dispatching = false;
+
+		u64 droppedEvents = s_State->DroppedEvents.exchange(0, std::memory_order_relaxed);
+		if (droppedEvents > 0)
+		{
+			LOG_CHANNEL_WARN(Event, "The event queue was full, %llu posted events were dropped.", static_cast<unsigned long long>(droppedEvents));
+		}
+	}
+
+	void SetEventCoalescing(u32 code, bool coalesce)
+	{
+		Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::Event);
+
+		if (!s_State)
+		{
+			LOG_CHANNEL_WARN(Event, "Event system not initialized!");
+			return;
+		}
+
+		std::vector<u32>& codes = s_State->CoalescedCodes;
+		std::vector<u32>::iterator it = std::find(codes.begin(), codes.end(), code);
+		if (coalesce && it == codes.end())
+		{
+			codes.push_back(code);
+			s_State->CoalescedSeen.reserve(codes.size());
+		}
+		else if (!coalesce && it != codes.end())
+		{
+			codes.erase(it);
+		}
 	}
 
-} }
\ No newline at end of file
+} }
@@ -0,0 +1,297 @@
+#include "Core/FileSystem.h"
+
+#include "Core/PackFile.h"
+#include "Core/Platform.h"
+#include "Core/Logger.h"
+
+#include <string.h>
+
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+
+namespace Gecko { namespace FileSystem
+{
+
+	struct MappedFile
+	{
+		Platform::FileMapping Mapping;
+
+		~MappedFile()
+		{
+			Platform::UnmapFile(Mapping);
+		}
+	};
+
+	namespace
+	{
+		struct PackFileEntry
+		{
+			u64 Offset{ 0 };
+			u64 Size{ 0 };
+		};
+
+		struct Mount
+		{
+			std::string MountPoint;
+			// Native directory with a trailing separator, empty for packs.
+			std::string Directory;
+			Ref<MappedFile> Pack{ nullptr };
+			std::unordered_map<std::string, PackFileEntry> PackFiles;
+		};
+
+		// Mounts change at startup and when content is swapped, lookups only hold the lock while they search the table.
+		static std::mutex s_MountMutex;
+		static std::vector<Ref<Mount>> s_Mounts;
+
+		std::string NormalizePath(const std::string& path)
+		{
+			std::string normalized = path;
+			for (char& c : normalized)
+			{
+				if (c == '\\')
+					c = '/';
+			}
+
+			size_t start = 0;
+			while (start < normalized.size())
+			{
+				if (normalized[start] == '/')
+				{
+					start++;
+				}
+				else if (normalized.compare(start, 2, "./") == 0)
+				{
+					start += 2;
+				}
+				else
+				{
+					break;
+				}
+			}
+			return normalized.substr(start);
+		}
+
+		std::string NormalizeMountPoint(const std::string& mountPoint)
+		{
+			std::string normalized = NormalizePath(mountPoint);
+			if (!normalized.empty() && normalized.back() != '/')
+			{
+				normalized.push_back('/');
+			}
+			return normalized;
+		}
+
+		Ref<MappedFile> MapFile(const std::string& nativePath)
+		{
+			Ref<MappedFile> file = CreateRef<MappedFile>();
+			if (!Platform::MapFile(nativePath, file->Mapping))
+				return nullptr;
+			return file;
+		}
+
+		bool ReadPackTable(const std::string& packPath, const MappedFile& pack, std::unordered_map<std::string, PackFileEntry>& outFiles)
+		{
+			const u8* data = static_cast<const u8*>(pack.Mapping.Data);
+			u64 size = pack.Mapping.Size;
+
+			PackHeader header;
+			if (size < sizeof(PackHeader))
+			{
+				LOG_ERROR("%s is not a pack file.", packPath.c_str());
+				return false;
+			}
+			memcpy(&header, data, sizeof(PackHeader));
+			if (memcmp(header.Magic, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0 || header.Version != PACK_VERSION)
+			{
+				LOG_ERROR("%s is not a pack file of version %u.", packPath.c_str(), PACK_VERSION);
+				return false;
+			}
+
+			u64 tableEnd = sizeof(PackHeader) + static_cast<u64>(header.NumEntries) * sizeof(PackEntry);
+			if (tableEnd > size || header.NamesOffset > size || header.NamesSize > size - header.NamesOffset)
+			{
+				LOG_ERROR("The table of %s is truncated.", packPath.c_str());
+				return false;
+			}
+
+			outFiles.reserve(header.NumEntries);
+			const char* names = reinterpret_cast<const char*>(data + header.NamesOffset);
+			for (u32 i = 0; i < header.NumEntries; i++)
+			{
+				PackEntry entry;
+				memcpy(&entry, data + sizeof(PackHeader) + i * sizeof(PackEntry), sizeof(PackEntry));
+				if (entry.Offset > size || entry.Size > size - entry.Offset
+					|| entry.NameOffset > header.NamesSize || entry.NameLength > header.NamesSize - entry.NameOffset)
+				{
+					LOG_ERROR("Entry %u of %s is out of bounds.", i, packPath.c_str());
+					return false;
+				}
+
+				PackFileEntry& file = outFiles[std::string(names + entry.NameOffset, entry.NameLength)];
+				file.Offset = entry.Offset;
+				file.Size = entry.Size;
+			}
+			return true;
+		}
+
+		void AddMount(Ref<Mount> mount)
+		{
+			std::lock_guard<std::mutex> lock(s_MountMutex);
+			s_Mounts.push_back(mount);
+		}
+
+		// Calls func with the mount and the path relative to it, newest mount first, until func returns true.
+		template<typename Func>
+		bool FindInMounts(const std::string& path, Func func)
+		{
+			std::string normalized = NormalizePath(path);
+
+			// Copy the candidates, mapping a file can take a while and should not block mounting.
+			std::vector<Ref<Mount>> mounts;
+			{
+				std::lock_guard<std::mutex> lock(s_MountMutex);
+				mounts = s_Mounts;
+			}
+
+			for (auto it = mounts.rbegin(); it != mounts.rend(); it++)
+			{
+				const Mount& mount = **it;
+				if (normalized.compare(0, mount.MountPoint.size(), mount.MountPoint) != 0)
+					continue;
+
+				if (func(mount, normalized.substr(mount.MountPoint.size())))
+					return true;
+			}
+			return false;
+		}
+	}
+
+	FileView::FileView(Ref<MappedFile> mapping, const u8* data, u64 size, std::string nativePath)
+		: m_Mapping(mapping), m_Data(data), m_Size(size), m_NativePath(std::move(nativePath))
+	{
+	}
+
+	bool MountDirectory(const std::string& mountPoint, const std::string& directory)
+	{
+		// An empty directory is the current directory, paths are used as they are.
+		std::error_code error;
+		if (!std::filesystem::is_directory(directory.empty() ? std::string(".") : directory, error))
+		{
+			LOG_ERROR("Cannot mount %s, it is not a directory.", directory.c_str());
+			return false;
+		}
+
+		Ref<Mount> mount = CreateRef<Mount>();
+		mount->MountPoint = NormalizeMountPoint(mountPoint);
+		mount->Directory = directory;
+		if (!mount->Directory.empty() && mount->Directory.back() != '/' && mount->Directory.back() != '\\')
+		{
+			mount->Directory.push_back('/');
+		}
+
+		AddMount(mount);
+		return true;
+	}
+
+	bool MountPack(const std::string& mountPoint, const std::string& packPath)
+	{
+		Ref<MappedFile> pack = MapFile(packPath);
+		if (pack == nullptr)
+		{
+			LOG_ERROR("Cannot mount %s, the file could not be mapped.", packPath.c_str());
+			return false;
+		}
+
+		Ref<Mount> mount = CreateRef<Mount>();
+		mount->MountPoint = NormalizeMountPoint(mountPoint);
+		mount->Pack = pack;
+		if (!ReadPackTable(packPath, *pack, mount->PackFiles))
+			return false;
+
+		AddMount(mount);
+		return true;
+	}
+
+	bool Unmount(const std::string& mountPoint)
+	{
+		std::string normalized = NormalizeMountPoint(mountPoint);
+
+		std::lock_guard<std::mutex> lock(s_MountMutex);
+		for (auto it = s_Mounts.rbegin(); it != s_Mounts.rend(); it++)
+		{
+			if ((*it)->MountPoint == normalized)
+			{
+				s_Mounts.erase(std::next(it).base());
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void UnmountAll()
+	{
+		std::lock_guard<std::mutex> lock(s_MountMutex);
+		s_Mounts.clear();
+		s_Mounts.shrink_to_fit();
+	}
+
+	bool Exists(const std::string& path)
+	{
+		return FindInMounts(path, [](const Mount& mount, const std::string& relativePath)
+			{
+				if (mount.Pack != nullptr)
+					return mount.PackFiles.find(relativePath) != mount.PackFiles.end();
+
+				std::error_code error;
+				return std::filesystem::is_regular_file(mount.Directory + relativePath, error);
+			});
+	}
+
+	FileView Open(const std::string& path)
+	{
+		FileView view;
+		FindInMounts(path, [&view](const Mount& mount, const std::string& relativePath)
+			{
+				if (mount.Pack != nullptr)
+				{
+					auto file = mount.PackFiles.find(relativePath);
+					if (file == mount.PackFiles.end())
+						return false;
+
+					const u8* packData = static_cast<const u8*>(mount.Pack->Mapping.Data);
+					view = FileView(mount.Pack, packData + file->second.Offset, file->second.Size, std::string());
+					return true;
+				}
+
+				std::string nativePath = mount.Directory + relativePath;
+				Ref<MappedFile> file = MapFile(nativePath);
+				if (file == nullptr)
+					return false;
+
+				view = FileView(file, static_cast<const u8*>(file->Mapping.Data), file->Mapping.Size, nativePath);
+				return true;
+			});
+		return view;
+	}
+
+	std::string GetNativePath(const std::string& path)
+	{
+		std::string nativePath;
+		FindInMounts(path, [&nativePath](const Mount& mount, const std::string& relativePath)
+			{
+				// A pack that overrides the file hides the loose file as well.
+				if (mount.Pack != nullptr)
+					return mount.PackFiles.find(relativePath) != mount.PackFiles.end();
+
+				std::error_code error;
+				if (!std::filesystem::is_regular_file(mount.Directory + relativePath, error))
+					return false;
+
+				nativePath = mount.Directory + relativePath;
+				return true;
+			});
+		return nativePath;
+	}
+
+} }
@@ -0,0 +1,150 @@
+#include "Core/FramePacer.h"
+
+#include "Core/Platform.h"
+
+#include <algorithm>
+#include <thread>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace Gecko { namespace Time {
+
+	namespace
+	{
+		constexpr f64 OVERSHOOT_AVERAGE_WEIGHT = 1. / 64.;
+		// Each accurate sleep, or frame that only spun, moves the spin margin this fraction of the way back down.
+		constexpr u64 SPIN_MARGIN_DECAY = 16;
+		// The spin margin never grows past this fraction of the frame interval, so there is always time left to sleep.
+		constexpr u64 MAX_SPIN_MARGIN_DIVISOR = 2;
+
+		inline void CpuRelax()
+		{
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+			_mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+			__asm__ __volatile__("yield");
+#else
+			std::this_thread::yield();
+#endif
+		}
+	}
+
+	FramePacer::FramePacer(const FramePacerDesc& desc)
+		: m_Desc(desc)
+	{
+		ResetStats();
+	}
+
+	void FramePacer::SetTargetFrameTime(u64 ticks)
+	{
+		m_Desc.TargetFrameTime = ticks;
+		// Restart the schedule from the next frame instead of waiting out the old interval.
+		m_NextDeadline = m_LastFrameStart + ticks;
+	}
+
+	u64 FramePacer::GetTargetFrameTime() const
+	{
+		return m_Desc.TargetFrameTime;
+	}
+
+	u64 FramePacer::WaitForNextFrame()
+	{
+		u64 now = Platform::GetTicks();
+		if (!m_Started)
+		{
+			m_Started = true;
+			m_LastFrameStart = now;
+			m_NextDeadline = now + m_Desc.TargetFrameTime;
+			return 0;
+		}
+
+		const u64 target = m_Desc.TargetFrameTime;
+		if (target > 0)
+		{
+			const u64 deadline = m_NextDeadline;
+			if (now >= deadline)
+			{
+				// The frame itself took too long. Schedule from now, catching up would run a burst of short frames.
+				m_Stats.NumMissedFrames++;
+				m_NextDeadline = now + target;
+			}
+			else
+			{
+				// Sleeping is cheap but imprecise, sleep until the spin margin and spin the rest of the way.
+				bool didSleep = false;
+				while (deadline - now > m_SpinMargin)
+				{
+					didSleep = true;
+					u64 sleepTime = deadline - now - m_SpinMargin;
+					Platform::SleepFor(sleepTime);
+
+					u64 woke = Platform::GetTicks();
+					u64 slept = woke - now;
+					UpdateSpinMargin(slept > sleepTime ? slept - sleepTime : 0);
+					now = woke;
+					if (now >= deadline)
+						break;
+				}
+
+				// A frame that was short enough to only spin still decays the margin, a margin that stays
+				// above the remaining frame time would otherwise keep the pacer from sleeping at all.
+				if (!didSleep)
+				{
+					UpdateSpinMargin(0);
+				}
+
+				while (now < deadline)
+				{
+					CpuRelax();
+					now = Platform::GetTicks();
+				}
+
+				u64 overshoot = now - deadline;
+				m_Stats.LastOvershoot = overshoot;
+				m_Stats.MaxOvershoot = std::max(m_Stats.MaxOvershoot, overshoot);
+				m_Stats.AverageOvershoot += (static_cast<f64>(overshoot) - m_Stats.AverageOvershoot) * OVERSHOOT_AVERAGE_WEIGHT;
+
+				m_NextDeadline = deadline + target;
+			}
+		}
+
+		u64 frameTime = now - m_LastFrameStart;
+		m_LastFrameStart = now;
+
+		m_Stats.NumFrames++;
+		m_Stats.LastFrameTime = frameTime;
+		m_Stats.SpinMargin = m_SpinMargin;
+		return frameTime;
+	}
+
+	const FramePacerStats& FramePacer::GetStats() const
+	{
+		return m_Stats;
+	}
+
+	void FramePacer::ResetStats()
+	{
+		m_Stats = FramePacerStats();
+		m_SpinMargin = m_Desc.MinSpinMargin;
+		m_Stats.SpinMargin = m_SpinMargin;
+	}
+
+	void FramePacer::UpdateSpinMargin(u64 sleepError)
+	{
+		// Grow at once so the next frame is on time, shrink slowly so a single accurate sleep does not undo it.
+		if (sleepError > m_SpinMargin)
+		{
+			m_SpinMargin = sleepError;
+		}
+		else
+		{
+			m_SpinMargin -= (m_SpinMargin - sleepError) / SPIN_MARGIN_DECAY;
+		}
+
+		u64 maxSpinMargin = m_Desc.TargetFrameTime > 0 ? m_Desc.TargetFrameTime / MAX_SPIN_MARGIN_DIVISOR : m_SpinMargin;
+		m_SpinMargin = std::max(std::min(m_SpinMargin, maxSpinMargin), m_Desc.MinSpinMargin);
+	}
+
+} }
@@ -0,0 +1,301 @@
+#include "Core/FrameTaskGraph.h"
+
+#include "Core/Asserts.h"
+#include "Core/JobSystem.h"
+#include "Core/Logger.h"
+#include "Core/Platform.h"
+#include "Core/Time.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace Gecko
+{
+
+	namespace
+	{
+		constexpr u32 NO_PHASE = 0xFFFFFFFF;
+
+		struct ResourceAccess
+		{
+			u32 LastWriter{ NO_PHASE };
+			// Phases that read the resource since its last write.
+			std::vector<u32> Readers;
+		};
+	}
+
+	FrameResource FrameTaskGraph::AddResource(const std::string& name)
+	{
+		m_Resources.push_back(name);
+		return static_cast<FrameResource>(m_Resources.size() - 1);
+	}
+
+	u32 FrameTaskGraph::AddPhase(const FramePhaseDesc& desc)
+	{
+		ASSERT_MSG(desc.Function, "Frame phase has no function!");
+		for (FrameResource resource : desc.Reads)
+		{
+			ASSERT_MSG(resource < m_Resources.size(), "Frame phase reads an unknown resource!");
+		}
+		for (FrameResource resource : desc.Writes)
+		{
+			ASSERT_MSG(resource < m_Resources.size(), "Frame phase writes an unknown resource!");
+		}
+
+		Phase phase;
+		phase.Desc = desc;
+		m_Phases.push_back(std::move(phase));
+		m_Dirty = true;
+		return static_cast<u32>(m_Phases.size() - 1);
+	}
+
+	void FrameTaskGraph::Build()
+	{
+		std::vector<ResourceAccess> accesses(m_Resources.size());
+		m_MainPhases.clear();
+		m_JobData.clear();
+
+		for (u32 i = 0; i < m_Phases.size(); i++)
+		{
+			Phase& phase = m_Phases[i];
+			phase.Dependencies.clear();
+			phase.Dependents.clear();
+
+			for (FrameResource resource : phase.Desc.Reads)
+			{
+				if (accesses[resource].LastWriter != NO_PHASE)
+				{
+					phase.Dependencies.push_back(accesses[resource].LastWriter);
+				}
+			}
+			for (FrameResource resource : phase.Desc.Writes)
+			{
+				ResourceAccess& access = accesses[resource];
+				if (access.LastWriter != NO_PHASE)
+				{
+					phase.Dependencies.push_back(access.LastWriter);
+				}
+				phase.Dependencies.insert(phase.Dependencies.end(), access.Readers.begin(), access.Readers.end());
+			}
+
+			// Update the accesses after all dependencies are known, a phase that reads and writes a resource does not wait on itself.
+			for (FrameResource resource : phase.Desc.Reads)
+			{
+				accesses[resource].Readers.push_back(i);
+			}
+			for (FrameResource resource : phase.Desc.Writes)
+			{
+				accesses[resource].LastWriter = i;
+				accesses[resource].Readers.clear();
+			}
+
+			std::sort(phase.Dependencies.begin(), phase.Dependencies.end());
+			phase.Dependencies.erase(std::unique(phase.Dependencies.begin(), phase.Dependencies.end()), phase.Dependencies.end());
+			phase.Dependencies.erase(std::remove(phase.Dependencies.begin(), phase.Dependencies.end(), i), phase.Dependencies.end());
+			for (u32 dependency : phase.Dependencies)
+			{
+				m_Phases[dependency].Dependents.push_back(i);
+			}
+
+			if (phase.Desc.Thread == PhaseThread::Main)
+			{
+				m_MainPhases.push_back(i);
+			}
+			m_JobData.push_back({ this, i });
+		}
+
+		m_PendingDependencies = std::vector<std::atomic<u32>>(m_Phases.size());
+		m_MainPhaseDone.assign(m_MainPhases.size(), 0);
+		m_Report.Phases.assign(m_Phases.size(), FramePhaseTiming());
+		m_Report.CriticalPath.reserve(m_Phases.size());
+		m_Dirty = false;
+	}
+
+	void FrameTaskGraph::Execute()
+	{
+		if (m_Dirty)
+		{
+			Build();
+		}
+		if (m_Phases.empty())
+			return;
+
+		m_FrameStart = Platform::GetTicks();
+		for (u32 i = 0; i < m_Phases.size(); i++)
+		{
+			m_PendingDependencies[i].store(static_cast<u32>(m_Phases[i].Dependencies.size()), std::memory_order_relaxed);
+		}
+		std::fill(m_MainPhaseDone.begin(), m_MainPhaseDone.end(), 0);
+		m_NumRemaining.store(static_cast<u32>(m_Phases.size()), std::memory_order_relaxed);
+
+		for (u32 i = 0; i < m_Phases.size(); i++)
+		{
+			if (m_Phases[i].Dependencies.empty() && m_Phases[i].Desc.Thread == PhaseThread::Any)
+			{
+				Jobs::Run(ExecutePhaseJob, &m_JobData[i]);
+			}
+		}
+
+		// Main thread phases run in registration order as soon as they are ready, in between this thread helps the workers.
+		u32 nextMainPhase = 0;
+		while (m_NumRemaining.load(std::memory_order_acquire) > 0)
+		{
+			while (nextMainPhase < m_MainPhases.size() && m_MainPhaseDone[nextMainPhase])
+			{
+				nextMainPhase++;
+			}
+
+			bool ranPhase = false;
+			for (u32 i = nextMainPhase; i < m_MainPhases.size(); i++)
+			{
+				u32 phase = m_MainPhases[i];
+				if (!m_MainPhaseDone[i] && m_PendingDependencies[phase].load(std::memory_order_acquire) == 0)
+				{
+					m_MainPhaseDone[i] = 1;
+					RunPhase(phase);
+					ranPhase = true;
+					break;
+				}
+			}
+
+			if (!ranPhase && !Jobs::RunPendingJob())
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		BuildReport(Platform::GetTicks() - m_FrameStart);
+	}
+
+	void FrameTaskGraph::RunPhase(u32 phaseIndex)
+	{
+		Phase& phase = m_Phases[phaseIndex];
+		FramePhaseTiming& timing = m_Report.Phases[phaseIndex];
+
+		timing.ThreadIndex = Jobs::GetThreadIndex();
+		timing.Start = Platform::GetTicks() - m_FrameStart;
+		phase.Desc.Function();
+		timing.End = Platform::GetTicks() - m_FrameStart;
+
+		for (u32 dependent : phase.Dependents)
+		{
+			// Main thread phases are picked up by Execute once their count reached zero.
+			if (m_PendingDependencies[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1 && m_Phases[dependent].Desc.Thread == PhaseThread::Any)
+			{
+				Jobs::Run(ExecutePhaseJob, &m_JobData[dependent]);
+			}
+		}
+		// Last access to the graph, Execute may return as soon as the count reaches zero.
+		m_NumRemaining.fetch_sub(1, std::memory_order_acq_rel);
+	}
+
+	void FrameTaskGraph::ExecutePhaseJob(void* data)
+	{
+		PhaseJobData* jobData = static_cast<PhaseJobData*>(data);
+		jobData->Graph->RunPhase(jobData->PhaseIndex);
+	}
+
+	void FrameTaskGraph::BuildReport(u64 frameTime)
+	{
+		m_Report.FrameIndex = m_FrameIndex++;
+		m_Report.FrameTime = frameTime;
+		m_Report.CriticalPath.clear();
+
+		u32 last = 0;
+		for (u32 i = 1; i < m_Phases.size(); i++)
+		{
+			if (m_Report.Phases[i].End > m_Report.Phases[last].End)
+			{
+				last = i;
+			}
+		}
+
+		// Walk back from the phase that finished last. What held a phase up is whichever finished last of its dependencies
+		// and the phase that ran right before it on the same thread. Phases that took no measurable time
+		// can look like they blocked each other, the length limit keeps the walk from going in circles.
+		u64 busyTime = 0;
+		u32 current = last;
+		while (current != NO_PHASE && m_Report.CriticalPath.size() < m_Phases.size())
+		{
+			m_Report.CriticalPath.push_back(current);
+			const FramePhaseTiming& timing = m_Report.Phases[current];
+			busyTime += timing.End - timing.Start;
+
+			u32 blocker = NO_PHASE;
+			for (u32 dependency : m_Phases[current].Dependencies)
+			{
+				if (blocker == NO_PHASE || m_Report.Phases[dependency].End > m_Report.Phases[blocker].End)
+				{
+					blocker = dependency;
+				}
+			}
+			for (u32 phase = 0; phase < m_Phases.size(); phase++)
+			{
+				const FramePhaseTiming& threadTiming = m_Report.Phases[phase];
+				if (phase != current && threadTiming.ThreadIndex == timing.ThreadIndex && threadTiming.End <= timing.Start &&
+					(blocker == NO_PHASE || threadTiming.End > m_Report.Phases[blocker].End))
+				{
+					blocker = phase;
+				}
+			}
+			current = blocker;
+		}
+		std::reverse(m_Report.CriticalPath.begin(), m_Report.CriticalPath.end());
+
+		m_Report.CriticalPathIdle = m_Report.Phases[last].End - std::min(m_Report.Phases[last].End, busyTime);
+		m_Report.BoundingPhase = m_Report.CriticalPath.front();
+		for (u32 phase : m_Report.CriticalPath)
+		{
+			const FramePhaseTiming& timing = m_Report.Phases[phase];
+			const FramePhaseTiming& bounding = m_Report.Phases[m_Report.BoundingPhase];
+			if (timing.End - timing.Start > bounding.End - bounding.Start)
+			{
+				m_Report.BoundingPhase = phase;
+			}
+		}
+	}
+
+	u32 FrameTaskGraph::GetPhaseCount() const
+	{
+		return static_cast<u32>(m_Phases.size());
+	}
+
+	const std::string& FrameTaskGraph::GetPhaseName(u32 phase) const
+	{
+		ASSERT_MSG(phase < m_Phases.size(), "Invalid frame phase!");
+		return m_Phases[phase].Desc.Name;
+	}
+
+	const std::vector<u32>& FrameTaskGraph::GetPhaseDependencies(u32 phase) const
+	{
+		ASSERT_MSG(phase < m_Phases.size(), "Invalid frame phase!");
+		ASSERT_MSG(!m_Dirty, "Frame phases changed since the last Execute!");
+		return m_Phases[phase].Dependencies;
+	}
+
+	const FrameTaskReport& FrameTaskGraph::GetLastReport() const
+	{
+		return m_Report;
+	}
+
+	void FrameTaskGraph::LogReport() const
+	{
+		if (m_Report.CriticalPath.empty())
+			return;
+
+		const FramePhaseTiming& bounding = m_Report.Phases[m_Report.BoundingPhase];
+		LOG_INFO("Frame %llu: %.3f ms, bound by %s (%.3f ms), %.3f ms idle on the critical path:",
+			static_cast<unsigned long long>(m_Report.FrameIndex), Time::ToMilliseconds(m_Report.FrameTime),
+			m_Phases[m_Report.BoundingPhase].Desc.Name.c_str(), Time::ToMilliseconds(bounding.End - bounding.Start),
+			Time::ToMilliseconds(m_Report.CriticalPathIdle));
+
+		for (u32 i = 0; i < m_Phases.size(); i++)
+		{
+			const FramePhaseTiming& timing = m_Report.Phases[i];
+			bool critical = std::find(m_Report.CriticalPath.begin(), m_Report.CriticalPath.end(), i) != m_Report.CriticalPath.end();
+			LOG_INFO("  %c %-24s %8.3f ms, %8.3f - %8.3f ms on thread %u", critical ? '*' : ' ', m_Phases[i].Desc.Name.c_str(),
+				Time::ToMilliseconds(timing.End - timing.Start), Time::ToMilliseconds(timing.Start), Time::ToMilliseconds(timing.End), timing.ThreadIndex);
+		}
+	}
+
+}
@@ -0,0 +1,562 @@
+#include "Core/HeapAllocator.h"
+
+#include "Core/Platform.h"
+#include "Core/Asserts.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+#if _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Gecko { namespace Memory {
+
+	namespace
+	{
+		// Size classes: 16 to 128 in steps of 16, after that every power of two is split into 4 classes, up to 16 KiB.
+		constexpr u32 NUM_SMALL_CLASSES = 8;
+		constexpr u32 NUM_SIZE_CLASSES = 36;
+		constexpr size_t MAX_SMALL_SIZE = 16 * 1024;
+		constexpr u32 LARGE_SIZE_CLASS = 0xFFFFFFFF;
+		// Large blocks that live on huge pages.
+		constexpr u32 HUGE_SIZE_CLASS = 0xFFFFFFFE;
+
+		// The span header is padded so the first block starts 64 byte aligned.
+		constexpr size_t SPAN_HEADER_SIZE = 64;
+		constexpr size_t MAX_SMALL_ALIGNMENT = 64;
+
+		constexpr u32 MAX_CACHED_EMPTY_SPANS = 16;
+
+		// Freed large blocks up to this size are kept in a cache bucketed by their number of spans, so blocks that
+		// come and go every frame or grow step by step do not map and unmap pages each time. Each bucket keeps
+		// at most MAX_CACHED_LARGE_BYTES_PER_CLASS, only larger blocks and overflow go back to the OS.
+		constexpr size_t MAX_CACHED_LARGE_SIZE = 1024 * 1024;
+		constexpr u32 NUM_LARGE_CLASSES = static_cast<u32>(MAX_CACHED_LARGE_SIZE / HEAP_SPAN_SIZE);
+		constexpr size_t MAX_CACHED_LARGE_BYTES_PER_CLASS = 1024 * 1024;
+
+		struct FreeBlock
+		{
+			FreeBlock* Next;
+		};
+
+		// Sits at the start of every 64 KiB aligned span, blocks find it by masking their address.
+		struct Span
+		{
+			u32 SizeClass;
+			u32 BlockSize;
+			u32 BlockCount;
+			u32 FreeCount;
+			FreeBlock* FreeList;
+			Span* Next;
+			Span* Prev;
+			size_t PageSize;
+			size_t LargeSize;
+		};
+		STATIC_ASSERT(sizeof(Span) <= SPAN_HEADER_SIZE, "Span header does not fit in its padding.");
+
+		class SpinLock
+		{
+		public:
+			void Lock()
+			{
+				while (m_Flag.test_and_set(std::memory_order_acquire))
+				{
+					std::this_thread::yield();
+				}
+			}
+
+			void Unlock()
+			{
+				m_Flag.clear(std::memory_order_release);
+			}
+
+		private:
+			std::atomic_flag m_Flag = ATOMIC_FLAG_INIT;
+		};
+
+		class ScopedSpinLock
+		{
+		public:
+			explicit ScopedSpinLock(SpinLock& lock) : m_Lock(lock) { m_Lock.Lock(); }
+			~ScopedSpinLock() { m_Lock.Unlock(); }
+
+		private:
+			SpinLock& m_Lock;
+		};
+
+		struct CentralSizeClass
+		{
+			SpinLock Lock;
+			// Spans of this class that still have free blocks.
+			Span* PartialSpans{ nullptr };
+		};
+
+		struct CentralLargeClass
+		{
+			SpinLock Lock;
+			Span* FreeSpans{ nullptr };
+			u32 NumFreeSpans{ 0 };
+		};
+
+		struct CentralHeap
+		{
+			CentralSizeClass SizeClasses[NUM_SIZE_CLASSES];
+
+			SpinLock EmptySpanLock;
+			Span* EmptySpans{ nullptr };
+			u32 NumEmptySpans{ 0 };
+
+			CentralLargeClass LargeClasses[NUM_LARGE_CLASSES];
+		};
+
+		// Constant initialized, operator new can run before any static constructor.
+		static CentralHeap s_Heap;
+
+		struct ThreadCache
+		{
+			FreeBlock* Blocks[NUM_SIZE_CLASSES];
+			u32 Counts[NUM_SIZE_CLASSES];
+			bool Destroyed;
+
+			~ThreadCache();
+		};
+
+		thread_local ThreadCache t_Cache;
+
+		inline u32 FloorLog2(u64 value)
+		{
+#if _MSC_VER
+			unsigned long index;
+			_BitScanReverse64(&index, value);
+			return static_cast<u32>(index);
+#else
+			return 63u - static_cast<u32>(__builtin_clzll(value));
+#endif
+		}
+
+		inline u32 SizeToClass(size_t size)
+		{
+			if (size <= 128)
+				return size == 0 ? 0 : static_cast<u32>((size - 1) >> 4);
+
+			u32 log = FloorLog2(size - 1);
+			size_t base = size_t(1) << log;
+			return NUM_SMALL_CLASSES + (log - 7) * 4 + static_cast<u32>((size - 1 - base) >> (log - 2));
+		}
+
+		inline u32 ClassToSize(u32 sizeClass)
+		{
+			if (sizeClass < NUM_SMALL_CLASSES)
+				return (sizeClass + 1) << 4;
+
+			u32 log = 7 + (sizeClass - NUM_SMALL_CLASSES) / 4;
+			u32 sub = (sizeClass - NUM_SMALL_CLASSES) % 4;
+			return (1u << log) + (sub + 1) * (1u << (log - 2));
+		}
+
+		// Blocks handed between a thread cache and the central heap at once, smaller blocks move in bigger batches.
+		inline u32 BatchSize(u32 sizeClass)
+		{
+			return std::clamp<u32>(static_cast<u32>(16 * 1024 / ClassToSize(sizeClass)), 2u, 64u);
+		}
+
+		inline Span* SpanFromPointer(void* mem)
+		{
+			return reinterpret_cast<Span*>(reinterpret_cast<uintptr_t>(mem) & ~static_cast<uintptr_t>(HEAP_SPAN_SIZE - 1));
+		}
+
+		inline bool IsLargeSpan(const Span* span)
+		{
+			return span->SizeClass == LARGE_SIZE_CLASS || span->SizeClass == HUGE_SIZE_CLASS;
+		}
+
+		inline uintptr_t AlignUp(uintptr_t value, size_t alignment)
+		{
+			return (value + (alignment - 1)) & ~static_cast<uintptr_t>(alignment - 1);
+		}
+
+		void* AllocateSpanPages()
+		{
+			{
+				ScopedSpinLock lock(s_Heap.EmptySpanLock);
+				if (s_Heap.EmptySpans != nullptr)
+				{
+					Span* span = s_Heap.EmptySpans;
+					s_Heap.EmptySpans = span->Next;
+					s_Heap.NumEmptySpans--;
+					return span;
+				}
+			}
+			return Platform::AllocatePages(HEAP_SPAN_SIZE);
+		}
+
+		void FreeSpanPages(Span* span)
+		{
+			{
+				ScopedSpinLock lock(s_Heap.EmptySpanLock);
+				if (s_Heap.NumEmptySpans < MAX_CACHED_EMPTY_SPANS)
+				{
+					span->Next = s_Heap.EmptySpans;
+					s_Heap.EmptySpans = span;
+					s_Heap.NumEmptySpans++;
+					return;
+				}
+			}
+			Platform::FreePages(span, HEAP_SPAN_SIZE);
+		}
+
+		// Must be called with the lock of the size class held.
+		Span* CreateSpan(u32 sizeClass)
+		{
+			Span* span = reinterpret_cast<Span*>(AllocateSpanPages());
+			if (span == nullptr)
+				return nullptr;
+
+			u32 blockSize = ClassToSize(sizeClass);
+			u32 blockCount = static_cast<u32>((HEAP_SPAN_SIZE - SPAN_HEADER_SIZE) / blockSize);
+
+			span->SizeClass = sizeClass;
+			span->BlockSize = blockSize;
+			span->BlockCount = blockCount;
+			span->FreeCount = blockCount;
+			span->Next = nullptr;
+			span->Prev = nullptr;
+			span->PageSize = HEAP_SPAN_SIZE;
+			span->LargeSize = 0;
+
+			// Link the blocks in address order so a fresh span is handed out front to back.
+			u8* blocks = reinterpret_cast<u8*>(span) + SPAN_HEADER_SIZE;
+			FreeBlock* next = nullptr;
+			for (u32 i = blockCount; i > 0; i--)
+			{
+				FreeBlock* block = reinterpret_cast<FreeBlock*>(blocks + static_cast<size_t>(i - 1) * blockSize);
+				block->Next = next;
+				next = block;
+			}
+			span->FreeList = next;
+
+			return span;
+		}
+
+		void LinkPartialSpan(CentralSizeClass& central, Span* span)
+		{
+			span->Prev = nullptr;
+			span->Next = central.PartialSpans;
+			if (central.PartialSpans != nullptr)
+			{
+				central.PartialSpans->Prev = span;
+			}
+			central.PartialSpans = span;
+		}
+
+		void UnlinkPartialSpan(CentralSizeClass& central, Span* span)
+		{
+			if (span->Prev != nullptr)
+			{
+				span->Prev->Next = span->Next;
+			}
+			else
+			{
+				central.PartialSpans = span->Next;
+			}
+			if (span->Next != nullptr)
+			{
+				span->Next->Prev = span->Prev;
+			}
+			span->Next = nullptr;
+			span->Prev = nullptr;
+		}
+
+		// Takes up to count blocks from the central heap and returns how many were taken.
+		u32 FetchFromCentral(u32 sizeClass, u32 count, FreeBlock** outList)
+		{
+			CentralSizeClass& central = s_Heap.SizeClasses[sizeClass];
+			ScopedSpinLock lock(central.Lock);
+
+			FreeBlock* list = nullptr;
+			u32 fetched = 0;
+			while (fetched < count)
+			{
+				Span* span = central.PartialSpans;
+				if (span == nullptr)
+				{
+					span = CreateSpan(sizeClass);
+					if (span == nullptr)
+						break;
+					LinkPartialSpan(central, span);
+				}
+
+				while (fetched < count && span->FreeList != nullptr)
+				{
+					FreeBlock* block = span->FreeList;
+					span->FreeList = block->Next;
+					span->FreeCount--;
+
+					block->Next = list;
+					list = block;
+					fetched++;
+				}
+
+				if (span->FreeCount == 0)
+				{
+					UnlinkPartialSpan(central, span);
+				}
+			}
+
+			*outList = list;
+			return fetched;
+		}
+
+		void ReleaseToCentral(u32 sizeClass, FreeBlock* list)
+		{
+			CentralSizeClass& central = s_Heap.SizeClasses[sizeClass];
+			ScopedSpinLock lock(central.Lock);
+
+			while (list != nullptr)
+			{
+				FreeBlock* block = list;
+				list = list->Next;
+
+				Span* span = SpanFromPointer(block);
+				block->Next = span->FreeList;
+				span->FreeList = block;
+				span->FreeCount++;
+
+				if (span->FreeCount == 1)
+				{
+					LinkPartialSpan(central, span);
+				}
+				else if (span->FreeCount == span->BlockCount)
+				{
+					UnlinkPartialSpan(central, span);
+					FreeSpanPages(span);
+				}
+			}
+		}
+
+		ThreadCache::~ThreadCache()
+		{
+			for (u32 i = 0; i < NUM_SIZE_CLASSES; i++)
+			{
+				ReleaseToCentral(i, Blocks[i]);
+				Blocks[i] = nullptr;
+				Counts[i] = 0;
+			}
+			// Anything this thread frees from now on goes straight to the central heap.
+			Destroyed = true;
+		}
+
+		void* AllocateSmall(u32 sizeClass)
+		{
+			ThreadCache& cache = t_Cache;
+			if (cache.Destroyed)
+			{
+				FreeBlock* block = nullptr;
+				FetchFromCentral(sizeClass, 1, &block);
+				return block;
+			}
+
+			FreeBlock* block = cache.Blocks[sizeClass];
+			if (block == nullptr)
+			{
+				cache.Counts[sizeClass] = FetchFromCentral(sizeClass, BatchSize(sizeClass), &cache.Blocks[sizeClass]);
+				block = cache.Blocks[sizeClass];
+				if (block == nullptr)
+					return nullptr;
+			}
+
+			cache.Blocks[sizeClass] = block->Next;
+			cache.Counts[sizeClass]--;
+			return block;
+		}
+
+		void FreeSmall(Span* span, void* mem)
+		{
+			u32 sizeClass = span->SizeClass;
+			FreeBlock* block = reinterpret_cast<FreeBlock*>(mem);
+
+			ThreadCache& cache = t_Cache;
+			if (cache.Destroyed)
+			{
+				block->Next = nullptr;
+				ReleaseToCentral(sizeClass, block);
+				return;
+			}
+
+			block->Next = cache.Blocks[sizeClass];
+			cache.Blocks[sizeClass] = block;
+			cache.Counts[sizeClass]++;
+
+			// Hand half of the cache back once it grows past two batches.
+			u32 batchSize = BatchSize(sizeClass);
+			if (cache.Counts[sizeClass] > batchSize * 2)
+			{
+				FreeBlock* head = cache.Blocks[sizeClass];
+				FreeBlock* tail = head;
+				for (u32 i = 1; i < batchSize; i++)
+				{
+					tail = tail->Next;
+				}
+				cache.Blocks[sizeClass] = tail->Next;
+				cache.Counts[sizeClass] -= batchSize;
+				tail->Next = nullptr;
+
+				ReleaseToCentral(sizeClass, head);
+			}
+		}
+
+		// Large blocks are whole spans, so the page size is a multiple of the span size and picks the bucket.
+		inline CentralLargeClass* GetLargeClass(size_t pageSize)
+		{
+			if (pageSize > MAX_CACHED_LARGE_SIZE)
+				return nullptr;
+			return &s_Heap.LargeClasses[pageSize / HEAP_SPAN_SIZE - 1];
+		}
+
+		Span* AllocateLargeSpanPages(size_t pageSize)
+		{
+			CentralLargeClass* largeClass = GetLargeClass(pageSize);
+			if (largeClass != nullptr)
+			{
+				ScopedSpinLock lock(largeClass->Lock);
+				if (largeClass->FreeSpans != nullptr)
+				{
+					Span* span = largeClass->FreeSpans;
+					largeClass->FreeSpans = span->Next;
+					largeClass->NumFreeSpans--;
+					return span;
+				}
+			}
+			return reinterpret_cast<Span*>(Platform::AllocatePages(pageSize));
+		}
+
+		void FreeLargeSpanPages(Span* span)
+		{
+			CentralLargeClass* largeClass = GetLargeClass(span->PageSize);
+			if (largeClass != nullptr)
+			{
+				ScopedSpinLock lock(largeClass->Lock);
+				if ((largeClass->NumFreeSpans + 1) * span->PageSize <= MAX_CACHED_LARGE_BYTES_PER_CLASS)
+				{
+					span->Next = largeClass->FreeSpans;
+					largeClass->FreeSpans = span;
+					largeClass->NumFreeSpans++;
+					return;
+				}
+			}
+			Platform::FreePages(span, span->PageSize);
+		}
+
+		void* AllocateLarge(size_t size, size_t alignment)
+		{
+			size_t offset = AlignUp(SPAN_HEADER_SIZE, alignment);
+			size_t pageSize = offset + size;
+			bool useHugePages = pageSize >= HEAP_HUGE_PAGE_THRESHOLD;
+			// The rounded up tail is usable, so growing the block does not have to move it.
+			size_t roundTo = useHugePages ? Platform::GetHugePageSize() : HEAP_SPAN_SIZE;
+			pageSize = (pageSize + roundTo - 1) & ~(roundTo - 1);
+
+			Span* span = useHugePages ? reinterpret_cast<Span*>(Platform::AllocateHugePages(pageSize)) : AllocateLargeSpanPages(pageSize);
+			if (span == nullptr)
+				return nullptr;
+
+			span->SizeClass = useHugePages ? HUGE_SIZE_CLASS : LARGE_SIZE_CLASS;
+			span->BlockSize = 0;
+			span->BlockCount = 1;
+			span->FreeCount = 0;
+			span->FreeList = nullptr;
+			span->Next = nullptr;
+			span->Prev = nullptr;
+			span->PageSize = pageSize;
+			span->LargeSize = pageSize - offset;
+
+			return reinterpret_cast<u8*>(span) + offset;
+		}
+	}
+
+	void* HeapAllocate(size_t size, size_t alignment)
+	{
+		ASSERT_MSG((alignment & (alignment - 1)) == 0, "Alignment must be a power of two!");
+		ASSERT_MSG(alignment < HEAP_SPAN_SIZE, "Alignment must be smaller than the span size!");
+
+		alignment = std::max(alignment, HEAP_DEFAULT_ALIGNMENT);
+
+		if (size <= MAX_SMALL_SIZE && alignment <= MAX_SMALL_ALIGNMENT)
+		{
+			// Every block starts at a multiple of its size from a 64 byte aligned base,
+			// so take the first class whose size is a multiple of the alignment.
+			u32 sizeClass = SizeToClass(std::max(size, alignment));
+			while (ClassToSize(sizeClass) % alignment != 0)
+			{
+				sizeClass++;
+			}
+			return AllocateSmall(sizeClass);
+		}
+
+		return AllocateLarge(size, alignment);
+	}
+
+	void* HeapReallocate(void* mem, size_t size)
+	{
+		if (mem == nullptr)
+			return HeapAllocate(size);
+
+		if (size == 0)
+		{
+			HeapFree(mem);
+			return nullptr;
+		}
+
+		size_t usableSize = HeapUsableSize(mem);
+		if (size <= usableSize && size > usableSize / 2)
+			return mem;
+
+		// Keep at least the alignment the old block was handed out with.
+		Span* span = SpanFromPointer(mem);
+		uintptr_t address = reinterpret_cast<uintptr_t>(mem);
+		size_t alignment = IsLargeSpan(span)
+			? static_cast<size_t>(address - reinterpret_cast<uintptr_t>(span))
+			: std::min<size_t>(address & (~address + 1), MAX_SMALL_ALIGNMENT);
+
+		void* newMem = HeapAllocate(size, alignment);
+		if (newMem == nullptr)
+			return nullptr;
+
+		memcpy(newMem, mem, std::min(size, usableSize));
+		HeapFree(mem);
+		return newMem;
+	}
+
+	void HeapFree(void* mem)
+	{
+		if (mem == nullptr)
+			return;
+
+		Span* span = SpanFromPointer(mem);
+		if (span->SizeClass == HUGE_SIZE_CLASS)
+		{
+			Platform::FreeHugePages(span, span->PageSize);
+			return;
+		}
+		if (span->SizeClass == LARGE_SIZE_CLASS)
+		{
+			FreeLargeSpanPages(span);
+			return;
+		}
+
+		FreeSmall(span, mem);
+	}
+
+	size_t HeapUsableSize(void* mem)
+	{
+		Span* span = SpanFromPointer(mem);
+		if (IsLargeSpan(span))
+			return span->LargeSize;
+
+		return span->BlockSize;
+	}
+
+} }
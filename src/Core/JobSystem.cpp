@@ -0,0 +1,414 @@
+#include "Core/JobSystem.h"
+
+#include "Core/Asserts.h"
+#include "Core/Threading.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace Gecko { namespace Jobs
+{
+
+	namespace
+	{
+		// Per queue, a full queue runs new jobs right away on the thread that queues them.
+		constexpr u32 QUEUE_CAPACITY = 4096;
+		// Rounds through all queues before an idle worker goes to sleep.
+		constexpr u32 IDLE_SPIN_ROUNDS = 64;
+		constexpr u32 EXTERNAL_THREAD_INDEX = 0xFFFFFFFF;
+
+		inline void CpuRelax()
+		{
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+			_mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+			__asm__ __volatile__("yield");
+#endif
+		}
+
+		inline void LockFlag(std::atomic_flag& flag)
+		{
+			while (flag.test_and_set(std::memory_order_acquire))
+			{
+				CpuRelax();
+			}
+		}
+
+		inline void UnlockFlag(std::atomic_flag& flag)
+		{
+			flag.clear(std::memory_order_release);
+		}
+
+		struct QueuedJob
+		{
+			Job Work;
+			JobCounter* Counter;
+		};
+
+		// A ring buffer behind a spin lock. The owner pushes and pops at the back, thieves take from the front,
+		// so they mostly touch different ends and the lock is rarely contended.
+		struct alignas(64) JobQueue
+		{
+			std::atomic_flag Lock = ATOMIC_FLAG_INIT;
+			u32 Front{ 0 };
+			u32 Back{ 0 };
+			// Lets thieves skip empty queues without taking their lock.
+			std::atomic<u32> Size{ 0 };
+			QueuedJob Jobs[QUEUE_CAPACITY];
+
+			bool Push(const QueuedJob& job)
+			{
+				LockFlag(Lock);
+				if (Back - Front == QUEUE_CAPACITY)
+				{
+					UnlockFlag(Lock);
+					return false;
+				}
+				Jobs[Back % QUEUE_CAPACITY] = job;
+				Back++;
+				Size.store(Back - Front, std::memory_order_relaxed);
+				UnlockFlag(Lock);
+				return true;
+			}
+
+			bool PopBack(QueuedJob& outJob)
+			{
+				if (Size.load(std::memory_order_relaxed) == 0)
+					return false;
+
+				LockFlag(Lock);
+				bool found = Back != Front;
+				if (found)
+				{
+					Back--;
+					outJob = Jobs[Back % QUEUE_CAPACITY];
+					Size.store(Back - Front, std::memory_order_relaxed);
+				}
+				UnlockFlag(Lock);
+				return found;
+			}
+
+			bool PopFront(QueuedJob& outJob)
+			{
+				if (Size.load(std::memory_order_relaxed) == 0)
+					return false;
+
+				LockFlag(Lock);
+				bool found = Back != Front;
+				if (found)
+				{
+					outJob = Jobs[Front % QUEUE_CAPACITY];
+					Front++;
+					Size.store(Back - Front, std::memory_order_relaxed);
+				}
+				UnlockFlag(Lock);
+				return found;
+			}
+		};
+
+		struct JobState
+		{
+			u32 NumWorkers{ 0 };
+			// The Init thread, the workers and a shared queue for every other thread, in that order.
+			std::vector<Scope<JobQueue>> Queues;
+			std::vector<std::thread> Workers;
+
+			std::mutex SleepMutex;
+			std::condition_variable SleepCondition;
+			std::atomic<u32> NumSleeping{ 0 };
+			u32 NumWakeups{ 0 };
+			bool Stop{ false };
+		};
+
+		static Scope<JobState> s_State{ nullptr };
+		thread_local u32 t_ThreadIndex = EXTERNAL_THREAD_INDEX;
+		thread_local u32 t_StealState = 0x2545F491u;
+
+		inline u32 GetQueueIndex()
+		{
+			return t_ThreadIndex == EXTERNAL_THREAD_INDEX ? s_State->NumWorkers + 1 : t_ThreadIndex;
+		}
+
+		void WakeWorkers(u32 numJobs)
+		{
+			// Pairs with the increment of NumSleeping before a worker checks the queues one last time.
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			u32 numSleeping = s_State->NumSleeping.load(std::memory_order_relaxed);
+			if (numSleeping == 0)
+				return;
+
+			u32 numWakeups = std::min(numSleeping, numJobs);
+			{
+				std::lock_guard<std::mutex> lock(s_State->SleepMutex);
+				s_State->NumWakeups += numWakeups;
+			}
+			if (numWakeups == 1)
+			{
+				s_State->SleepCondition.notify_one();
+			}
+			else
+			{
+				s_State->SleepCondition.notify_all();
+			}
+		}
+
+		void Execute(const QueuedJob& job);
+
+		void Push(const QueuedJob& job)
+		{
+			if (!s_State->Queues[GetQueueIndex()]->Push(job))
+			{
+				Execute(job);
+			}
+		}
+
+		void FinishJob(JobCounter* counter)
+		{
+			// The lock is held across the last decrement so Wait can tell when this thread let go of the counter.
+			LockFlag(counter->Lock);
+			std::vector<JobCounter::Continuation> continuations;
+			if (counter->Value.fetch_sub(1, std::memory_order_acq_rel) == 1 && !counter->Continuations.empty())
+			{
+				continuations.swap(counter->Continuations);
+			}
+			UnlockFlag(counter->Lock);
+
+			for (const JobCounter::Continuation& continuation : continuations)
+			{
+				Push({ continuation.ContinuationJob, continuation.Counter });
+			}
+			if (!continuations.empty())
+			{
+				WakeWorkers(static_cast<u32>(continuations.size()));
+			}
+		}
+
+		void Execute(const QueuedJob& job)
+		{
+			job.Work.Function(job.Work.Data);
+			if (job.Counter != nullptr)
+			{
+				FinishJob(job.Counter);
+			}
+		}
+
+		// Own queue newest first, then the shared queue, then the oldest job of another thread.
+		bool FindJob(QueuedJob& outJob)
+		{
+			u32 queueIndex = GetQueueIndex();
+			u32 numQueues = static_cast<u32>(s_State->Queues.size());
+			if (s_State->Queues[queueIndex]->PopBack(outJob))
+				return true;
+			if (queueIndex != numQueues - 1 && s_State->Queues[numQueues - 1]->PopFront(outJob))
+				return true;
+
+			// Start at a random victim so thieves do not all line up on the same queue.
+			u32& state = t_StealState;
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			u32 start = state % numQueues;
+			for (u32 i = 0; i < numQueues; i++)
+			{
+				u32 victim = (start + i) % numQueues;
+				if (victim != queueIndex && s_State->Queues[victim]->PopFront(outJob))
+					return true;
+			}
+			return false;
+		}
+
+		bool HasQueuedJobs()
+		{
+			for (const Scope<JobQueue>& queue : s_State->Queues)
+			{
+				if (queue->Size.load(std::memory_order_relaxed) > 0)
+					return true;
+			}
+			return false;
+		}
+
+		void WorkerThread(u32 index)
+		{
+			t_ThreadIndex = index;
+			t_StealState = 0x9E3779B9u * index;
+			Threading::RegisterCurrentThread(Threading::ThreadRole::Worker, index - 1);
+
+			u32 idleRounds = 0;
+			while (true)
+			{
+				QueuedJob job;
+				if (FindJob(job))
+				{
+					Execute(job);
+					idleRounds = 0;
+					continue;
+				}
+
+				if (++idleRounds < IDLE_SPIN_ROUNDS)
+				{
+					CpuRelax();
+					continue;
+				}
+				idleRounds = 0;
+
+				std::unique_lock<std::mutex> lock(s_State->SleepMutex);
+				s_State->NumSleeping.fetch_add(1, std::memory_order_seq_cst);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if (!s_State->Stop && !HasQueuedJobs())
+				{
+					s_State->SleepCondition.wait(lock, []() { return s_State->NumWakeups > 0 || s_State->Stop; });
+					if (s_State->NumWakeups > 0)
+					{
+						s_State->NumWakeups--;
+					}
+				}
+				s_State->NumSleeping.fetch_sub(1, std::memory_order_relaxed);
+
+				if (s_State->Stop)
+					return;
+			}
+		}
+	}
+
+	bool Init(const JobSystemDesc& desc)
+	{
+		ASSERT_MSG(s_State == nullptr, "Job system already initialized!");
+
+		s_State = CreateScope<JobState>();
+		s_State->NumWorkers = desc.NumWorkers > 0 ? desc.NumWorkers : Threading::GetWorkerCount();
+
+		for (u32 i = 0; i < s_State->NumWorkers + 2; i++)
+		{
+			s_State->Queues.push_back(CreateScope<JobQueue>());
+		}
+
+		t_ThreadIndex = 0;
+		t_StealState = 0x9E3779B9u;
+		for (u32 i = 1; i <= s_State->NumWorkers; i++)
+		{
+			s_State->Workers.emplace_back(WorkerThread, i);
+		}
+
+		return true;
+	}
+
+	void Shutdown()
+	{
+		ASSERT_MSG(s_State != nullptr, "Job system not initialized!");
+		ASSERT_MSG(!HasQueuedJobs(), "Jobs are still queued at shutdown!");
+
+		{
+			std::lock_guard<std::mutex> lock(s_State->SleepMutex);
+			s_State->Stop = true;
+		}
+		s_State->SleepCondition.notify_all();
+		for (std::thread& worker : s_State->Workers)
+		{
+			worker.join();
+		}
+
+		t_ThreadIndex = EXTERNAL_THREAD_INDEX;
+		s_State.reset();
+	}
+
+	void Run(JobFunction function, void* data, JobCounter* counter)
+	{
+		Job job;
+		job.Function = function;
+		job.Data = data;
+		Run(&job, 1, counter);
+	}
+
+	void Run(const Job* jobs, u32 numJobs, JobCounter* counter)
+	{
+		ASSERT_MSG(s_State != nullptr, "Job system not initialized!");
+
+		if (counter != nullptr)
+		{
+			counter->Value.fetch_add(numJobs, std::memory_order_relaxed);
+		}
+		for (u32 i = 0; i < numJobs; i++)
+		{
+			Push({ jobs[i], counter });
+		}
+		WakeWorkers(numJobs);
+	}
+
+	void RunAfter(JobCounter& dependency, JobFunction function, void* data, JobCounter* counter)
+	{
+		ASSERT_MSG(s_State != nullptr, "Job system not initialized!");
+
+		Job job;
+		job.Function = function;
+		job.Data = data;
+
+		LockFlag(dependency.Lock);
+		if (dependency.Value.load(std::memory_order_acquire) != 0)
+		{
+			if (counter != nullptr)
+			{
+				counter->Value.fetch_add(1, std::memory_order_relaxed);
+			}
+			dependency.Continuations.push_back({ job, counter });
+			UnlockFlag(dependency.Lock);
+			return;
+		}
+		UnlockFlag(dependency.Lock);
+
+		Run(&job, 1, counter);
+	}
+
+	void Wait(JobCounter& counter)
+	{
+		ASSERT_MSG(s_State != nullptr, "Job system not initialized!");
+
+		while (!counter.IsDone())
+		{
+			QueuedJob job;
+			if (FindJob(job))
+			{
+				Execute(job);
+			}
+			else
+			{
+				CpuRelax();
+			}
+		}
+
+		// The thread that finished the last job may still be inside FinishJob, the counter can only go once it unlocked.
+		LockFlag(counter.Lock);
+		UnlockFlag(counter.Lock);
+	}
+
+	bool RunPendingJob()
+	{
+		ASSERT_MSG(s_State != nullptr, "Job system not initialized!");
+
+		QueuedJob job;
+		if (!FindJob(job))
+			return false;
+
+		Execute(job);
+		return true;
+	}
+
+	u32 GetNumWorkers()
+	{
+		ASSERT_MSG(s_State != nullptr, "Job system not initialized!");
+
+		return s_State->NumWorkers;
+	}
+
+	u32 GetThreadIndex()
+	{
+		ASSERT_MSG(s_State != nullptr, "Job system not initialized!");
+
+		return GetQueueIndex();
+	}
+
+} }
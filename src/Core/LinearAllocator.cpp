@@ -0,0 +1,129 @@
+#include "Core/LinearAllocator.h"
+
+#include "Core/Asserts.h"
+
+#include <algorithm>
+
+namespace Gecko { namespace Memory {
+
+	namespace
+	{
+		constexpr size_t FRAME_ALLOCATOR_BLOCK_SIZE = 1024 * 1024;
+
+		inline uintptr_t AlignUp(uintptr_t value, size_t alignment)
+		{
+			return (value + (alignment - 1)) & ~static_cast<uintptr_t>(alignment - 1);
+		}
+	}
+
+	LinearAllocator::LinearAllocator(size_t blockSize, MemoryTag tag)
+		: m_BlockSize(blockSize)
+		, m_Tag(tag)
+	{
+	}
+
+	LinearAllocator::~LinearAllocator()
+	{
+		Release();
+	}
+
+	void* LinearAllocator::Allocate(size_t size, size_t alignment)
+	{
+		ASSERT_MSG((alignment & (alignment - 1)) == 0, "Alignment must be a power of two!");
+
+		if (size == 0)
+			size = 1;
+
+		for (;;)
+		{
+			if (m_Current != nullptr)
+			{
+				uintptr_t blockStart = reinterpret_cast<uintptr_t>(m_Current + 1);
+				uintptr_t address = AlignUp(blockStart + m_Current->Offset, alignment);
+				size_t newOffset = (address - blockStart) + size;
+
+				if (newOffset <= m_Current->Size)
+				{
+					m_Used += newOffset - m_Current->Offset;
+					m_Peak = std::max(m_Peak, m_Used);
+					m_Current->Offset = newOffset;
+					return reinterpret_cast<void*>(address);
+				}
+
+				// Keep using blocks that are already chained on from a previous reset.
+				if (m_Current->Next != nullptr)
+				{
+					m_Current = m_Current->Next;
+					m_Current->Offset = 0;
+					continue;
+				}
+			}
+
+			Block* block = AllocateBlock(std::max(m_BlockSize, size + alignment));
+			if (m_Current == nullptr)
+			{
+				m_Head = block;
+			}
+			else
+			{
+				m_Current->Next = block;
+			}
+			m_Current = block;
+		}
+	}
+
+	void LinearAllocator::Reset()
+	{
+		// Merge the chain into a single block that can hold everything this frame needed.
+		if (m_Head != nullptr && m_Head->Next != nullptr)
+		{
+			size_t size = m_Capacity;
+			Release();
+			m_Head = AllocateBlock(size);
+		}
+
+		if (m_Head != nullptr)
+		{
+			m_Head->Offset = 0;
+		}
+
+		m_Current = m_Head;
+		m_Used = 0;
+	}
+
+	void LinearAllocator::Release()
+	{
+		Block* block = m_Head;
+		while (block != nullptr)
+		{
+			Block* next = block->Next;
+			Memory::Free(block);
+			block = next;
+		}
+
+		m_Head = nullptr;
+		m_Current = nullptr;
+		m_Used = 0;
+		m_Capacity = 0;
+	}
+
+	LinearAllocator::Block* LinearAllocator::AllocateBlock(size_t size)
+	{
+		Block* block = reinterpret_cast<Block*>(Memory::Allocate(sizeof(Block) + size, m_Tag));
+		ASSERT_MSG(block != nullptr, "LinearAllocator is out of memory!");
+
+		block->Next = nullptr;
+		block->Size = size;
+		block->Offset = 0;
+
+		m_Capacity += size;
+		return block;
+	}
+
+	LinearAllocator& GetFrameAllocator()
+	{
+		static LinearAllocator s_FrameAllocator(FRAME_ALLOCATOR_BLOCK_SIZE, MemoryTag::Frame);
+		return s_FrameAllocator;
+	}
+
+} }
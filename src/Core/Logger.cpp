@@ -1,49 +1,693 @@
 #include "Core/Logger.h"
 
 #include "Core/Asserts.h"
+#include "Core/BinaryLog.h"
 #include "Core/Platform.h"
+#include "Core/Memory.h"
 
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 namespace Gecko { namespace Logger
 {
 
-    bool Init()
+    namespace
+    {
+        constexpr size_t MAX_MESSAGE_SIZE = 32000;
+        // Async messages are formatted on the caller's stack, keep them smaller than the immediate ones.
+        constexpr size_t MAX_ASYNC_MESSAGE_SIZE = 4096;
+        constexpr size_t RECORD_ALIGNMENT = 16;
+        constexpr u32 MIN_THREAD_BUFFER_SIZE = 2 * MAX_ASYNC_MESSAGE_SIZE;
+        // The sink wakes up on its own this often, producers only wake it when their buffer is half full.
+        constexpr std::chrono::milliseconds SINK_INTERVAL{ 10 };
+
+        const char* s_LevelStrings[6] = { "[FATAL]: ", "[ERROR]: ", "[WARN]:  ", "[INFO]:  ", "[DEBUG]: ", "[TRACE]: " };
+        const char* s_LevelNames[6] = { "fatal", "error", "warn", "info", "debug", "trace" };
+        const char* s_ChannelNames[static_cast<u8>(LogChannel::MaxChannels)] = { "General", "Render", "Scene", "GLTF", "DX12", "Event" };
+
+#ifdef DEBUG
+        constexpr eLogLevel DEFAULT_CHANNEL_LEVEL = LOG_LEVEL_TRACE;
+#else
+        constexpr eLogLevel DEFAULT_CHANNEL_LEVEL = LOG_LEVEL_INFO;
+#endif
+
+        enum RecordFlags : u8
+        {
+            RECORD_FLAG_NONE = 0,
+            // Fills the end of the ring when a record does not fit in front of the wrap.
+            RECORD_FLAG_PADDING = 1,
+            // The record holds a binary log Message payload instead of text.
+            RECORD_FLAG_BINARY = 2
+        };
+
+        struct RecordHeader
+        {
+            u64 Sequence;
+            // Size of the header and data, rounded up to RECORD_ALIGNMENT.
+            u32 Size;
+            // Bytes of data, for text this includes the null terminator.
+            u16 Length;
+            u8 Level;
+            u8 Flags;
+        };
+        STATIC_ASSERT(sizeof(RecordHeader) == RECORD_ALIGNMENT, "Log records are expected to start with a 16 byte header.");
+
+        enum class BufferState : u8
+        {
+            Free = 0,
+            Active,
+            // The owning thread exited, the sink frees the buffer once it is drained.
+            Retired
+        };
+
+        // Single producer, single consumer byte ring. Head and Tail only grow, the offset in Data is taken with Mask.
+        struct ThreadBuffer
+        {
+            alignas(64) std::atomic<u64> Head{ 0 };
+            alignas(64) std::atomic<u64> Tail{ 0 };
+            alignas(64) std::atomic<BufferState> State{ BufferState::Free };
+            u8* Data{ nullptr };
+        };
+
+        struct AsyncState
+        {
+            LoggerDesc Desc;
+            u64 Mask{ 0 };
+            ThreadBuffer* Buffers{ nullptr };
+
+            std::atomic<u64> Sequence{ 0 };
+            std::atomic<u64> Dropped{ 0 };
+            u64 ReportedDropped{ 0 };
+
+            std::thread Sink;
+            std::mutex Mutex;
+            std::condition_variable WakeCondition;
+            std::condition_variable FlushCondition;
+            bool Stop{ false };
+            bool WakeRequested{ false };
+            u64 FlushRequested{ 0 };
+            u64 FlushCompleted{ 0 };
+
+            // Serializes the sink with threads that log immediately because they have no buffer.
+            std::mutex ConsoleMutex;
+
+            // Only used by the sink in LogMode::Binary.
+            FILE* BinaryFile{ nullptr };
+            u32 FormatsWritten{ 0 };
+        };
+
+        static AsyncState* s_Async = nullptr;
+        // Bumped on every Init, a thread's cached buffer is only valid for the generation it was acquired in.
+        static std::atomic<u32> s_Generation{ 0 };
+
+        struct ThreadBufferOwner
+        {
+            ThreadBuffer* Buffer{ nullptr };
+            u32 Generation{ 0 };
+            bool NoBuffer{ false };
+            bool IsSink{ false };
+
+            ~ThreadBufferOwner()
+            {
+                if (Buffer != nullptr && Generation == s_Generation.load(std::memory_order_acquire))
+                {
+                    Buffer->State.store(BufferState::Retired, std::memory_order_release);
+                }
+            }
+        };
+
+        thread_local ThreadBufferOwner t_Owner;
+
+        u32 RoundUpToPowerOfTwo(u32 value)
+        {
+            u32 result = 1;
+            while (result < value)
+            {
+                result <<= 1;
+            }
+            return result;
+        }
+
+        ThreadBuffer* GetThreadBuffer()
+        {
+            u32 generation = s_Generation.load(std::memory_order_acquire);
+            if (t_Owner.Generation != generation)
+            {
+                t_Owner.Buffer = nullptr;
+                t_Owner.NoBuffer = false;
+                t_Owner.Generation = generation;
+            }
+
+            if (t_Owner.Buffer != nullptr || t_Owner.NoBuffer || t_Owner.IsSink)
+                return t_Owner.Buffer;
+
+            for (u32 i = 0; i < s_Async->Desc.MaxThreads; i++)
+            {
+                BufferState expected = BufferState::Free;
+                if (s_Async->Buffers[i].State.compare_exchange_strong(expected, BufferState::Active, std::memory_order_acq_rel))
+                {
+                    t_Owner.Buffer = &s_Async->Buffers[i];
+                    return t_Owner.Buffer;
+                }
+            }
+
+            // Every buffer is taken, this thread keeps logging immediately.
+            t_Owner.NoBuffer = true;
+            return nullptr;
+        }
+
+        void WakeSink()
+        {
+            {
+                std::lock_guard<std::mutex> lock(s_Async->Mutex);
+                s_Async->WakeRequested = true;
+            }
+            s_Async->WakeCondition.notify_one();
+        }
+
+        // Returns the next record that is not padding, or nullptr when the buffer is empty. Only called by the sink.
+        RecordHeader* PeekRecord(ThreadBuffer& buffer)
+        {
+            u64 tail = buffer.Tail.load(std::memory_order_relaxed);
+            u64 head = buffer.Head.load(std::memory_order_acquire);
+            while (tail != head)
+            {
+                RecordHeader* record = reinterpret_cast<RecordHeader*>(buffer.Data + (tail & s_Async->Mask));
+                if ((record->Flags & RECORD_FLAG_PADDING) == 0)
+                    return record;
+
+                tail += record->Size;
+                buffer.Tail.store(tail, std::memory_order_release);
+            }
+            return nullptr;
+        }
+
+        void WriteToConsole(char* message, eLogLevel level)
+        {
+            std::lock_guard<std::mutex> lock(s_Async->ConsoleMutex);
+            ConsoleWrite(message, level);
+        }
+
+        template<typename T>
+        void WriteBinary(const T& value)
+        {
+            fwrite(&value, sizeof(T), 1, s_Async->BinaryFile);
+        }
+
+        void WriteBinaryString(const char* string)
+        {
+            u16 length = static_cast<u16>(strlen(string));
+            WriteBinary(length);
+            fwrite(string, 1, length, s_Async->BinaryFile);
+        }
+
+        // Writes the formats registered since the last call, a message's format has to be in the file before the message.
+        void WriteNewFormats()
+        {
+            u32 numFormats = GetNumFormats();
+            for (u32 formatID = s_Async->FormatsWritten; formatID < numFormats; formatID++)
+            {
+                const FormatInfo& info = GetFormatInfo(formatID);
+                WriteBinary(BinaryLogEntry::Format);
+                WriteBinary(formatID);
+                WriteBinary(static_cast<u8>(info.Level));
+                WriteBinary(info.Line);
+                WriteBinaryString(info.File);
+                WriteBinaryString(info.Format);
+            }
+            s_Async->FormatsWritten = numFormats;
+        }
+
+        void WriteRecordToSink(RecordHeader* record)
+        {
+            eLogLevel level = static_cast<eLogLevel>(record->Level);
+            if (s_Async->BinaryFile == nullptr)
+            {
+                WriteToConsole(reinterpret_cast<char*>(record + 1), level);
+                return;
+            }
+
+            if ((record->Flags & RECORD_FLAG_BINARY) != 0)
+            {
+                u32 formatID;
+                memcpy(&formatID, record + 1, sizeof(formatID));
+                if (formatID >= s_Async->FormatsWritten)
+                {
+                    WriteNewFormats();
+                }
+
+                WriteBinary(BinaryLogEntry::Message);
+                WriteBinary(record->Length);
+                fwrite(record + 1, 1, record->Length, s_Async->BinaryFile);
+                return;
+            }
+
+            WriteBinary(BinaryLogEntry::Text);
+            WriteBinary(record->Level);
+            WriteBinary(static_cast<u16>(record->Length - 1));
+            fwrite(record + 1, 1, record->Length - 1, s_Async->BinaryFile);
+
+            if (level <= LOG_LEVEL_ERROR)
+            {
+                WriteToConsole(reinterpret_cast<char*>(record + 1), level);
+            }
+        }
+
+        // Writes the records of all buffers to the console or binary log, in the order they were logged.
+        void DrainBuffers()
+        {
+            while (true)
+            {
+                ThreadBuffer* oldestBuffer = nullptr;
+                RecordHeader* oldestRecord = nullptr;
+                for (u32 i = 0; i < s_Async->Desc.MaxThreads; i++)
+                {
+                    ThreadBuffer& buffer = s_Async->Buffers[i];
+                    if (buffer.State.load(std::memory_order_acquire) == BufferState::Free)
+                        continue;
+
+                    RecordHeader* record = PeekRecord(buffer);
+                    if (record != nullptr && (oldestRecord == nullptr || record->Sequence < oldestRecord->Sequence))
+                    {
+                        oldestBuffer = &buffer;
+                        oldestRecord = record;
+                    }
+                }
+
+                if (oldestRecord == nullptr)
+                    break;
+
+                WriteRecordToSink(oldestRecord);
+                oldestBuffer->Tail.store(oldestBuffer->Tail.load(std::memory_order_relaxed) + oldestRecord->Size, std::memory_order_release);
+            }
+
+            for (u32 i = 0; i < s_Async->Desc.MaxThreads; i++)
+            {
+                ThreadBuffer& buffer = s_Async->Buffers[i];
+                if (buffer.State.load(std::memory_order_acquire) == BufferState::Retired && PeekRecord(buffer) == nullptr)
+                {
+                    buffer.Head.store(0, std::memory_order_relaxed);
+                    buffer.Tail.store(0, std::memory_order_relaxed);
+                    buffer.State.store(BufferState::Free, std::memory_order_release);
+                }
+            }
+
+            u64 dropped = s_Async->Dropped.load(std::memory_order_relaxed);
+            if (dropped != s_Async->ReportedDropped)
+            {
+                char message[128];
+                snprintf(message, sizeof(message), "%s%llu log messages were dropped, the log buffer was full.\n",
+                    s_LevelStrings[LOG_LEVEL_WARN], static_cast<unsigned long long>(dropped - s_Async->ReportedDropped));
+                WriteToConsole(message, LOG_LEVEL_WARN);
+
+                if (s_Async->BinaryFile != nullptr)
+                {
+                    WriteBinary(BinaryLogEntry::Dropped);
+                    WriteBinary(dropped - s_Async->ReportedDropped);
+                }
+                s_Async->ReportedDropped = dropped;
+            }
+
+            if (s_Async->BinaryFile != nullptr)
+            {
+                fflush(s_Async->BinaryFile);
+            }
+        }
+
+        void SinkThread()
+        {
+            Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::Logger);
+            t_Owner.IsSink = true;
+
+            while (true)
+            {
+                u64 flushRequested;
+                bool stop;
+                {
+                    std::unique_lock<std::mutex> lock(s_Async->Mutex);
+                    s_Async->WakeCondition.wait_for(lock, SINK_INTERVAL, []() { return s_Async->WakeRequested || s_Async->Stop; });
+                    s_Async->WakeRequested = false;
+                    flushRequested = s_Async->FlushRequested;
+                    stop = s_Async->Stop;
+                }
+
+                DrainBuffers();
+
+                {
+                    std::lock_guard<std::mutex> lock(s_Async->Mutex);
+                    s_Async->FlushCompleted = flushRequested;
+                }
+                s_Async->FlushCondition.notify_all();
+
+                if (stop)
+                    break;
+            }
+        }
+
+        // Returns false when the record could not be written and has to be logged immediately.
+        bool WriteRecord(eLogLevel level, const void* data, size_t length, u8 flags)
+        {
+            ThreadBuffer* buffer = GetThreadBuffer();
+            if (buffer == nullptr)
+                return false;
+
+            u64 capacity = s_Async->Mask + 1;
+            u32 size = static_cast<u32>((sizeof(RecordHeader) + length + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1));
+
+            u64 head = buffer->Head.load(std::memory_order_relaxed);
+            u64 offset = head & s_Async->Mask;
+            u64 padding = (capacity - offset < size) ? capacity - offset : 0;
+
+            bool block = level == LOG_LEVEL_FATAL || s_Async->Desc.Overflow == OverflowPolicy::Block;
+            while (capacity - (head - buffer->Tail.load(std::memory_order_acquire)) < padding + size)
+            {
+                if (!block)
+                {
+                    s_Async->Dropped.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+                WakeSink();
+                std::this_thread::yield();
+            }
+
+            if (padding > 0)
+            {
+                RecordHeader* paddingRecord = reinterpret_cast<RecordHeader*>(buffer->Data + offset);
+                paddingRecord->Size = static_cast<u32>(padding);
+                paddingRecord->Flags = RECORD_FLAG_PADDING;
+                head += padding;
+                offset = 0;
+            }
+
+            RecordHeader* record = reinterpret_cast<RecordHeader*>(buffer->Data + offset);
+            record->Sequence = s_Async->Sequence.fetch_add(1, std::memory_order_relaxed);
+            record->Size = size;
+            record->Length = static_cast<u16>(length);
+            record->Level = static_cast<u8>(level);
+            record->Flags = flags;
+            memcpy(record + 1, data, length);
+
+            u64 used = head + size - buffer->Tail.load(std::memory_order_relaxed);
+            buffer->Head.store(head + size, std::memory_order_release);
+
+            if (used > capacity / 2)
+            {
+                WakeSink();
+            }
+            return true;
+        }
+
+        // Writes the level prefix and the formatted message followed by a newline, returns the length of the text.
+        size_t FormatLogMessage(char* buffer, size_t bufferSize, eLogLevel level, const char* message, va_list args)
+        {
+            size_t prefixLength = strlen(s_LevelStrings[level]);
+            memcpy(buffer, s_LevelStrings[level], prefixLength);
+
+            // Leave room for the newline.
+            int written = vsnprintf(buffer + prefixLength, bufferSize - prefixLength - 1, message, args);
+            size_t length = prefixLength;
+            if (written > 0)
+            {
+                length += (static_cast<size_t>(written) < bufferSize - prefixLength - 1) ? static_cast<size_t>(written) : bufferSize - prefixLength - 2;
+            }
+
+            buffer[length++] = '\n';
+            buffer[length] = '\0';
+            return length;
+        }
+
+        u64 GetTimestamp()
+        {
+            return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        bool EqualsIgnoreCase(const char* a, const char* b, size_t length)
+        {
+            for (size_t i = 0; i < length; i++)
+            {
+                char lowerA = (a[i] >= 'A' && a[i] <= 'Z') ? static_cast<char>(a[i] - 'A' + 'a') : a[i];
+                char lowerB = (b[i] >= 'A' && b[i] <= 'Z') ? static_cast<char>(b[i] - 'A' + 'a') : b[i];
+                if (lowerA != lowerB || lowerB == '\0')
+                    return false;
+            }
+            return b[length] == '\0';
+        }
+
+        void LogMessage(eLogLevel level, const char* message, va_list args)
+        {
+            if (s_Async != nullptr)
+            {
+                char buffer[MAX_ASYNC_MESSAGE_SIZE];
+                size_t length = FormatLogMessage(buffer, MAX_ASYNC_MESSAGE_SIZE, level, message, args);
+
+                if (!WriteRecord(level, buffer, length + 1, RECORD_FLAG_NONE))
+                {
+                    WriteToConsole(buffer, level);
+                }
+                else if (level == LOG_LEVEL_FATAL)
+                {
+                    // A fatal message is usually followed by a break or a crash, make sure it is on the console first.
+                    Flush();
+                }
+                return;
+            }
+
+            char buffer[MAX_MESSAGE_SIZE];
+            FormatLogMessage(buffer, MAX_MESSAGE_SIZE, level, message, args);
+            ConsoleWrite(buffer, level);
+        }
+    }
+
+    namespace Internal
+    {
+        std::atomic<u8> ChannelLevels[static_cast<u8>(LogChannel::MaxChannels)] = {
+            { DEFAULT_CHANNEL_LEVEL }, { DEFAULT_CHANNEL_LEVEL }, { DEFAULT_CHANNEL_LEVEL },
+            { DEFAULT_CHANNEL_LEVEL }, { DEFAULT_CHANNEL_LEVEL }, { DEFAULT_CHANNEL_LEVEL }
+        };
+        STATIC_ASSERT(static_cast<u8>(LogChannel::MaxChannels) == 6, "Add the default level of the new channel.");
+    }
+
+    void SetChannelLevel(LogChannel channel, eLogLevel level)
+    {
+        Internal::ChannelLevels[static_cast<u8>(channel)].store(static_cast<u8>(level), std::memory_order_relaxed);
+    }
+
+    eLogLevel GetChannelLevel(LogChannel channel)
+    {
+        return static_cast<eLogLevel>(Internal::ChannelLevels[static_cast<u8>(channel)].load(std::memory_order_relaxed));
+    }
+
+    const char* GetChannelName(LogChannel channel)
+    {
+        return s_ChannelNames[static_cast<u8>(channel)];
+    }
+
+    const char* GetLevelName(eLogLevel level)
+    {
+        return s_LevelNames[level];
+    }
+
+    bool ConfigureChannels(const char* config)
+    {
+        bool valid = true;
+        const char* entry = config;
+        while (*entry != '\0')
+        {
+            const char* entryEnd = strchr(entry, ',');
+            if (entryEnd == nullptr)
+            {
+                entryEnd = entry + strlen(entry);
+            }
+
+            const char* separator = static_cast<const char*>(memchr(entry, '=', static_cast<size_t>(entryEnd - entry)));
+            if (separator == nullptr)
+            {
+                valid = false;
+            }
+            else
+            {
+                size_t nameLength = static_cast<size_t>(separator - entry);
+                size_t levelLength = static_cast<size_t>(entryEnd - separator - 1);
+
+                i32 level = -1;
+                for (i32 i = 0; i <= LOG_LEVEL_TRACE; i++)
+                {
+                    if (EqualsIgnoreCase(separator + 1, s_LevelNames[i], levelLength))
+                    {
+                        level = i;
+                    }
+                }
+
+                bool allChannels = nameLength == 1 && entry[0] == '*';
+                bool foundChannel = false;
+                for (u8 i = 0; i < static_cast<u8>(LogChannel::MaxChannels) && level >= 0; i++)
+                {
+                    if (allChannels || EqualsIgnoreCase(entry, s_ChannelNames[i], nameLength))
+                    {
+                        SetChannelLevel(static_cast<LogChannel>(i), static_cast<eLogLevel>(level));
+                        foundChannel = true;
+                    }
+                }
+                valid = valid && foundChannel;
+            }
+
+            entry = (*entryEnd == ',') ? entryEnd + 1 : entryEnd;
+        }
+
+        if (!valid)
+        {
+            LOG_WARN("Log channel config '%s' is invalid, expected a list like 'GLTF=trace,Render=warn'.", config);
+        }
+        return valid;
+    }
+
+    bool Init(const LoggerDesc& desc)
     {
+        const char* channelConfig = getenv("GECKO_LOG_CHANNELS");
+        if (channelConfig != nullptr)
+        {
+            ConfigureChannels(channelConfig);
+        }
+
+        if (desc.Mode == LogMode::Immediate)
+            return true;
+
+        ASSERT_MSG(s_Async == nullptr, "The logger is already initialized!");
+        ASSERT_MSG(desc.MaxThreads > 0, "The async logger needs at least one thread buffer!");
+
+        Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::Logger);
+
+        AsyncState* state = new AsyncState();
+        state->Desc = desc;
+        state->Desc.ThreadBufferSize = RoundUpToPowerOfTwo(desc.ThreadBufferSize < MIN_THREAD_BUFFER_SIZE ? MIN_THREAD_BUFFER_SIZE : desc.ThreadBufferSize);
+        state->Mask = state->Desc.ThreadBufferSize - 1;
+        state->Buffers = new ThreadBuffer[state->Desc.MaxThreads];
+        for (u32 i = 0; i < state->Desc.MaxThreads; i++)
+        {
+            state->Buffers[i].Data = static_cast<u8*>(Memory::Allocate(state->Desc.ThreadBufferSize, Memory::MemoryTag::Logger, RECORD_ALIGNMENT));
+        }
+
+        if (desc.Mode == LogMode::Binary)
+        {
+            state->BinaryFile = fopen(desc.BinaryLogPath, "wb");
+            if (state->BinaryFile != nullptr)
+            {
+                fwrite(BINARY_LOG_MAGIC, 1, sizeof(BINARY_LOG_MAGIC), state->BinaryFile);
+                fwrite(&BINARY_LOG_VERSION, sizeof(BINARY_LOG_VERSION), 1, state->BinaryFile);
+            }
+        }
+
+        s_Async = state;
+        s_Generation.fetch_add(1, std::memory_order_release);
+        s_Async->Sink = std::thread(SinkThread);
+
+        if (desc.Mode == LogMode::Binary && s_Async->BinaryFile == nullptr)
+        {
+            LOG_ERROR("Failed to open binary log %s, logging to the console instead.", desc.BinaryLogPath);
+        }
+
         return true;
     }
 
     void Shutdown()
     {
+        if (s_Async == nullptr)
+            return;
 
+        // Every other thread has to be done logging by now.
+        {
+            std::lock_guard<std::mutex> lock(s_Async->Mutex);
+            s_Async->Stop = true;
+        }
+        s_Async->WakeCondition.notify_one();
+        s_Async->Sink.join();
+
+        AsyncState* state = s_Async;
+        s_Async = nullptr;
+        s_Generation.fetch_add(1, std::memory_order_release);
+
+        if (state->BinaryFile != nullptr)
+        {
+            fclose(state->BinaryFile);
+        }
+
+        for (u32 i = 0; i < state->Desc.MaxThreads; i++)
+        {
+            Memory::Free(state->Buffers[i].Data);
+        }
+        delete[] state->Buffers;
+        delete state;
     }
 
-#ifdef WIN32
-#pragma warning(push)
-#pragma warning(disable: 4840)
-#endif
-    void LogOutput(eLogLevel level, std::string message, ...)
+    void Flush()
     {
-        const char* level_strings[6] = { "[FATAL]: ", "[ERROR]: ", "[WARN]:  ", "[INFO]:  ", "[DEBUG]: ", "[TRACE]: " };
-        message = level_strings[level] + message + "\n";
+        if (s_Async == nullptr || t_Owner.IsSink)
+            return;
 
-        char buffer[32000];
+        std::unique_lock<std::mutex> lock(s_Async->Mutex);
+        u64 flushRequest = ++s_Async->FlushRequested;
+        s_Async->WakeRequested = true;
+        s_Async->WakeCondition.notify_one();
+        s_Async->FlushCondition.wait(lock, [flushRequest]() { return s_Async->FlushCompleted >= flushRequest; });
+    }
+
+    u64 GetDroppedMessageCount()
+    {
+        if (s_Async == nullptr)
+            return 0;
+
+        return s_Async->Dropped.load(std::memory_order_relaxed);
+    }
+
+    void LogOutput(eLogLevel level, const char* message, ...)
+    {
+        Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::Logger);
 
         va_list arg_ptr;
         va_start(arg_ptr, message);
-        vsnprintf(buffer, 32000, message.c_str(), arg_ptr);
+        LogMessage(level, message, arg_ptr);
         va_end(arg_ptr);
+    }
+
+    void LogFormat(u32 formatID, eLogLevel level, const char* message, ...)
+    {
+        Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::Logger);
 
-        ConsoleWrite(buffer, level);
+        // Errors are rare and should show up on the console, they are always formatted.
+        if (s_Async != nullptr && s_Async->BinaryFile != nullptr && level > LOG_LEVEL_ERROR && formatID != INVALID_FORMAT_ID)
+        {
+            const FormatInfo& info = GetFormatInfo(formatID);
+            if (info.Binary && info.CallSiteFormat == message)
+            {
+                u8 buffer[MAX_ASYNC_MESSAGE_SIZE];
+
+                va_list arg_ptr;
+                va_start(arg_ptr, message);
+                size_t length = EncodeMessage(info, formatID, GetTimestamp(), buffer, MAX_ASYNC_MESSAGE_SIZE, arg_ptr);
+                va_end(arg_ptr);
+
+                if (length > 0 && WriteRecord(level, buffer, length, RECORD_FLAG_BINARY))
+                    return;
+            }
+        }
+
+        va_list arg_ptr;
+        va_start(arg_ptr, message);
+        LogMessage(level, message, arg_ptr);
+        va_end(arg_ptr);
     }
-#ifdef WIN32
-#pragma warning(pop)
-#endif
 
     void ReportAssertionFailure(const char* expression, const char* message, const char* file, i32 line)
     {
         LogOutput(LOG_LEVEL_FATAL, "Assertion Failure: %s, message: '%s', in file: %s, line: %d\n", expression, message, file, line);
     }
 
-} }
\ No newline at end of file
+} }
@@ -1,6 +1,14 @@
 #include "Core/Memory.h"
 
-#include "Core/Platform.h"
+#include "Core/AllocationGuard.h"
+#include "Core/Logger.h"
+#include "Core/Asserts.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
 
 #if defined(WIN32)
 #pragma warning( push )
@@ -9,21 +17,61 @@
 
 void* operator new (size_t size)
 {
-	return Gecko::Platform::CustomRealloc(nullptr, size);
+	return Gecko::Memory::Allocate(size, Gecko::Memory::GetCurrentTag());
 }
 
 void operator delete (void* data) throw()
 {
-	Gecko::Platform::CustomFree(data);
+	Gecko::Memory::Free(data);
 }
 
 void* operator new[](std::size_t n)
 {
-	return Gecko::Platform::CustomRealloc(nullptr, n);
+	return Gecko::Memory::Allocate(n, Gecko::Memory::GetCurrentTag());
 }
 void operator delete[](void* p) throw()
 {
-	Gecko::Platform::CustomFree(p);
+	Gecko::Memory::Free(p);
+}
+
+void operator delete (void* data, size_t) throw()
+{
+	Gecko::Memory::Free(data);
+}
+
+void operator delete[](void* p, size_t) throw()
+{
+	Gecko::Memory::Free(p);
+}
+
+void* operator new (size_t size, std::align_val_t alignment)
+{
+	return Gecko::Memory::Allocate(size, Gecko::Memory::GetCurrentTag(), static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+	return Gecko::Memory::Allocate(size, Gecko::Memory::GetCurrentTag(), static_cast<size_t>(alignment));
+}
+
+void operator delete (void* data, std::align_val_t) throw()
+{
+	Gecko::Memory::Free(data);
+}
+
+void operator delete[](void* p, std::align_val_t) throw()
+{
+	Gecko::Memory::Free(p);
+}
+
+void operator delete (void* data, size_t, std::align_val_t) throw()
+{
+	Gecko::Memory::Free(data);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t) throw()
+{
+	Gecko::Memory::Free(p);
 }
 
 #if defined(WIN32)
@@ -32,6 +80,340 @@ void operator delete[](void* p) throw()
 
 namespace Gecko { namespace Memory {
 
+	namespace
+	{
+		constexpr u32 NUM_TAGS = static_cast<u32>(MemoryTag::MaxTags);
+
+		const char* s_TagNames[NUM_TAGS] = {
+			"General",
+			"Scene",
+			"ResourceManager",
+			"GLTFLoader",
+			"Logger",
+			"Event",
+			"Frame",
+		};
+
+		thread_local MemoryTag t_CurrentTag = MemoryTag::General;
+
+#if GECKO_MEMORY_TRACKING
+		// Every tracked allocation is prefixed with this header, it is 16 bytes so the user pointer keeps the default heap alignment.
+		// Over-aligned allocations pad in front of the header, Offset is the distance from the heap block to the user pointer.
+		struct AllocationHeader
+		{
+			u64 Size;
+			u16 Tag;
+			u16 Offset;
+			u32 Magic;
+		};
+		STATIC_ASSERT(sizeof(AllocationHeader) == 16, "Expected AllocationHeader to be 16 bytes.");
+
+		constexpr u32 HEADER_MAGIC = 0x6765636B;
+
+		// Threads only touch the shared counters once their local balance drifts this far,
+		// so the common allocation path never writes to a cache line shared with another thread.
+		constexpr i64 FLUSH_THRESHOLD = 64 * 1024;
+		constexpr u32 MAX_TRACKED_THREADS = 256;
+
+		struct GlobalTagCounters
+		{
+			std::atomic<i64> LiveBytes;
+			std::atomic<i64> LiveAllocations;
+			std::atomic<u64> TotalAllocations;
+			std::atomic<i64> HighWaterMark;
+		};
+
+		// Only written by the owning thread, other threads read them with relaxed loads when gathering stats.
+		struct ThreadTagCounters
+		{
+			std::atomic<i64> PendingBytes;
+			std::atomic<i64> PendingAllocations;
+			std::atomic<u64> PendingTotalAllocations;
+		};
+
+		struct ThreadCounters
+		{
+			ThreadTagCounters Tags[NUM_TAGS];
+			i32 Slot;
+			bool Registered;
+
+			~ThreadCounters();
+		};
+
+		// Zero initialized static storage, usable before any static constructor has run.
+		static GlobalTagCounters s_GlobalCounters[NUM_TAGS];
+		static std::atomic<ThreadCounters*> s_ThreadSlots[MAX_TRACKED_THREADS];
+
+		thread_local ThreadCounters t_Counters;
+
+		void UpdateHighWaterMark(GlobalTagCounters& counters, i64 liveBytes)
+		{
+			i64 highWaterMark = counters.HighWaterMark.load(std::memory_order_relaxed);
+			while (liveBytes > highWaterMark &&
+				!counters.HighWaterMark.compare_exchange_weak(highWaterMark, liveBytes, std::memory_order_relaxed))
+			{
+			}
+		}
+
+		void FlushTag(ThreadCounters& threadCounters, u32 tag)
+		{
+			ThreadTagCounters& pending = threadCounters.Tags[tag];
+			GlobalTagCounters& global = s_GlobalCounters[tag];
+
+			i64 bytes = pending.PendingBytes.exchange(0, std::memory_order_relaxed);
+			i64 allocations = pending.PendingAllocations.exchange(0, std::memory_order_relaxed);
+			u64 totalAllocations = pending.PendingTotalAllocations.exchange(0, std::memory_order_relaxed);
+
+			i64 liveBytes = global.LiveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+			global.LiveAllocations.fetch_add(allocations, std::memory_order_relaxed);
+			global.TotalAllocations.fetch_add(totalAllocations, std::memory_order_relaxed);
+
+			UpdateHighWaterMark(global, liveBytes);
+		}
+
+		void RegisterThread(ThreadCounters& threadCounters)
+		{
+			threadCounters.Registered = true;
+			threadCounters.Slot = -1;
+			for (u32 i = 0; i < MAX_TRACKED_THREADS; i++)
+			{
+				ThreadCounters* expected = nullptr;
+				if (s_ThreadSlots[i].compare_exchange_strong(expected, &threadCounters, std::memory_order_acq_rel))
+				{
+					threadCounters.Slot = static_cast<i32>(i);
+					return;
+				}
+			}
+			// Out of slots, this thread flushes on every allocation instead.
+		}
+
+		ThreadCounters::~ThreadCounters()
+		{
+			for (u32 tag = 0; tag < NUM_TAGS; tag++)
+			{
+				FlushTag(*this, tag);
+			}
+			if (Slot >= 0)
+			{
+				s_ThreadSlots[Slot].store(nullptr, std::memory_order_release);
+				Slot = -1;
+			}
+		}
+
+		void Record(MemoryTag tag, i64 bytes, i64 allocations)
+		{
+			ThreadCounters& threadCounters = t_Counters;
+			if (!threadCounters.Registered)
+			{
+				RegisterThread(threadCounters);
+			}
+
+			u32 tagIndex = static_cast<u32>(tag);
+			ThreadTagCounters& pending = threadCounters.Tags[tagIndex];
+
+			i64 pendingBytes = pending.PendingBytes.load(std::memory_order_relaxed) + bytes;
+			pending.PendingBytes.store(pendingBytes, std::memory_order_relaxed);
+			pending.PendingAllocations.store(pending.PendingAllocations.load(std::memory_order_relaxed) + allocations, std::memory_order_relaxed);
+			if (allocations > 0)
+			{
+				pending.PendingTotalAllocations.store(pending.PendingTotalAllocations.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			}
+
+			if (pendingBytes >= FLUSH_THRESHOLD || pendingBytes <= -FLUSH_THRESHOLD || threadCounters.Slot < 0)
+			{
+				FlushTag(threadCounters, tagIndex);
+			}
+		}
+
+		AllocationHeader* GetHeader(void* mem)
+		{
+			AllocationHeader* header = reinterpret_cast<AllocationHeader*>(reinterpret_cast<u8*>(mem) - sizeof(AllocationHeader));
+			ASSERT_MSG(header->Magic == HEADER_MAGIC, "Freeing memory that was not allocated through Gecko::Memory!");
+			return header;
+		}
+
+		inline void* GetHeapBlock(void* mem, const AllocationHeader* header)
+		{
+			return reinterpret_cast<u8*>(mem) - header->Offset;
+		}
+#endif // GECKO_MEMORY_TRACKING
+	}
+
+	void* Allocate(size_t size, MemoryTag tag, size_t alignment)
+	{
+#if GECKO_MEMORY_TRACKING
+#if GECKO_ALLOCATION_GUARD
+		OnGuardedAllocation(size, tag);
+#endif
+
+		// The header stores the padding in 16 bits, so anything aligned to 64 KiB or more would lose its offset.
+		ASSERT_MSG(alignment <= UINT16_MAX, "Tracked allocations cannot be aligned to 64 KiB or more, use Platform::AllocatePages instead!");
+
+		size_t offset = std::max(alignment, sizeof(AllocationHeader));
+		u8* block = reinterpret_cast<u8*>(HeapAllocate(size + offset, std::max(alignment, HEAP_DEFAULT_ALIGNMENT)));
+		if (block == nullptr)
+			return nullptr;
+
+		u8* mem = block + offset;
+		AllocationHeader* header = reinterpret_cast<AllocationHeader*>(mem - sizeof(AllocationHeader));
+		header->Size = size;
+		header->Tag = static_cast<u16>(tag);
+		header->Offset = static_cast<u16>(offset);
+		header->Magic = HEADER_MAGIC;
+
+		Record(tag, static_cast<i64>(size), 1);
+
+		return mem;
+#else
+		(void)tag;
+		return HeapAllocate(size, alignment);
+#endif
+	}
+
+	void* Reallocate(void* mem, size_t size, MemoryTag tag)
+	{
+#if GECKO_MEMORY_TRACKING
+		if (mem == nullptr)
+			return Allocate(size, tag);
+
+		AllocationHeader* header = GetHeader(mem);
+		MemoryTag oldTag = static_cast<MemoryTag>(header->Tag);
+		i64 oldSize = static_cast<i64>(header->Size);
+
+		if (header->Offset != sizeof(AllocationHeader))
+		{
+			// Over-aligned, the heap cannot grow these in place so move it to a new block with the same alignment.
+			void* newMem = Allocate(size, oldTag, header->Offset);
+			if (newMem == nullptr)
+				return nullptr;
+
+			memcpy(newMem, mem, std::min(size, static_cast<size_t>(oldSize)));
+			Free(mem);
+			return newMem;
+		}
+
+#if GECKO_ALLOCATION_GUARD
+		OnGuardedAllocation(size, oldTag);
+#endif
+
+		u8* newBlock = reinterpret_cast<u8*>(HeapReallocate(GetHeapBlock(mem, header), size + sizeof(AllocationHeader)));
+		if (newBlock == nullptr)
+			return nullptr;
+
+		// The block keeps the tag it was first allocated with.
+		AllocationHeader* newHeader = reinterpret_cast<AllocationHeader*>(newBlock);
+		newHeader->Size = size;
+		Record(oldTag, static_cast<i64>(size) - oldSize, 0);
+
+		return newHeader + 1;
+#else
+		(void)tag;
+		return HeapReallocate(mem, size);
+#endif
+	}
+
+	void Free(void* mem)
+	{
+		if (mem == nullptr)
+			return;
+
+#if GECKO_MEMORY_TRACKING
+		AllocationHeader* header = GetHeader(mem);
+		Record(static_cast<MemoryTag>(header->Tag), -static_cast<i64>(header->Size), -1);
+		header->Magic = 0;
+
+		HeapFree(GetHeapBlock(mem, header));
+#else
+		HeapFree(mem);
+#endif
+	}
+
+	MemoryTag GetCurrentTag()
+	{
+		return t_CurrentTag;
+	}
+
+	const char* GetTagName(MemoryTag tag)
+	{
+		if (tag >= MemoryTag::MaxTags)
+			return "Unknown";
+
+		return s_TagNames[static_cast<u32>(tag)];
+	}
+
+	MemoryTagStats GetTagStats(MemoryTag tag)
+	{
+		MemoryTagStats stats;
+#if GECKO_MEMORY_TRACKING
+		if (tag >= MemoryTag::MaxTags)
+			return stats;
+
+		u32 tagIndex = static_cast<u32>(tag);
+		GlobalTagCounters& global = s_GlobalCounters[tagIndex];
+
+		i64 liveBytes = global.LiveBytes.load(std::memory_order_relaxed);
+		i64 liveAllocations = global.LiveAllocations.load(std::memory_order_relaxed);
+		u64 totalAllocations = global.TotalAllocations.load(std::memory_order_relaxed);
+
+		// Add the balances that threads have not flushed yet.
+		for (u32 i = 0; i < MAX_TRACKED_THREADS; i++)
+		{
+			ThreadCounters* threadCounters = s_ThreadSlots[i].load(std::memory_order_acquire);
+			if (threadCounters == nullptr)
+				continue;
+
+			const ThreadTagCounters& pending = threadCounters->Tags[tagIndex];
+			liveBytes += pending.PendingBytes.load(std::memory_order_relaxed);
+			liveAllocations += pending.PendingAllocations.load(std::memory_order_relaxed);
+			totalAllocations += pending.PendingTotalAllocations.load(std::memory_order_relaxed);
+		}
+
+		UpdateHighWaterMark(global, liveBytes);
+
+		stats.LiveBytes = static_cast<u64>(std::max<i64>(liveBytes, 0));
+		stats.LiveAllocations = static_cast<u64>(std::max<i64>(liveAllocations, 0));
+		stats.TotalAllocations = totalAllocations;
+		stats.HighWaterMark = static_cast<u64>(global.HighWaterMark.load(std::memory_order_relaxed));
+#else
+		(void)tag;
+#endif
+		return stats;
+	}
+
+	void LogMemoryUsage()
+	{
+#if GECKO_MEMORY_TRACKING
+		// Gather everything first, logging allocates itself.
+		MemoryTagStats stats[NUM_TAGS];
+		for (u32 i = 0; i < NUM_TAGS; i++)
+		{
+			stats[i] = GetTagStats(static_cast<MemoryTag>(i));
+		}
+
+		LOG_INFO("Memory usage per tag:");
+		for (u32 i = 0; i < NUM_TAGS; i++)
+		{
+			LOG_INFO("  %-16s live: %10.2f KiB in %8llu allocations, peak: %10.2f KiB, total allocations: %llu",
+				s_TagNames[i],
+				static_cast<f64>(stats[i].LiveBytes) / 1024.,
+				static_cast<unsigned long long>(stats[i].LiveAllocations),
+				static_cast<f64>(stats[i].HighWaterMark) / 1024.,
+				static_cast<unsigned long long>(stats[i].TotalAllocations));
+		}
+#else
+		LOG_INFO("Memory tracking is disabled in this build.");
+#endif
+	}
+
+	ScopedMemoryTag::ScopedMemoryTag(MemoryTag tag)
+		: m_PreviousTag(t_CurrentTag)
+	{
+		t_CurrentTag = tag;
+	}
 
+	ScopedMemoryTag::~ScopedMemoryTag()
+	{
+		t_CurrentTag = m_PreviousTag;
+	}
 
-} }
\ No newline at end of file
+} }
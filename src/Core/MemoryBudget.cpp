@@ -0,0 +1,147 @@
+#include "Core/MemoryBudget.h"
+
+#include "Core/Memory.h"
+#include "Core/Event.h"
+#include "Core/Logger.h"
+#include "Core/Asserts.h"
+
+namespace Gecko { namespace Memory {
+
+	namespace
+	{
+		MemoryPressure CalculatePressure(const BudgetLimits& limits, u64 usage)
+		{
+			if (limits.HardLimit != 0 && usage >= limits.HardLimit)
+				return MemoryPressure::Hard;
+			if (limits.SoftLimit != 0 && usage >= limits.SoftLimit)
+				return MemoryPressure::Soft;
+			return MemoryPressure::None;
+		}
+
+		u64 GetTrackedCPUUsage()
+		{
+			u64 usage = 0;
+			for (u32 i = 0; i < static_cast<u32>(MemoryTag::MaxTags); i++)
+			{
+				usage += GetTagStats(static_cast<MemoryTag>(i)).LiveBytes;
+			}
+			return usage;
+		}
+	}
+
+	void MemoryBudget::SetLimits(BudgetType type, const BudgetLimits& limits)
+	{
+		ASSERT_MSG(limits.HardLimit == 0 || limits.SoftLimit <= limits.HardLimit, "The soft limit of a memory budget must not be above its hard limit!");
+
+		m_Limits[static_cast<u32>(type)] = limits;
+		Update();
+	}
+
+	const BudgetLimits& MemoryBudget::GetLimits(BudgetType type) const
+	{
+		return m_Limits[static_cast<u32>(type)];
+	}
+
+	void MemoryBudget::TrackGPU(GPUResourceCategory category, i64 bytes)
+	{
+		u64& categoryUsage = m_GPUUsage[static_cast<u32>(category)];
+		u64& gpuUsage = m_Usage[static_cast<u32>(BudgetType::GPU)];
+
+		ASSERT_MSG(bytes >= 0 || static_cast<u64>(-bytes) <= categoryUsage, "Releasing more GPU memory than was tracked!");
+
+		categoryUsage = static_cast<u64>(static_cast<i64>(categoryUsage) + bytes);
+		gpuUsage = static_cast<u64>(static_cast<i64>(gpuUsage) + bytes);
+
+		Update();
+	}
+
+	void MemoryBudget::Reset()
+	{
+		for (u32 i = 0; i < NUM_GPU_CATEGORIES; i++)
+		{
+			m_GPUUsage[i] = 0;
+		}
+		m_Usage[static_cast<u32>(BudgetType::GPU)] = 0;
+
+		Update();
+	}
+
+	void MemoryBudget::Update()
+	{
+		m_Usage[static_cast<u32>(BudgetType::CPU)] = GetTrackedCPUUsage();
+
+		for (u32 i = 0; i < NUM_BUDGET_TYPES; i++)
+		{
+			MemoryPressure pressure = CalculatePressure(m_Limits[i], m_Usage[i]);
+			if (pressure == m_Pressure[i])
+				continue;
+
+			m_Pressure[i] = pressure;
+
+			BudgetType type = static_cast<BudgetType>(i);
+			if (pressure == MemoryPressure::None)
+			{
+				LOG_INFO("%s memory pressure relieved, %.2f MiB in use", GetBudgetTypeName(type), static_cast<f64>(m_Usage[i]) / (1024. * 1024.));
+			}
+			else
+			{
+				LOG_WARN("%s memory pressure is %s, %.2f MiB in use", GetBudgetTypeName(type), GetPressureName(pressure), static_cast<f64>(m_Usage[i]) / (1024. * 1024.));
+			}
+
+			Event::EventData data;
+			data.Code = Event::SystemEvent::CODE_MEMORY_PRESSURE;
+			data.Sender = this;
+			data.Data.u32[0] = static_cast<u32>(type);
+			data.Data.u32[1] = static_cast<u32>(pressure);
+			data.Data.u64[1] = m_Usage[i];
+			Event::PostEvent(Event::SystemEvent::CODE_MEMORY_PRESSURE, data);
+		}
+	}
+
+	u64 MemoryBudget::GetUsage(BudgetType type) const
+	{
+		return m_Usage[static_cast<u32>(type)];
+	}
+
+	u64 MemoryBudget::GetGPUUsage(GPUResourceCategory category) const
+	{
+		return m_GPUUsage[static_cast<u32>(category)];
+	}
+
+	MemoryPressure MemoryBudget::GetPressure(BudgetType type) const
+	{
+		return m_Pressure[static_cast<u32>(type)];
+	}
+
+	bool MemoryBudget::CanAllocate(BudgetType type, u64 bytes) const
+	{
+		const BudgetLimits& limits = m_Limits[static_cast<u32>(type)];
+		if (limits.HardLimit == 0)
+			return true;
+
+		return m_Usage[static_cast<u32>(type)] + bytes <= limits.HardLimit;
+	}
+
+	const char* MemoryBudget::GetBudgetTypeName(BudgetType type)
+	{
+		switch (type)
+		{
+		case BudgetType::CPU: return "CPU";
+		case BudgetType::GPU: return "GPU";
+		case BudgetType::MaxTypes: break;
+		}
+		return "Unknown";
+	}
+
+	const char* MemoryBudget::GetPressureName(MemoryPressure pressure)
+	{
+		switch (pressure)
+		{
+		case MemoryPressure::None: return "None";
+		case MemoryPressure::Soft: return "Soft";
+		case MemoryPressure::Hard: return "Hard";
+		}
+		return "Unknown";
+	}
+
+} }
@@ -0,0 +1,151 @@
+#include "Core/Threading.h"
+
+#include "Core/Asserts.h"
+#include "Core/Logger.h"
+#include "Core/Platform.h"
+
+#include <mutex>
+
+namespace Gecko { namespace Threading
+{
+
+	namespace
+	{
+		constexpr u32 NUM_ROLES = static_cast<u32>(ThreadRole::MaxRoles);
+
+		// No Init, threads of other systems register before and after the application sets up its layout.
+		struct ThreadingState
+		{
+			std::mutex Mutex;
+			std::vector<u32> RoleCores[NUM_ROLES];
+		};
+
+		static ThreadingState s_State;
+	}
+
+	const char* GetRoleName(ThreadRole role)
+	{
+		switch (role)
+		{
+		case ThreadRole::Main:
+			return "Main";
+		case ThreadRole::Render:
+			return "Render";
+		case ThreadRole::Worker:
+			return "Worker";
+		case ThreadRole::IO:
+			return "IO";
+		default:
+			ASSERT_MSG(false, "Unknown thread role!");
+			return "Unknown";
+		}
+	}
+
+	void SetRoleCores(ThreadRole role, const std::vector<u32>& logicalCores)
+	{
+		ASSERT_MSG(role < ThreadRole::MaxRoles, "Unknown thread role!");
+
+		std::lock_guard<std::mutex> lock(s_State.Mutex);
+		s_State.RoleCores[static_cast<u32>(role)] = logicalCores;
+	}
+
+	std::vector<u32> GetRoleCores(ThreadRole role)
+	{
+		ASSERT_MSG(role < ThreadRole::MaxRoles, "Unknown thread role!");
+
+		std::lock_guard<std::mutex> lock(s_State.Mutex);
+		return s_State.RoleCores[static_cast<u32>(role)];
+	}
+
+	void UseDefaultLayout()
+	{
+		const Platform::CPUTopology& topology = Platform::GetCPUTopology();
+		const u32 node = topology.LogicalCores.front().NUMANode;
+
+		// Logical cores of every physical core on the node, in the order the OS numbers them.
+		std::vector<std::vector<u32>> physicalCores(topology.NumPhysicalCores);
+		for (const Platform::LogicalCore& core : topology.LogicalCores)
+		{
+			if (core.NUMANode == node)
+			{
+				physicalCores[core.PhysicalCore].push_back(core.Index);
+			}
+		}
+		std::vector<std::vector<u32>> nodeCores;
+		for (std::vector<u32>& cores : physicalCores)
+		{
+			if (!cores.empty())
+			{
+				nodeCores.push_back(std::move(cores));
+			}
+		}
+
+		std::vector<u32> mainCores = { nodeCores[0][0] };
+		std::vector<u32> renderCores = { nodeCores.size() > 1 ? nodeCores[1][0] : nodeCores[0][0] };
+
+		// IO threads mostly wait on the disk, the siblings of the main and render cores are enough for them.
+		std::vector<u32> ioCores;
+		for (u32 i = 0; i < nodeCores.size() && i < 2; i++)
+		{
+			ioCores.insert(ioCores.end(), nodeCores[i].begin() + 1, nodeCores[i].end());
+		}
+		if (ioCores.empty())
+		{
+			ioCores = mainCores;
+			if (renderCores != mainCores)
+			{
+				ioCores.push_back(renderCores[0]);
+			}
+		}
+
+		// Siblings are left out, two workers on one physical core fight over its caches.
+		std::vector<u32> workerCores;
+		for (u32 i = 2; i < nodeCores.size(); i++)
+		{
+			workerCores.push_back(nodeCores[i][0]);
+		}
+		if (workerCores.empty())
+		{
+			for (const std::vector<u32>& cores : nodeCores)
+			{
+				workerCores.insert(workerCores.end(), cores.begin(), cores.end());
+			}
+		}
+
+		SetRoleCores(ThreadRole::Main, mainCores);
+		SetRoleCores(ThreadRole::Render, renderCores);
+		SetRoleCores(ThreadRole::Worker, workerCores);
+		SetRoleCores(ThreadRole::IO, ioCores);
+
+		LOG_INFO("CPU: %u logical cores, %u physical cores, %u packages, %u NUMA nodes. Using NUMA node %u with %u workers.",
+			topology.NumLogicalCores, topology.NumPhysicalCores, topology.NumPackages, topology.NumNUMANodes, node, static_cast<u32>(workerCores.size()));
+	}
+
+	void RegisterCurrentThread(ThreadRole role, u32 index)
+	{
+		std::vector<u32> cores = GetRoleCores(role);
+
+		std::string name = std::string("Gecko ") + GetRoleName(role);
+		if (role == ThreadRole::Worker || role == ThreadRole::IO)
+		{
+			name += " " + std::to_string(index);
+			if (!cores.empty())
+			{
+				cores = { cores[index % cores.size()] };
+			}
+		}
+		Platform::SetCurrentThreadName(name);
+
+		if (!cores.empty() && !Platform::SetCurrentThreadAffinity(cores))
+		{
+			LOG_WARN("Could not pin thread %s to its cores.", name.c_str());
+		}
+	}
+
+	u32 GetWorkerCount()
+	{
+		u32 numWorkerCores = static_cast<u32>(GetRoleCores(ThreadRole::Worker).size());
+		return numWorkerCores > 0 ? numWorkerCores : Platform::GetCPUTopology().NumPhysicalCores;
+	}
+
+} }
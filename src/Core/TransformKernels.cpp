@@ -0,0 +1,640 @@
+#include "Core/TransformKernels.h"
+
+#include <cmath>
+
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#define GECKO_KERNELS_AVX2
+#include <immintrin.h>
+#elif defined(__SSE4_1__) || (defined(_MSC_VER) && defined(__AVX__))
+#define GECKO_KERNELS_SSE4
+#include <smmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define GECKO_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Gecko { namespace Math
+{
+
+	namespace
+	{
+		// The same kernels are written once against FloatN, a register of LANES floats, with one transform per lane.
+		// Matrices are moved in and out of that layout with 4x4 transposes.
+
+#if defined(GECKO_KERNELS_AVX2)
+
+		constexpr u32 LANES = 8;
+		constexpr const char* INSTRUCTION_SET = "AVX2";
+
+		struct FloatN { __m256 V; };
+
+		inline FloatN Load(const f32* p) { return { _mm256_loadu_ps(p) }; }
+		inline FloatN Set(f32 s) { return { _mm256_set1_ps(s) }; }
+		inline FloatN operator+(FloatN a, FloatN b) { return { _mm256_add_ps(a.V, b.V) }; }
+		inline FloatN operator-(FloatN a, FloatN b) { return { _mm256_sub_ps(a.V, b.V) }; }
+		inline FloatN operator*(FloatN a, FloatN b) { return { _mm256_mul_ps(a.V, b.V) }; }
+		inline FloatN operator/(FloatN a, FloatN b) { return { _mm256_div_ps(a.V, b.V) }; }
+		inline FloatN MulAdd(FloatN a, FloatN b, FloatN c) { return { _mm256_fmadd_ps(a.V, b.V, c.V) }; }
+		inline FloatN Floor(FloatN a) { return { _mm256_floor_ps(a.V) }; }
+		inline FloatN Round(FloatN a) { return { _mm256_round_ps(a.V, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC) }; }
+		// All bits set in the lanes where a != b.
+		inline FloatN NotEqual(FloatN a, FloatN b) { return { _mm256_cmp_ps(a.V, b.V, _CMP_NEQ_OQ) }; }
+		// mask ? a : b
+		inline FloatN Select(FloatN mask, FloatN a, FloatN b) { return { _mm256_blendv_ps(b.V, a.V, mask.V) }; }
+		inline FloatN Abs(FloatN a) { return { _mm256_andnot_ps(_mm256_set1_ps(-0.f), a.V) }; }
+		inline FloatN Min(FloatN a, FloatN b) { return { _mm256_min_ps(a.V, b.V) }; }
+		inline FloatN Less(FloatN a, FloatN b) { return { _mm256_cmp_ps(a.V, b.V, _CMP_LT_OQ) }; }
+		// Bit i set when lane i of the mask is.
+		inline u32 MaskBits(FloatN mask) { return static_cast<u32>(_mm256_movemask_ps(mask.V)); }
+
+		// Unpacks and shuffles transpose the 4x4 blocks in both 128 bit halves at once.
+		inline void Transpose4x2(__m256& a0, __m256& a1, __m256& a2, __m256& a3)
+		{
+			__m256 t0 = _mm256_unpacklo_ps(a0, a1);
+			__m256 t1 = _mm256_unpackhi_ps(a0, a1);
+			__m256 t2 = _mm256_unpacklo_ps(a2, a3);
+			__m256 t3 = _mm256_unpackhi_ps(a2, a3);
+			a0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+			a1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+			a2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+			a3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+		}
+
+		// m[column * 4 + row] holds that element of LANES matrices.
+		inline void LoadMatrices(const glm::mat4* in, FloatN m[16])
+		{
+			for (u32 column = 0; column < 4; column++)
+			{
+				__m256 a[4];
+				for (u32 i = 0; i < 4; i++)
+				{
+					a[i] = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(&in[i][column][0])), _mm_loadu_ps(&in[i + 4][column][0]), 1);
+				}
+				Transpose4x2(a[0], a[1], a[2], a[3]);
+				for (u32 row = 0; row < 4; row++)
+				{
+					m[column * 4 + row].V = a[row];
+				}
+			}
+		}
+
+		inline void StoreMatrices(const FloatN m[16], glm::mat4* out)
+		{
+			for (u32 column = 0; column < 4; column++)
+			{
+				__m256 a[4] = { m[column * 4].V, m[column * 4 + 1].V, m[column * 4 + 2].V, m[column * 4 + 3].V };
+				Transpose4x2(a[0], a[1], a[2], a[3]);
+				for (u32 i = 0; i < 4; i++)
+				{
+					_mm_storeu_ps(&out[i][column][0], _mm256_castps256_ps128(a[i]));
+					_mm_storeu_ps(&out[i + 4][column][0], _mm256_extractf128_ps(a[i], 1));
+				}
+			}
+		}
+
+		// Two output columns per register, the columns of a are repeated in both halves.
+		inline void Multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out)
+		{
+			__m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[0][0]));
+			__m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[1][0]));
+			__m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[2][0]));
+			__m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[3][0]));
+			__m256 b01 = _mm256_loadu_ps(&b[0][0]);
+			__m256 b23 = _mm256_loadu_ps(&b[2][0]);
+
+			__m256 r01 = _mm256_mul_ps(a0, _mm256_shuffle_ps(b01, b01, 0x00));
+			r01 = _mm256_fmadd_ps(a1, _mm256_shuffle_ps(b01, b01, 0x55), r01);
+			r01 = _mm256_fmadd_ps(a2, _mm256_shuffle_ps(b01, b01, 0xAA), r01);
+			r01 = _mm256_fmadd_ps(a3, _mm256_shuffle_ps(b01, b01, 0xFF), r01);
+			__m256 r23 = _mm256_mul_ps(a0, _mm256_shuffle_ps(b23, b23, 0x00));
+			r23 = _mm256_fmadd_ps(a1, _mm256_shuffle_ps(b23, b23, 0x55), r23);
+			r23 = _mm256_fmadd_ps(a2, _mm256_shuffle_ps(b23, b23, 0xAA), r23);
+			r23 = _mm256_fmadd_ps(a3, _mm256_shuffle_ps(b23, b23, 0xFF), r23);
+
+			_mm256_storeu_ps(&out[0][0], r01);
+			_mm256_storeu_ps(&out[2][0], r23);
+		}
+
+#elif defined(GECKO_KERNELS_SSE4)
+
+		constexpr u32 LANES = 4;
+		constexpr const char* INSTRUCTION_SET = "SSE4.1";
+
+		struct FloatN { __m128 V; };
+
+		inline FloatN Load(const f32* p) { return { _mm_loadu_ps(p) }; }
+		inline FloatN Set(f32 s) { return { _mm_set1_ps(s) }; }
+		inline FloatN operator+(FloatN a, FloatN b) { return { _mm_add_ps(a.V, b.V) }; }
+		inline FloatN operator-(FloatN a, FloatN b) { return { _mm_sub_ps(a.V, b.V) }; }
+		inline FloatN operator*(FloatN a, FloatN b) { return { _mm_mul_ps(a.V, b.V) }; }
+		inline FloatN operator/(FloatN a, FloatN b) { return { _mm_div_ps(a.V, b.V) }; }
+		inline FloatN MulAdd(FloatN a, FloatN b, FloatN c) { return { _mm_add_ps(_mm_mul_ps(a.V, b.V), c.V) }; }
+		inline FloatN Floor(FloatN a) { return { _mm_floor_ps(a.V) }; }
+		inline FloatN Round(FloatN a) { return { _mm_round_ps(a.V, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC) }; }
+		inline FloatN NotEqual(FloatN a, FloatN b) { return { _mm_cmpneq_ps(a.V, b.V) }; }
+		inline FloatN Select(FloatN mask, FloatN a, FloatN b) { return { _mm_blendv_ps(b.V, a.V, mask.V) }; }
+		inline FloatN Abs(FloatN a) { return { _mm_andnot_ps(_mm_set1_ps(-0.f), a.V) }; }
+		inline FloatN Min(FloatN a, FloatN b) { return { _mm_min_ps(a.V, b.V) }; }
+		inline FloatN Less(FloatN a, FloatN b) { return { _mm_cmplt_ps(a.V, b.V) }; }
+		inline u32 MaskBits(FloatN mask) { return static_cast<u32>(_mm_movemask_ps(mask.V)); }
+
+		inline void LoadMatrices(const glm::mat4* in, FloatN m[16])
+		{
+			for (u32 column = 0; column < 4; column++)
+			{
+				__m128 a0 = _mm_loadu_ps(&in[0][column][0]);
+				__m128 a1 = _mm_loadu_ps(&in[1][column][0]);
+				__m128 a2 = _mm_loadu_ps(&in[2][column][0]);
+				__m128 a3 = _mm_loadu_ps(&in[3][column][0]);
+				_MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+				m[column * 4].V = a0;
+				m[column * 4 + 1].V = a1;
+				m[column * 4 + 2].V = a2;
+				m[column * 4 + 3].V = a3;
+			}
+		}
+
+		inline void StoreMatrices(const FloatN m[16], glm::mat4* out)
+		{
+			for (u32 column = 0; column < 4; column++)
+			{
+				__m128 a0 = m[column * 4].V;
+				__m128 a1 = m[column * 4 + 1].V;
+				__m128 a2 = m[column * 4 + 2].V;
+				__m128 a3 = m[column * 4 + 3].V;
+				_MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+				_mm_storeu_ps(&out[0][column][0], a0);
+				_mm_storeu_ps(&out[1][column][0], a1);
+				_mm_storeu_ps(&out[2][column][0], a2);
+				_mm_storeu_ps(&out[3][column][0], a3);
+			}
+		}
+
+		inline void Multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out)
+		{
+			__m128 a0 = _mm_loadu_ps(&a[0][0]);
+			__m128 a1 = _mm_loadu_ps(&a[1][0]);
+			__m128 a2 = _mm_loadu_ps(&a[2][0]);
+			__m128 a3 = _mm_loadu_ps(&a[3][0]);
+			__m128 r[4];
+			for (u32 column = 0; column < 4; column++)
+			{
+				__m128 bc = _mm_loadu_ps(&b[column][0]);
+				__m128 rc = _mm_mul_ps(a0, _mm_shuffle_ps(bc, bc, 0x00));
+				rc = _mm_add_ps(rc, _mm_mul_ps(a1, _mm_shuffle_ps(bc, bc, 0x55)));
+				rc = _mm_add_ps(rc, _mm_mul_ps(a2, _mm_shuffle_ps(bc, bc, 0xAA)));
+				rc = _mm_add_ps(rc, _mm_mul_ps(a3, _mm_shuffle_ps(bc, bc, 0xFF)));
+				r[column] = rc;
+			}
+			for (u32 column = 0; column < 4; column++)
+			{
+				_mm_storeu_ps(&out[column][0], r[column]);
+			}
+		}
+
+#elif defined(GECKO_KERNELS_NEON)
+
+		constexpr u32 LANES = 4;
+		constexpr const char* INSTRUCTION_SET = "NEON";
+
+		struct FloatN { float32x4_t V; };
+
+		inline FloatN Load(const f32* p) { return { vld1q_f32(p) }; }
+		inline FloatN Set(f32 s) { return { vdupq_n_f32(s) }; }
+		inline FloatN operator+(FloatN a, FloatN b) { return { vaddq_f32(a.V, b.V) }; }
+		inline FloatN operator-(FloatN a, FloatN b) { return { vsubq_f32(a.V, b.V) }; }
+		inline FloatN operator*(FloatN a, FloatN b) { return { vmulq_f32(a.V, b.V) }; }
+		inline FloatN operator/(FloatN a, FloatN b) { return { vdivq_f32(a.V, b.V) }; }
+		inline FloatN MulAdd(FloatN a, FloatN b, FloatN c) { return { vfmaq_f32(c.V, a.V, b.V) }; }
+		inline FloatN Floor(FloatN a) { return { vrndmq_f32(a.V) }; }
+		inline FloatN Round(FloatN a) { return { vrndnq_f32(a.V) }; }
+		inline FloatN NotEqual(FloatN a, FloatN b) { return { vreinterpretq_f32_u32(vmvnq_u32(vceqq_f32(a.V, b.V))) }; }
+		inline FloatN Select(FloatN mask, FloatN a, FloatN b) { return { vbslq_f32(vreinterpretq_u32_f32(mask.V), a.V, b.V) }; }
+		inline FloatN Abs(FloatN a) { return { vabsq_f32(a.V) }; }
+		inline FloatN Min(FloatN a, FloatN b) { return { vminq_f32(a.V, b.V) }; }
+		inline FloatN Less(FloatN a, FloatN b) { return { vreinterpretq_f32_u32(vcltq_f32(a.V, b.V)) }; }
+		inline u32 MaskBits(FloatN mask)
+		{
+			const uint32x4_t bits = { 1, 2, 4, 8 };
+			return vaddvq_u32(vandq_u32(vreinterpretq_u32_f32(mask.V), bits));
+		}
+
+		inline void Transpose4(float32x4_t& a0, float32x4_t& a1, float32x4_t& a2, float32x4_t& a3)
+		{
+			float32x4x2_t t01 = vtrnq_f32(a0, a1);
+			float32x4x2_t t23 = vtrnq_f32(a2, a3);
+			a0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+			a1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+			a2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+			a3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+		}
+
+		inline void LoadMatrices(const glm::mat4* in, FloatN m[16])
+		{
+			for (u32 column = 0; column < 4; column++)
+			{
+				float32x4_t a0 = vld1q_f32(&in[0][column][0]);
+				float32x4_t a1 = vld1q_f32(&in[1][column][0]);
+				float32x4_t a2 = vld1q_f32(&in[2][column][0]);
+				float32x4_t a3 = vld1q_f32(&in[3][column][0]);
+				Transpose4(a0, a1, a2, a3);
+				m[column * 4].V = a0;
+				m[column * 4 + 1].V = a1;
+				m[column * 4 + 2].V = a2;
+				m[column * 4 + 3].V = a3;
+			}
+		}
+
+		inline void StoreMatrices(const FloatN m[16], glm::mat4* out)
+		{
+			for (u32 column = 0; column < 4; column++)
+			{
+				float32x4_t a0 = m[column * 4].V;
+				float32x4_t a1 = m[column * 4 + 1].V;
+				float32x4_t a2 = m[column * 4 + 2].V;
+				float32x4_t a3 = m[column * 4 + 3].V;
+				Transpose4(a0, a1, a2, a3);
+				vst1q_f32(&out[0][column][0], a0);
+				vst1q_f32(&out[1][column][0], a1);
+				vst1q_f32(&out[2][column][0], a2);
+				vst1q_f32(&out[3][column][0], a3);
+			}
+		}
+
+		inline void Multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out)
+		{
+			float32x4_t a0 = vld1q_f32(&a[0][0]);
+			float32x4_t a1 = vld1q_f32(&a[1][0]);
+			float32x4_t a2 = vld1q_f32(&a[2][0]);
+			float32x4_t a3 = vld1q_f32(&a[3][0]);
+			float32x4_t r[4];
+			for (u32 column = 0; column < 4; column++)
+			{
+				float32x4_t bc = vld1q_f32(&b[column][0]);
+				float32x4_t rc = vmulq_laneq_f32(a0, bc, 0);
+				rc = vfmaq_laneq_f32(rc, a1, bc, 1);
+				rc = vfmaq_laneq_f32(rc, a2, bc, 2);
+				rc = vfmaq_laneq_f32(rc, a3, bc, 3);
+				r[column] = rc;
+			}
+			for (u32 column = 0; column < 4; column++)
+			{
+				vst1q_f32(&out[column][0], r[column]);
+			}
+		}
+
+#else
+
+		constexpr u32 LANES = 1;
+		constexpr const char* INSTRUCTION_SET = "Scalar";
+
+		struct FloatN { f32 V; };
+
+		inline FloatN Load(const f32* p) { return { *p }; }
+		inline FloatN Set(f32 s) { return { s }; }
+		inline FloatN operator+(FloatN a, FloatN b) { return { a.V + b.V }; }
+		inline FloatN operator-(FloatN a, FloatN b) { return { a.V - b.V }; }
+		inline FloatN operator*(FloatN a, FloatN b) { return { a.V * b.V }; }
+		inline FloatN operator/(FloatN a, FloatN b) { return { a.V / b.V }; }
+		inline FloatN MulAdd(FloatN a, FloatN b, FloatN c) { return { a.V * b.V + c.V }; }
+		inline FloatN Floor(FloatN a) { return { std::floor(a.V) }; }
+		inline FloatN Round(FloatN a) { return { std::nearbyint(a.V) }; }
+		// A mask lane is 1 or 0 here.
+		inline FloatN NotEqual(FloatN a, FloatN b) { return { a.V != b.V ? 1.f : 0.f }; }
+		inline FloatN Select(FloatN mask, FloatN a, FloatN b) { return mask.V != 0.f ? a : b; }
+		inline FloatN Abs(FloatN a) { return { std::abs(a.V) }; }
+		inline FloatN Min(FloatN a, FloatN b) { return { a.V < b.V ? a.V : b.V }; }
+		inline FloatN Less(FloatN a, FloatN b) { return { a.V < b.V ? 1.f : 0.f }; }
+		inline u32 MaskBits(FloatN mask) { return mask.V != 0.f ? 1u : 0u; }
+
+		inline void LoadMatrices(const glm::mat4* in, FloatN m[16])
+		{
+			for (u32 column = 0; column < 4; column++)
+			{
+				for (u32 row = 0; row < 4; row++)
+				{
+					m[column * 4 + row].V = in[0][column][row];
+				}
+			}
+		}
+
+		inline void StoreMatrices(const FloatN m[16], glm::mat4* out)
+		{
+			for (u32 column = 0; column < 4; column++)
+			{
+				for (u32 row = 0; row < 4; row++)
+				{
+					out[0][column][row] = m[column * 4 + row].V;
+				}
+			}
+		}
+
+		inline void Multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out)
+		{
+			out = a * b;
+		}
+
+#endif
+
+		inline FloatN Negate(FloatN a)
+		{
+			return Set(0.f) - a;
+		}
+
+		// Odd whole numbers, all lanes hold whole numbers.
+		inline FloatN IsOdd(FloatN a)
+		{
+			FloatN half = a * Set(.5f);
+			return NotEqual(half, Floor(half));
+		}
+
+		// sin and cos with the range reduction and polynomials of the Cephes library, about one ulp in [-8192, 8192].
+		inline void SinCos(FloatN x, FloatN& outSin, FloatN& outCos)
+		{
+			// Quadrant j and x - j * pi / 2 in [-pi / 4, pi / 4], pi / 2 is split in three to keep the bits of x.
+			FloatN j = Round(x * Set(0.636619772367581343f));
+			FloatN y = MulAdd(j, Set(-1.5703125f), x);
+			y = MulAdd(j, Set(-4.837512969970703125e-4f), y);
+			y = MulAdd(j, Set(-7.54978995489188216e-8f), y);
+
+			FloatN z = y * y;
+			FloatN sinPoly = MulAdd(MulAdd(MulAdd(Set(-1.9515295891e-4f), z, Set(8.3321608736e-3f)), z, Set(-1.6666654611e-1f)) * z, y, y);
+			FloatN cosPoly = MulAdd(MulAdd(MulAdd(Set(2.443315711809948e-5f), z, Set(-1.388731625493765e-3f)), z, Set(4.166664568298827e-2f)) * z, z,
+				Set(1.f) - Set(.5f) * z);
+
+			// Quadrants 1 and 3 swap sin and cos, sin is negative in 2 and 3, cos in 1 and 2.
+			FloatN swap = IsOdd(j);
+			FloatN s = Select(swap, cosPoly, sinPoly);
+			FloatN c = Select(swap, sinPoly, cosPoly);
+			FloatN sinNegative = IsOdd(Floor(j * Set(.5f)));
+			FloatN cosNegative = IsOdd(Floor((j + Set(1.f)) * Set(.5f)));
+			outSin = Select(sinNegative, Negate(s), s);
+			outCos = Select(cosNegative, Negate(c), c);
+		}
+
+		// LANES transforms starting at first.
+		inline void ComposeLanes(const TRSArrays& transforms, u32 first, FloatN m[16])
+		{
+			// Half angles in radians for the quaternion.
+			const FloatN halfRadians = Set(0.00872664625997164788f);
+			FloatN sx, cx, sy, cy, sz, cz;
+			SinCos(Load(transforms.Rotation[0] + first) * halfRadians, sx, cx);
+			SinCos(Load(transforms.Rotation[1] + first) * halfRadians, sy, cy);
+			SinCos(Load(transforms.Rotation[2] + first) * halfRadians, sz, cz);
+
+			// glm::quat from euler angles.
+			FloatN cycz = cy * cz;
+			FloatN sysz = sy * sz;
+			FloatN sycz = sy * cz;
+			FloatN cysz = cy * sz;
+			FloatN w = cx * cycz + sx * sysz;
+			FloatN x = sx * cycz - cx * sysz;
+			FloatN y = cx * sycz + sx * cysz;
+			FloatN z = cx * cysz - sx * sycz;
+
+			// glm::toMat3, every column scaled, then the translation.
+			const FloatN one = Set(1.f);
+			const FloatN two = Set(2.f);
+			FloatN xx = x * x, yy = y * y, zz = z * z;
+			FloatN xy = x * y, xz = x * z, yz = y * z;
+			FloatN wx = w * x, wy = w * y, wz = w * z;
+
+			FloatN scaleX = Load(transforms.Scale[0] + first);
+			FloatN scaleY = Load(transforms.Scale[1] + first);
+			FloatN scaleZ = Load(transforms.Scale[2] + first);
+
+			m[0] = (one - two * (yy + zz)) * scaleX;
+			m[1] = two * (xy + wz) * scaleX;
+			m[2] = two * (xz - wy) * scaleX;
+			m[3] = Set(0.f);
+			m[4] = two * (xy - wz) * scaleY;
+			m[5] = (one - two * (xx + zz)) * scaleY;
+			m[6] = two * (yz + wx) * scaleY;
+			m[7] = Set(0.f);
+			m[8] = two * (xz + wy) * scaleZ;
+			m[9] = two * (yz - wx) * scaleZ;
+			m[10] = (one - two * (xx + yy)) * scaleZ;
+			m[11] = Set(0.f);
+			m[12] = Load(transforms.Position[0] + first);
+			m[13] = Load(transforms.Position[1] + first);
+			m[14] = Load(transforms.Position[2] + first);
+			m[15] = one;
+		}
+
+		// The rows of the inverted 3x3 part are the cross products of its columns divided by the determinant,
+		// the translation is the inverted 3x3 part applied to the negated translation.
+		inline void InvertAffineLanes(const FloatN m[16], FloatN out[16])
+		{
+			FloatN r0[3] = { m[5] * m[10] - m[6] * m[9], m[6] * m[8] - m[4] * m[10], m[4] * m[9] - m[5] * m[8] };
+			FloatN r1[3] = { m[9] * m[2] - m[10] * m[1], m[10] * m[0] - m[8] * m[2], m[8] * m[1] - m[9] * m[0] };
+			FloatN r2[3] = { m[1] * m[6] - m[2] * m[5], m[2] * m[4] - m[0] * m[6], m[0] * m[5] - m[1] * m[4] };
+
+			FloatN inverseDeterminant = Set(1.f) / (m[0] * r0[0] + m[1] * r0[1] + m[2] * r0[2]);
+			for (u32 column = 0; column < 3; column++)
+			{
+				out[column * 4] = r0[column] * inverseDeterminant;
+				out[column * 4 + 1] = r1[column] * inverseDeterminant;
+				out[column * 4 + 2] = r2[column] * inverseDeterminant;
+				out[column * 4 + 3] = Set(0.f);
+			}
+			for (u32 row = 0; row < 3; row++)
+			{
+				out[12 + row] = Negate(out[row] * m[12] + out[4 + row] * m[13] + out[8 + row] * m[14]);
+			}
+			out[15] = Set(1.f);
+		}
+
+		// A bit per lane, set for the boxes that are at least partly on the inside of every plane.
+		inline u32 CullLanes(const Frustum& frustum, const BoxArrays& boxes, u32 first, const FloatN m[16])
+		{
+			FloatN localCenter[3], localExtents[3];
+			for (u32 component = 0; component < 3; component++)
+			{
+				localCenter[component] = Load(boxes.Center[component] + first);
+				localExtents[component] = Load(boxes.Extents[component] + first);
+			}
+
+			// The moved center, and the half size of the axis aligned box around the moved box.
+			FloatN center[3], extents[3];
+			for (u32 row = 0; row < 3; row++)
+			{
+				center[row] = MulAdd(m[row], localCenter[0], MulAdd(m[4 + row], localCenter[1], MulAdd(m[8 + row], localCenter[2], m[12 + row])));
+				extents[row] = MulAdd(Abs(m[row]), localExtents[0], MulAdd(Abs(m[4 + row]), localExtents[1], Abs(m[8 + row]) * localExtents[2]));
+			}
+
+			// The corner furthest along each plane normal, a box is outside when that corner is behind any of the planes.
+			FloatN furthest[6];
+			for (u32 plane = 0; plane < 6; plane++)
+			{
+				const glm::vec4& p = frustum.Planes[plane];
+				FloatN distance = MulAdd(Set(p.x), center[0], MulAdd(Set(p.y), center[1], MulAdd(Set(p.z), center[2], Set(p.w))));
+				furthest[plane] = MulAdd(Set(std::abs(p.x)), extents[0], MulAdd(Set(std::abs(p.y)), extents[1], MulAdd(Set(std::abs(p.z)), extents[2], distance)));
+			}
+			FloatN closest = Min(Min(Min(furthest[0], furthest[1]), Min(furthest[2], furthest[3])), Min(furthest[4], furthest[5]));
+			return ~MaskBits(Less(closest, Set(0.f))) & ((1u << LANES) - 1);
+		}
+	}
+
+	const char* GetKernelInstructionSet()
+	{
+		return INSTRUCTION_SET;
+	}
+
+	void ComposeTRS(const TRSArrays& transforms, glm::mat4* out, u32 count)
+	{
+		FloatN m[16];
+		u32 i = 0;
+		for (; i + LANES <= count; i += LANES)
+		{
+			ComposeLanes(transforms, i, m);
+			StoreMatrices(m, out + i);
+		}
+		if (i == count)
+			return;
+
+		// The last transforms are copied into full lanes, the unused lanes get an identity transform.
+		f32 tail[9][LANES];
+		TRSArrays tailTransforms;
+		for (u32 component = 0; component < 3; component++)
+		{
+			for (u32 lane = 0; lane < LANES; lane++)
+			{
+				bool used = i + lane < count;
+				tail[component][lane] = used ? transforms.Position[component][i + lane] : 0.f;
+				tail[3 + component][lane] = used ? transforms.Rotation[component][i + lane] : 0.f;
+				tail[6 + component][lane] = used ? transforms.Scale[component][i + lane] : 1.f;
+			}
+			tailTransforms.Position[component] = tail[component];
+			tailTransforms.Rotation[component] = tail[3 + component];
+			tailTransforms.Scale[component] = tail[6 + component];
+		}
+
+		glm::mat4 tailMatrices[LANES];
+		ComposeLanes(tailTransforms, 0, m);
+		StoreMatrices(m, tailMatrices);
+		for (u32 lane = 0; i + lane < count; lane++)
+		{
+			out[i + lane] = tailMatrices[lane];
+		}
+	}
+
+	void MultiplyMatrices(const glm::mat4* a, const glm::mat4* b, glm::mat4* out, u32 count)
+	{
+		for (u32 i = 0; i < count; i++)
+		{
+			Multiply(a[i], b[i], out[i]);
+		}
+	}
+
+	void MultiplyByParents(const u32* indices, u32 count, const u32* parents, const glm::mat4* local, glm::mat4* world)
+	{
+		for (u32 i = 0; i < count; i++)
+		{
+			u32 index = indices[i];
+			u32 parent = parents[index];
+			if (parent == NO_PARENT_MATRIX)
+			{
+				world[index] = local[index];
+				continue;
+			}
+			Multiply(world[parent], local[index], world[index]);
+		}
+	}
+
+	void InvertAffine(const glm::mat4* in, glm::mat4* out, u32 count)
+	{
+		FloatN m[16];
+		FloatN inverse[16];
+		u32 i = 0;
+		for (; i + LANES <= count; i += LANES)
+		{
+			LoadMatrices(in + i, m);
+			InvertAffineLanes(m, inverse);
+			StoreMatrices(inverse, out + i);
+		}
+		if (i == count)
+			return;
+
+		glm::mat4 tail[LANES];
+		for (u32 lane = 0; lane < LANES; lane++)
+		{
+			tail[lane] = i + lane < count ? in[i + lane] : glm::mat4(1.f);
+		}
+		LoadMatrices(tail, m);
+		InvertAffineLanes(m, inverse);
+		StoreMatrices(inverse, tail);
+		for (u32 lane = 0; i + lane < count; lane++)
+		{
+			out[i + lane] = tail[lane];
+		}
+	}
+
+	Frustum ExtractFrustum(const glm::mat4& viewProjection)
+	{
+		// Rows of the matrix, glm indexes the column first.
+		glm::vec4 rows[4];
+		for (u32 row = 0; row < 4; row++)
+		{
+			rows[row] = glm::vec4(viewProjection[0][row], viewProjection[1][row], viewProjection[2][row], viewProjection[3][row]);
+		}
+
+		// -w <= x, y, z <= w in clip space.
+		Frustum frustum;
+		frustum.Planes[0] = rows[3] + rows[0];
+		frustum.Planes[1] = rows[3] - rows[0];
+		frustum.Planes[2] = rows[3] + rows[1];
+		frustum.Planes[3] = rows[3] - rows[1];
+		frustum.Planes[4] = rows[3] + rows[2];
+		frustum.Planes[5] = rows[3] - rows[2];
+		return frustum;
+	}
+
+	u32 CullBoxes(const Frustum& frustum, const BoxArrays& boxes, const glm::mat4* transforms, u32 count, u32* visible)
+	{
+		FloatN m[16];
+		u32 visibleCount = 0;
+		u32 i = 0;
+		for (; i + LANES <= count; i += LANES)
+		{
+			LoadMatrices(transforms + i, m);
+			u32 bits = CullLanes(frustum, boxes, i, m);
+			for (u32 lane = 0; lane < LANES; lane++)
+			{
+				visible[visibleCount] = i + lane;
+				visibleCount += (bits >> lane) & 1;
+			}
+		}
+		if (i == count)
+			return visibleCount;
+
+		// The last boxes are copied into full lanes, the bits of the unused lanes are dropped.
+		f32 tail[6][LANES];
+		BoxArrays tailBoxes;
+		glm::mat4 tailTransforms[LANES];
+		for (u32 lane = 0; lane < LANES; lane++)
+		{
+			bool used = i + lane < count;
+			for (u32 component = 0; component < 3; component++)
+			{
+				tail[component][lane] = used ? boxes.Center[component][i + lane] : 0.f;
+				tail[3 + component][lane] = used ? boxes.Extents[component][i + lane] : 0.f;
+			}
+			tailTransforms[lane] = used ? transforms[i + lane] : glm::mat4(1.f);
+		}
+		for (u32 component = 0; component < 3; component++)
+		{
+			tailBoxes.Center[component] = tail[component];
+			tailBoxes.Extents[component] = tail[3 + component];
+		}
+
+		LoadMatrices(tailTransforms, m);
+		u32 bits = CullLanes(frustum, tailBoxes, 0, m);
+		for (u32 lane = 0; i + lane < count; lane++)
+		{
+			visible[visibleCount] = i + lane;
+			visibleCount += (bits >> lane) & 1;
+		}
+		return visibleCount;
+	}
+
+} }
@@ -0,0 +1,345 @@
+#ifdef __linux__
+#include "Core/AsyncIOInternal.h"
+
+#include "Core/Logger.h"
+#include "Core/Threading.h"
+
+// Linux Includes
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+// The io_uring backend talks to the kernel through the raw system calls, liburing is not required.
+// One thread owns the ring: it opens the files, submits the reads and reaps their completions.
+// New requests wake it through a read on an eventfd that is always queued on the ring.
+
+namespace Gecko { namespace IO { namespace Internal
+{
+
+	namespace
+	{
+		constexpr u64 WAKE_USER_DATA = ~0ull;
+		// Larger reads are split, a single read returns at most this much anyway.
+		constexpr u64 MAX_READ_SIZE = 1ull << 30;
+
+		struct IOUring
+		{
+			int RingFile{ -1 };
+			int WakeFile{ -1 };
+			u64 WakeValue{ 0 };
+
+			void* SubmissionRing{ nullptr };
+			size_t SubmissionRingSize{ 0 };
+			void* CompletionRing{ nullptr };
+			size_t CompletionRingSize{ 0 };
+			io_uring_sqe* SubmissionEntries{ nullptr };
+			size_t SubmissionEntriesSize{ 0 };
+
+			u32* SubmissionTail{ nullptr };
+			u32 SubmissionMask{ 0 };
+			u32* SubmissionArray{ nullptr };
+			u32 NumSubmissionEntries{ 0 };
+
+			u32* CompletionHead{ nullptr };
+			u32* CompletionTail{ nullptr };
+			u32 CompletionMask{ 0 };
+			io_uring_cqe* CompletionEntries{ nullptr };
+
+			// Tail of the entries written so far, only this thread moves it. It is published to SubmissionTail as is, so
+			// publishing again after a failed io_uring_enter does not move the shared tail a second time.
+			u32 LocalSubmissionTail{ 0 };
+			// Published entries the kernel has not consumed yet.
+			u32 NumToSubmit{ 0 };
+			// Reads on the ring, without the wake read.
+			u32 NumInFlight{ 0 };
+			u32 MaxInFlight{ 0 };
+
+			std::atomic<bool> Stop{ false };
+			std::thread Thread;
+		};
+
+		static IOUring* s_Ring{ nullptr };
+
+		int SetupRing(u32 entries, io_uring_params* params)
+		{
+			return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+		}
+
+		int EnterRing(int ringFile, u32 toSubmit, u32 minComplete, u32 flags)
+		{
+			return static_cast<int>(syscall(__NR_io_uring_enter, ringFile, toSubmit, minComplete, flags, nullptr, 0));
+		}
+
+		void* MapRing(int ringFile, size_t size, u64 offset)
+		{
+			void* ring = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFile, static_cast<off_t>(offset));
+			return ring == MAP_FAILED ? nullptr : ring;
+		}
+
+		void DestroyRing(IOUring* ring)
+		{
+			if (ring->SubmissionEntries != nullptr)
+			{
+				munmap(ring->SubmissionEntries, ring->SubmissionEntriesSize);
+			}
+			if (ring->CompletionRing != nullptr && ring->CompletionRing != ring->SubmissionRing)
+			{
+				munmap(ring->CompletionRing, ring->CompletionRingSize);
+			}
+			if (ring->SubmissionRing != nullptr)
+			{
+				munmap(ring->SubmissionRing, ring->SubmissionRingSize);
+			}
+			if (ring->WakeFile >= 0)
+			{
+				close(ring->WakeFile);
+			}
+			if (ring->RingFile >= 0)
+			{
+				close(ring->RingFile);
+			}
+			delete ring;
+		}
+
+		// The submission queue is as large as the completion queue can hold reads, so there is always room.
+		io_uring_sqe* GetSubmissionEntry(IOUring* ring)
+		{
+			u32 index = ring->LocalSubmissionTail & ring->SubmissionMask;
+			io_uring_sqe* entry = &ring->SubmissionEntries[index];
+			memset(entry, 0, sizeof(io_uring_sqe));
+			ring->SubmissionArray[index] = index;
+			ring->LocalSubmissionTail++;
+			ring->NumToSubmit++;
+			return entry;
+		}
+
+		// Makes the entries written since the last call visible to the kernel.
+		void PublishSubmissions(IOUring* ring)
+		{
+			__atomic_store_n(ring->SubmissionTail, ring->LocalSubmissionTail, __ATOMIC_RELEASE);
+		}
+
+		void QueueWakeRead(IOUring* ring)
+		{
+			io_uring_sqe* entry = GetSubmissionEntry(ring);
+			entry->opcode = IORING_OP_READ;
+			entry->fd = ring->WakeFile;
+			entry->addr = reinterpret_cast<u64>(&ring->WakeValue);
+			entry->len = sizeof(ring->WakeValue);
+			entry->user_data = WAKE_USER_DATA;
+		}
+
+		void QueueRead(IOUring* ring, Request* request)
+		{
+			u64 remaining = request->Size - request->BytesRead;
+
+			io_uring_sqe* entry = GetSubmissionEntry(ring);
+			entry->opcode = IORING_OP_READ;
+			entry->fd = request->File;
+			entry->off = request->BytesRead;
+			entry->addr = reinterpret_cast<u64>(request->Buffer + request->BytesRead);
+			entry->len = static_cast<u32>(std::min(remaining, MAX_READ_SIZE));
+			entry->user_data = reinterpret_cast<u64>(request);
+		}
+
+		void FinishRequest(IOUring* ring, Request* request, IOStatus status)
+		{
+			if (request->File >= 0)
+			{
+				close(request->File);
+				request->File = -1;
+			}
+			ring->NumInFlight--;
+			CompleteRequest(request, status);
+		}
+
+		// Opens the file and queues its first read, requests that end here never count as in flight.
+		void StartRequest(IOUring* ring, Request* request)
+		{
+			if (request->CancelRequested.load(std::memory_order_relaxed))
+			{
+				CompleteRequest(request, IOStatus::Cancelled);
+				return;
+			}
+
+			request->File = open(request->NativePath.c_str(), O_RDONLY | O_CLOEXEC);
+			struct stat fileStat;
+			if (request->File < 0 || fstat(request->File, &fileStat) != 0)
+			{
+				ring->NumInFlight++;
+				FinishRequest(ring, request, IOStatus::Failed);
+				return;
+			}
+
+			request->Size = static_cast<u64>(fileStat.st_size);
+			// One spare byte, so empty files still get a buffer and text files can be terminated by the callback.
+			request->Buffer = static_cast<u8*>(Memory::Allocate(request->Size + 1, request->Tag));
+			request->Buffer[request->Size] = 0;
+
+			ring->NumInFlight++;
+			if (request->Size == 0)
+			{
+				FinishRequest(ring, request, IOStatus::Completed);
+				return;
+			}
+			QueueRead(ring, request);
+		}
+
+		void HandleCompletion(IOUring* ring, const io_uring_cqe& completion)
+		{
+			if (completion.user_data == WAKE_USER_DATA)
+			{
+				QueueWakeRead(ring);
+				return;
+			}
+
+			Request* request = reinterpret_cast<Request*>(completion.user_data);
+			if (completion.res == -EINTR || completion.res == -EAGAIN)
+			{
+				QueueRead(ring, request);
+				return;
+			}
+			if (completion.res < 0)
+			{
+				FinishRequest(ring, request, IOStatus::Failed);
+				return;
+			}
+
+			request->BytesRead += static_cast<u64>(completion.res);
+			// A read of 0 bytes means the file got shorter since it was opened, return what is there.
+			if (completion.res == 0 || request->BytesRead >= request->Size || request->CancelRequested.load(std::memory_order_relaxed))
+			{
+				request->Buffer[request->BytesRead] = 0;
+				FinishRequest(ring, request, IOStatus::Completed);
+				return;
+			}
+			QueueRead(ring, request);
+		}
+
+		void RingThread(IOUring* ring)
+		{
+			Threading::RegisterCurrentThread(Threading::ThreadRole::IO, 0);
+			QueueWakeRead(ring);
+
+			while (!ring->Stop.load(std::memory_order_acquire) || ring->NumInFlight > 0)
+			{
+				if (!ring->Stop.load(std::memory_order_acquire))
+				{
+					while (ring->NumInFlight < ring->MaxInFlight)
+					{
+						Request* request = PopIOUringRequest();
+						if (request == nullptr)
+							break;
+						StartRequest(ring, request);
+					}
+				}
+
+				PublishSubmissions(ring);
+				int result = EnterRing(ring->RingFile, ring->NumToSubmit, 1, IORING_ENTER_GETEVENTS);
+				if (result < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+				{
+					LOG_FATAL("io_uring_enter failed with error %d.", errno);
+					return;
+				}
+				// The kernel reports how many entries it consumed, the rest are passed again on the next call.
+				if (result > 0)
+				{
+					ring->NumToSubmit -= std::min(static_cast<u32>(result), ring->NumToSubmit);
+				}
+
+				u32 head = *ring->CompletionHead;
+				u32 tail = __atomic_load_n(ring->CompletionTail, __ATOMIC_ACQUIRE);
+				while (head != tail)
+				{
+					io_uring_cqe completion = ring->CompletionEntries[head & ring->CompletionMask];
+					head++;
+					__atomic_store_n(ring->CompletionHead, head, __ATOMIC_RELEASE);
+					HandleCompletion(ring, completion);
+				}
+			}
+		}
+	}
+
+	bool StartIOUring(u32 queueDepth)
+	{
+		IOUring* ring = new IOUring();
+
+		io_uring_params params;
+		memset(&params, 0, sizeof(params));
+		// One entry for the wake read.
+		ring->RingFile = SetupRing(queueDepth + 1, &params);
+		if (ring->RingFile < 0)
+		{
+			DestroyRing(ring);
+			return false;
+		}
+
+		ring->SubmissionRingSize = params.sq_off.array + params.sq_entries * sizeof(u32);
+		ring->CompletionRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0)
+		{
+			ring->SubmissionRingSize = std::max(ring->SubmissionRingSize, ring->CompletionRingSize);
+			ring->CompletionRingSize = ring->SubmissionRingSize;
+		}
+
+		ring->SubmissionRing = MapRing(ring->RingFile, ring->SubmissionRingSize, IORING_OFF_SQ_RING);
+		ring->CompletionRing = (params.features & IORING_FEAT_SINGLE_MMAP) != 0 ? ring->SubmissionRing : MapRing(ring->RingFile, ring->CompletionRingSize, IORING_OFF_CQ_RING);
+		ring->SubmissionEntriesSize = params.sq_entries * sizeof(io_uring_sqe);
+		ring->SubmissionEntries = static_cast<io_uring_sqe*>(MapRing(ring->RingFile, ring->SubmissionEntriesSize, IORING_OFF_SQES));
+		ring->WakeFile = eventfd(0, EFD_CLOEXEC);
+		if (ring->SubmissionRing == nullptr || ring->CompletionRing == nullptr || ring->SubmissionEntries == nullptr || ring->WakeFile < 0)
+		{
+			DestroyRing(ring);
+			return false;
+		}
+
+		u8* submissionRing = static_cast<u8*>(ring->SubmissionRing);
+		ring->SubmissionTail = reinterpret_cast<u32*>(submissionRing + params.sq_off.tail);
+		ring->LocalSubmissionTail = *ring->SubmissionTail;
+		ring->SubmissionMask = *reinterpret_cast<u32*>(submissionRing + params.sq_off.ring_mask);
+		ring->SubmissionArray = reinterpret_cast<u32*>(submissionRing + params.sq_off.array);
+		ring->NumSubmissionEntries = params.sq_entries;
+
+		u8* completionRing = static_cast<u8*>(ring->CompletionRing);
+		ring->CompletionHead = reinterpret_cast<u32*>(completionRing + params.cq_off.head);
+		ring->CompletionTail = reinterpret_cast<u32*>(completionRing + params.cq_off.tail);
+		ring->CompletionMask = *reinterpret_cast<u32*>(completionRing + params.cq_off.ring_mask);
+		ring->CompletionEntries = reinterpret_cast<io_uring_cqe*>(completionRing + params.cq_off.cqes);
+
+		ring->MaxInFlight = std::min(queueDepth, params.sq_entries - 1);
+
+		s_Ring = ring;
+		ring->Thread = std::thread(RingThread, ring);
+		return true;
+	}
+
+	void StopIOUring()
+	{
+		s_Ring->Stop.store(true, std::memory_order_release);
+		WakeIOUring();
+		s_Ring->Thread.join();
+
+		DestroyRing(s_Ring);
+		s_Ring = nullptr;
+	}
+
+	void WakeIOUring()
+	{
+		u64 value = 1;
+		ssize_t written = write(s_Ring->WakeFile, &value, sizeof(value));
+		(void)written;
+	}
+
+} } }
+
+#endif // __linux__
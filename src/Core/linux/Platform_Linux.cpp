@@ -0,0 +1,595 @@
+#ifdef __linux__
+#include "Core/Platform.h"
+#include "Core/Logger.h"
+#include "Core/Event.h"
+#include "Core/Asserts.h"
+#include "Core/Time.h"
+
+// Linux Includes
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <errno.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+namespace Gecko { namespace Platform
+{
+	// The Linux platform is headless, there is no window and no input. It is meant for running the
+	// CPU side of the engine on build and benchmark machines, SIGINT and SIGTERM close the "window".
+	namespace {
+		constexpr size_t PAGE_ALIGNMENT = 64 * 1024;
+		constexpr size_t DEFAULT_HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+		constexpr u32 MAX_CALL_STACK_FRAMES = 64;
+
+		struct PlatformState
+		{
+			AppInfo Info;
+			bool IsClosed = false;
+			u64 StartTicks{ 0 };
+
+			struct sigaction PreviousInterruptAction{};
+			struct sigaction PreviousTerminateAction{};
+		};
+
+		static Scope<PlatformState> s_State{ nullptr };
+		// Set by the signal handler, PumpMessage turns it into a CODE_WINDOW_CLOSED event on the main thread.
+		static volatile sig_atomic_t s_QuitRequested = 0;
+
+		void OnQuitSignal(int)
+		{
+			s_QuitRequested = 1;
+		}
+
+		u64 TimespecToTicks(const timespec& time)
+		{
+			return static_cast<u64>(time.tv_sec) * Time::TICKS_PER_SECOND + static_cast<u64>(time.tv_nsec);
+		}
+
+		size_t RoundUpToPages(size_t size)
+		{
+			size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+			return (size + pageSize - 1) & ~(pageSize - 1);
+		}
+
+		// mmap only aligns to the page size, map extra and unmap the parts outside the aligned range.
+		void* MapAlignedPages(size_t size, size_t alignment)
+		{
+			size_t mappedSize = size + alignment;
+			void* mapped = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (mapped == MAP_FAILED)
+				return nullptr;
+
+			uintptr_t start = reinterpret_cast<uintptr_t>(mapped);
+			uintptr_t alignedStart = (start + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+			size_t headSize = alignedStart - start;
+			size_t tailSize = mappedSize - headSize - size;
+			if (headSize > 0)
+			{
+				munmap(mapped, headSize);
+			}
+			if (tailSize > 0)
+			{
+				munmap(reinterpret_cast<void*>(alignedStart + size), tailSize);
+			}
+			return reinterpret_cast<void*>(alignedStart);
+		}
+
+		// Called from inside the heap, so it must not allocate through it.
+		size_t QueryHugePageSize()
+		{
+			size_t hugePageSize = DEFAULT_HUGE_PAGE_SIZE;
+			FILE* file = fopen("/proc/meminfo", "r");
+			if (file == nullptr)
+				return hugePageSize;
+
+			char line[256];
+			while (fgets(line, sizeof(line), file) != nullptr)
+			{
+				unsigned long long sizeInKiB;
+				if (sscanf(line, "Hugepagesize: %llu kB", &sizeInKiB) == 1 && sizeInKiB > 0)
+				{
+					hugePageSize = static_cast<size_t>(sizeInKiB) * 1024;
+					break;
+				}
+			}
+			fclose(file);
+			return hugePageSize;
+		}
+
+		const std::string SYSFS_CPU_PATH = "/sys/devices/system/cpu/";
+		const std::string SYSFS_NODE_PATH = "/sys/devices/system/node/";
+		constexpr u32 MAX_CACHE_INDICES = 8;
+
+		// First line of a sysfs file without the newline.
+		bool ReadSysFile(const std::string& path, std::string& outValue)
+		{
+			FILE* file = fopen(path.c_str(), "r");
+			if (file == nullptr)
+				return false;
+
+			char buffer[1024];
+			bool success = fgets(buffer, sizeof(buffer), file) != nullptr;
+			fclose(file);
+			if (!success)
+				return false;
+
+			outValue = buffer;
+			while (!outValue.empty() && (outValue.back() == '\n' || outValue.back() == ' '))
+			{
+				outValue.pop_back();
+			}
+			return true;
+		}
+
+		u32 ReadSysValue(const std::string& path, u32 defaultValue)
+		{
+			std::string value;
+			return ReadSysFile(path, value) ? static_cast<u32>(strtoul(value.c_str(), nullptr, 10)) : defaultValue;
+		}
+
+		// Parses lists like "0-3,8,10-11".
+		std::vector<u32> ParseCPUList(const std::string& list)
+		{
+			std::vector<u32> cpus;
+			const char* current = list.c_str();
+			while (*current != '\0')
+			{
+				char* end;
+				u32 first = static_cast<u32>(strtoul(current, &end, 10));
+				if (end == current)
+					break;
+
+				u32 last = first;
+				if (*end == '-')
+				{
+					current = end + 1;
+					last = static_cast<u32>(strtoul(current, &end, 10));
+				}
+				for (u32 cpu = first; cpu <= last; cpu++)
+				{
+					cpus.push_back(cpu);
+				}
+
+				current = *end == ',' ? end + 1 : end;
+			}
+			return cpus;
+		}
+
+		std::vector<u32> ReadCPUList(const std::string& path)
+		{
+			std::string list;
+			return ReadSysFile(path, list) ? ParseCPUList(list) : std::vector<u32>();
+		}
+
+		// Sizes look like "32K" or "16M".
+		u64 ParseCacheSize(const std::string& size)
+		{
+			char* unit;
+			u64 value = strtoull(size.c_str(), &unit, 10);
+			if (*unit == 'K')
+				return value * 1024;
+			if (*unit == 'M')
+				return value * 1024 * 1024;
+			if (*unit == 'G')
+				return value * 1024 * 1024 * 1024;
+			return value;
+		}
+
+		// Replaces the raw ids the OS reports with indices from 0 without gaps, returns the number of distinct ids.
+		u32 Renumber(std::vector<LogicalCore>& cores, u32 LogicalCore::* member)
+		{
+			std::vector<u32> ids;
+			for (const LogicalCore& core : cores)
+			{
+				ids.push_back(core.*member);
+			}
+			std::sort(ids.begin(), ids.end());
+			ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+			for (LogicalCore& core : cores)
+			{
+				core.*member = static_cast<u32>(std::lower_bound(ids.begin(), ids.end(), core.*member) - ids.begin());
+			}
+			return static_cast<u32>(ids.size());
+		}
+
+		CPUTopology QueryCPUTopology()
+		{
+			CPUTopology topology;
+
+			cpu_set_t allowedCores;
+			CPU_ZERO(&allowedCores);
+			bool hasAffinity = sched_getaffinity(0, sizeof(allowedCores), &allowedCores) == 0;
+
+			std::vector<u32> onlineCores = ReadCPUList(SYSFS_CPU_PATH + "online");
+			if (onlineCores.empty())
+			{
+				long numCores = sysconf(_SC_NPROCESSORS_ONLN);
+				for (u32 i = 0; i < static_cast<u32>(numCores > 0 ? numCores : 1); i++)
+				{
+					onlineCores.push_back(i);
+				}
+			}
+
+			for (u32 index : onlineCores)
+			{
+				if (hasAffinity && index < CPU_SETSIZE && !CPU_ISSET(index, &allowedCores))
+					continue;
+
+				// Without sysfs every logical core is its own physical core.
+				std::string corePath = SYSFS_CPU_PATH + "cpu" + std::to_string(index) + "/";
+				std::vector<u32> siblings = ReadCPUList(corePath + "topology/thread_siblings_list");
+
+				LogicalCore core;
+				core.Index = index;
+				core.PhysicalCore = siblings.empty() ? index : siblings.front();
+				core.Package = ReadSysValue(corePath + "topology/physical_package_id", 0);
+				core.CacheGroup = index;
+				topology.LogicalCores.push_back(core);
+			}
+			if (topology.LogicalCores.empty())
+			{
+				topology.LogicalCores.push_back(LogicalCore());
+			}
+
+			// Caches of the first core, the last level decides the cache groups.
+			std::string firstCorePath = SYSFS_CPU_PATH + "cpu" + std::to_string(topology.LogicalCores.front().Index) + "/cache/";
+			std::string lastLevelCache;
+			u32 lastLevel = 0;
+			for (u32 i = 0; i < MAX_CACHE_INDICES; i++)
+			{
+				std::string cachePath = firstCorePath + "index" + std::to_string(i) + "/";
+				std::string type;
+				if (!ReadSysFile(cachePath + "type", type))
+					break;
+				if (type == "Instruction")
+					continue;
+
+				CPUCache cache;
+				cache.Level = ReadSysValue(cachePath + "level", 0);
+				std::string size;
+				cache.Size = ReadSysFile(cachePath + "size", size) ? ParseCacheSize(size) : 0;
+				cache.LineSize = ReadSysValue(cachePath + "coherency_line_size", 64);
+				cache.NumSharingCores = std::max(static_cast<u32>(ReadCPUList(cachePath + "shared_cpu_list").size()), 1u);
+				topology.Caches.push_back(cache);
+
+				if (cache.Level >= lastLevel)
+				{
+					lastLevel = cache.Level;
+					lastLevelCache = "/cache/index" + std::to_string(i) + "/shared_cpu_list";
+				}
+			}
+			std::sort(topology.Caches.begin(), topology.Caches.end(), [](const CPUCache& a, const CPUCache& b) { return a.Level < b.Level; });
+			if (!topology.Caches.empty())
+			{
+				topology.CacheLineSize = topology.Caches.front().LineSize;
+			}
+
+			for (LogicalCore& core : topology.LogicalCores)
+			{
+				if (lastLevelCache.empty())
+					break;
+
+				std::vector<u32> sharingCores = ReadCPUList(SYSFS_CPU_PATH + "cpu" + std::to_string(core.Index) + lastLevelCache);
+				core.CacheGroup = sharingCores.empty() ? core.Index : sharingCores.front();
+			}
+
+			// Machines without NUMA have no node directory, everything stays on node 0.
+			for (u32 node : ReadCPUList(SYSFS_NODE_PATH + "online"))
+			{
+				for (u32 index : ReadCPUList(SYSFS_NODE_PATH + "node" + std::to_string(node) + "/cpulist"))
+				{
+					for (LogicalCore& core : topology.LogicalCores)
+					{
+						if (core.Index == index)
+						{
+							core.NUMANode = node;
+						}
+					}
+				}
+			}
+
+			topology.NumLogicalCores = static_cast<u32>(topology.LogicalCores.size());
+			topology.NumPhysicalCores = Renumber(topology.LogicalCores, &LogicalCore::PhysicalCore);
+			topology.NumPackages = Renumber(topology.LogicalCores, &LogicalCore::Package);
+			topology.NumNUMANodes = Renumber(topology.LogicalCores, &LogicalCore::NUMANode);
+			topology.NumCacheGroups = Renumber(topology.LogicalCores, &LogicalCore::CacheGroup);
+			return topology;
+		}
+	}
+
+	bool Init(AppInfo& info)
+	{
+		ASSERT_MSG(s_State == nullptr, "State already initialized, state must be nullptr when calling Init!");
+
+		s_State = CreateScope<PlatformState>();
+
+		s_State->Info = info;
+		timespec startTime;
+		clock_gettime(CLOCK_MONOTONIC, &startTime);
+		s_State->StartTicks = TimespecToTicks(startTime);
+
+		s_QuitRequested = 0;
+		struct sigaction quitAction{};
+		quitAction.sa_handler = OnQuitSignal;
+		sigemptyset(&quitAction.sa_mask);
+		sigaction(SIGINT, &quitAction, &s_State->PreviousInterruptAction);
+		sigaction(SIGTERM, &quitAction, &s_State->PreviousTerminateAction);
+
+		LOG_INFO("Running headless, %ux%u with %u back buffers.", info.Width, info.Height, info.NumBackBuffers);
+
+		return true;
+	}
+
+	void Shutdown()
+	{
+		ASSERT_MSG(s_State != nullptr, "Platform state not initialized, did you not initialize platform?");
+
+		sigaction(SIGINT, &s_State->PreviousInterruptAction, nullptr);
+		sigaction(SIGTERM, &s_State->PreviousTerminateAction, nullptr);
+
+		s_State.reset();
+	}
+
+	const AppInfo& GetAppInfo()
+	{
+		ASSERT_MSG(s_State != nullptr, "Platform state not initialized, did you not initialize platform?");
+
+		return s_State->Info;
+	}
+
+	void* GetWindowData()
+	{
+		return nullptr;
+	}
+
+	bool PumpMessage()
+	{
+		ASSERT_MSG(s_State != nullptr, "Platform state not initialized, did you not initialize platform?");
+
+		if (s_QuitRequested != 0 && !s_State->IsClosed)
+		{
+			Event::EventData data{};
+			data.Sender = nullptr;
+			Event::FireEvent(Event::SystemEvent::CODE_WINDOW_CLOSED, data);
+			s_State->IsClosed = true;
+		}
+		return true;
+	}
+
+	bool IsRunning()
+	{
+		ASSERT_MSG(s_State != nullptr, "Platform state not initialized, did you not initialize platform?");
+
+		return !s_State->IsClosed;
+	}
+
+	float GetScreenAspectRatio()
+	{
+		ASSERT_MSG(s_State != nullptr, "Platform state not initialized, did you not initialize platform?");
+
+		return static_cast<float>(s_State->Info.Width) / static_cast<float>(s_State->Info.Height);
+	}
+
+	float GetTime()
+	{
+		return static_cast<float>(Time::ToSeconds(GetTicks()));
+	}
+
+	u64 GetTicks()
+	{
+		ASSERT_MSG(s_State != nullptr, "Platform state not initialized, did you not initialize platform?");
+
+		timespec currentTime;
+		clock_gettime(CLOCK_MONOTONIC, &currentTime);
+
+		return TimespecToTicks(currentTime) - s_State->StartTicks;
+	}
+
+	void SleepFor(u64 nanoseconds)
+	{
+		timespec duration;
+		duration.tv_sec = static_cast<time_t>(nanoseconds / Time::TICKS_PER_SECOND);
+		duration.tv_nsec = static_cast<long>(nanoseconds % Time::TICKS_PER_SECOND);
+		// Resume after signals, the quit signal is handled in PumpMessage.
+		while (nanosleep(&duration, &duration) != 0 && errno == EINTR)
+		{
+		}
+	}
+
+	void* CustomAllocate(size_t size) {
+		return malloc(size);
+	}
+
+	void* CustomRealloc(void* mem, size_t size) {
+		return realloc(mem, size);
+	}
+
+	void CustomFree(void* mem) {
+		free(mem);
+	}
+
+	void* AllocatePages(size_t size) {
+		return MapAlignedPages(RoundUpToPages(size), PAGE_ALIGNMENT);
+	}
+
+	void FreePages(void* mem, size_t size) {
+		munmap(mem, RoundUpToPages(size));
+	}
+
+	void* AllocateHugePages(size_t size) {
+		size_t hugePageSize = GetHugePageSize();
+		size = (size + hugePageSize - 1) & ~(hugePageSize - 1);
+
+		// Explicit huge pages only exist when they were reserved through vm.nr_hugepages, use them while the pool lasts.
+		void* mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (mem != MAP_FAILED)
+			return mem;
+
+		// Otherwise ask for transparent huge pages, the kernel only uses them for huge page aligned ranges.
+		// The advice fails when transparent huge pages are turned off, the range then simply keeps regular pages.
+		mem = MapAlignedPages(size, hugePageSize);
+		if (mem != nullptr)
+		{
+			madvise(mem, size, MADV_HUGEPAGE);
+		}
+		return mem;
+	}
+
+	void FreeHugePages(void* mem, size_t size) {
+		size_t hugePageSize = GetHugePageSize();
+		munmap(mem, (size + hugePageSize - 1) & ~(hugePageSize - 1));
+	}
+
+	size_t GetHugePageSize() {
+		static const size_t hugePageSize = QueryHugePageSize();
+		return hugePageSize;
+	}
+
+	u32 CaptureCallStack(void** frames, u32 maxFrames) {
+		void* callStack[MAX_CALL_STACK_FRAMES + 1];
+		u32 numFrames = maxFrames < MAX_CALL_STACK_FRAMES ? maxFrames : MAX_CALL_STACK_FRAMES;
+		int depth = backtrace(callStack, static_cast<int>(numFrames + 1));
+		if (depth <= 1)
+			return 0;
+
+		// Skip this function itself.
+		for (int i = 1; i < depth; i++)
+		{
+			frames[i - 1] = callStack[i];
+		}
+		return static_cast<u32>(depth - 1);
+	}
+
+	std::string GetSymbolName(void* address) {
+		char result[1024];
+
+		Dl_info info{};
+		if (dladdr(address, &info) == 0 || info.dli_sname == nullptr)
+		{
+			snprintf(result, sizeof(result), "0x%llx (%s)",
+				static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(address)), info.dli_fname != nullptr ? info.dli_fname : "?");
+			return result;
+		}
+
+		int status = 0;
+		char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+		uintptr_t displacement = reinterpret_cast<uintptr_t>(address) - reinterpret_cast<uintptr_t>(info.dli_saddr);
+		snprintf(result, sizeof(result), "%s + 0x%llx", status == 0 ? demangled : info.dli_sname, static_cast<unsigned long long>(displacement));
+		free(demangled);
+		return result;
+	}
+
+	std::string GetLocalPath(std::string filePath)
+	{
+		ASSERT(s_State != nullptr);
+
+		return s_State->Info.WorkingDir+filePath;
+	}
+
+	bool MapFile(const std::string& filePath, FileMapping& outMapping)
+	{
+		outMapping = FileMapping();
+
+		int file = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+		if (file < 0)
+			return false;
+
+		struct stat fileStat;
+		if (fstat(file, &fileStat) != 0 || !S_ISREG(fileStat.st_mode))
+		{
+			close(file);
+			return false;
+		}
+
+		if (fileStat.st_size == 0)
+		{
+			close(file);
+			return true;
+		}
+
+		size_t size = static_cast<size_t>(fileStat.st_size);
+		void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+		// The mapping keeps the file alive on its own.
+		close(file);
+		if (data == MAP_FAILED)
+			return false;
+
+		// Assets are mostly parsed front to back, let the kernel read ahead.
+		madvise(data, size, MADV_SEQUENTIAL);
+
+		outMapping.Data = data;
+		outMapping.Size = static_cast<u64>(size);
+		return true;
+	}
+
+	void UnmapFile(FileMapping& mapping)
+	{
+		if (mapping.Data != nullptr)
+		{
+			munmap(const_cast<void*>(mapping.Data), static_cast<size_t>(mapping.Size));
+		}
+		mapping = FileMapping();
+	}
+
+	const CPUTopology& GetCPUTopology()
+	{
+		static const CPUTopology topology = QueryCPUTopology();
+		return topology;
+	}
+
+	bool SetCurrentThreadAffinity(const std::vector<u32>& logicalCores)
+	{
+		cpu_set_t cores;
+		CPU_ZERO(&cores);
+		if (logicalCores.empty())
+		{
+			for (const LogicalCore& core : GetCPUTopology().LogicalCores)
+			{
+				CPU_SET(core.Index, &cores);
+			}
+		}
+		for (u32 index : logicalCores)
+		{
+			if (index >= CPU_SETSIZE)
+				return false;
+			CPU_SET(index, &cores);
+		}
+
+		return pthread_setaffinity_np(pthread_self(), sizeof(cores), &cores) == 0;
+	}
+
+	void SetCurrentThreadName(const std::string& name)
+	{
+		// Longer names are rejected instead of truncated.
+		pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+	}
+
+}
+
+namespace Logger
+{
+
+	void ConsoleWrite(char* msg, Logger::eLogLevel level)
+	{
+		// Same colors as the Windows console: fatal on red, error red, warn yellow, info green, debug cyan, trace gray.
+		static const char* colors[6] = { "\x1b[97;41m", "\x1b[31m", "\x1b[33m", "\x1b[32m", "\x1b[96m", "\x1b[90m" };
+		FILE* stream = level <= LOG_LEVEL_ERROR ? stderr : stdout;
+		fprintf(stream, "%s%s\x1b[0m", colors[level], msg);
+	}
+
+} }
+
+#endif // __linux__
@@ -4,6 +4,7 @@
 #include "Core/Event.h"
 #include "Core/Input.h"
 #include "Core/Asserts.h"
+#include "Core/Time.h"
 
 // Windows Includes
 #ifndef UNICODE
@@ -11,7 +12,18 @@
 #endif 
 #include <Windows.h>
 #include <Windowsx.h>
+#include <DbgHelp.h>
 
+#pragma comment(lib, "dbghelp.lib")
+
+// Older SDKs do not define it, CreateWaitableTimerExW fails on Windows versions that do not support it.
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
 #include <vector>
 
 #include <backends/imgui_impl_win32.h>
@@ -33,9 +45,217 @@ namespace Gecko { namespace Platform
 
 			AppInfo Info;
 			bool IsClosed = false;
+
+			LARGE_INTEGER Frequency{};
+			LARGE_INTEGER StartCounter{};
+			// High resolution waitable timer for SleepFor, nullptr before Windows 10 1803 where Sleep is used instead.
+			HANDLE SleepTimer{ nullptr };
 		};
 
 		static Scope<PlatformState> s_State{ nullptr };
+
+		constexpr size_t DEFAULT_HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+		// Large pages need the "Lock pages in memory" privilege, which is not enabled in the token by default even when the user holds it.
+		bool EnableLargePages()
+		{
+			if (GetLargePageMinimum() == 0)
+				return false;
+
+			HANDLE token;
+			if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token))
+				return false;
+
+			TOKEN_PRIVILEGES privileges{};
+			privileges.PrivilegeCount = 1;
+			privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+			bool enabled = LookupPrivilegeValueW(nullptr, SE_LOCK_MEMORY_NAME, &privileges.Privileges[0].Luid)
+				&& AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr)
+				&& GetLastError() == ERROR_SUCCESS;
+			CloseHandle(token);
+			return enabled;
+		}
+
+		// Windows numbers processors per group of 64, LogicalCore::Index is group * 64 + number.
+		constexpr u32 PROCESSORS_PER_GROUP = 64;
+
+		using SetThreadDescriptionFunction = HRESULT(WINAPI*)(HANDLE, PCWSTR);
+
+		LogicalCore* FindLogicalCore(CPUTopology& topology, u32 index)
+		{
+			for (LogicalCore& core : topology.LogicalCores)
+			{
+				if (core.Index == index)
+					return &core;
+			}
+			return nullptr;
+		}
+
+		template<typename Function>
+		void ForEachLogicalCore(CPUTopology& topology, const GROUP_AFFINITY& affinity, Function function)
+		{
+			for (u32 bit = 0; bit < PROCESSORS_PER_GROUP; bit++)
+			{
+				if ((affinity.Mask & (static_cast<KAFFINITY>(1) << bit)) == 0)
+					continue;
+
+				LogicalCore* core = FindLogicalCore(topology, affinity.Group * PROCESSORS_PER_GROUP + bit);
+				if (core != nullptr)
+				{
+					function(*core);
+				}
+			}
+		}
+
+		// Replaces the raw ids with indices from 0 without gaps, returns the number of distinct ids.
+		u32 Renumber(std::vector<LogicalCore>& cores, u32 LogicalCore::* member)
+		{
+			std::vector<u32> ids;
+			for (const LogicalCore& core : cores)
+			{
+				ids.push_back(core.*member);
+			}
+			std::sort(ids.begin(), ids.end());
+			ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+			for (LogicalCore& core : cores)
+			{
+				core.*member = static_cast<u32>(std::lower_bound(ids.begin(), ids.end(), core.*member) - ids.begin());
+			}
+			return static_cast<u32>(ids.size());
+		}
+
+		CPUTopology QueryCPUTopology()
+		{
+			CPUTopology topology;
+
+			DWORD length = 0;
+			GetLogicalProcessorInformationEx(RelationAll, nullptr, &length);
+			std::vector<u8> buffer(length);
+			if (length == 0 || !GetLogicalProcessorInformationEx(RelationAll, reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer.data()), &length))
+			{
+				SYSTEM_INFO systemInfo;
+				GetSystemInfo(&systemInfo);
+				for (u32 i = 0; i < systemInfo.dwNumberOfProcessors; i++)
+				{
+					LogicalCore core;
+					core.Index = i;
+					core.PhysicalCore = i;
+					core.CacheGroup = i;
+					topology.LogicalCores.push_back(core);
+				}
+				topology.NumLogicalCores = static_cast<u32>(topology.LogicalCores.size());
+				topology.NumPhysicalCores = topology.NumLogicalCores;
+				topology.NumCacheGroups = topology.NumLogicalCores;
+				return topology;
+			}
+
+			// The process affinity mask only covers the primary group, it is honoured on machines with a single group.
+			DWORD_PTR processMask = 0;
+			DWORD_PTR systemMask = 0;
+			bool filterByProcessMask = GetActiveProcessorGroupCount() == 1 && GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask);
+
+			// Logical cores first, the other relations refer to them.
+			u32 numPhysicalCores = 0;
+			for (DWORD offset = 0; offset < length;)
+			{
+				const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* info = reinterpret_cast<const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data() + offset);
+				offset += info->Size;
+				if (info->Relationship != RelationProcessorCore)
+					continue;
+
+				for (WORD group = 0; group < info->Processor.GroupCount; group++)
+				{
+					const GROUP_AFFINITY& affinity = info->Processor.GroupMask[group];
+					for (u32 bit = 0; bit < PROCESSORS_PER_GROUP; bit++)
+					{
+						KAFFINITY coreMask = static_cast<KAFFINITY>(1) << bit;
+						if ((affinity.Mask & coreMask) == 0 || (filterByProcessMask && (processMask & coreMask) == 0))
+							continue;
+
+						LogicalCore core;
+						core.Index = affinity.Group * PROCESSORS_PER_GROUP + bit;
+						core.PhysicalCore = numPhysicalCores;
+						core.CacheGroup = core.Index;
+						topology.LogicalCores.push_back(core);
+					}
+				}
+				numPhysicalCores++;
+			}
+			std::sort(topology.LogicalCores.begin(), topology.LogicalCores.end(), [](const LogicalCore& a, const LogicalCore& b) { return a.Index < b.Index; });
+			if (topology.LogicalCores.empty())
+			{
+				topology.LogicalCores.push_back(LogicalCore());
+			}
+
+			u32 numPackages = 0;
+			u32 numCaches = 0;
+			u32 lastLevel = 0;
+			const u32 firstCore = topology.LogicalCores.front().Index;
+			for (DWORD offset = 0; offset < length;)
+			{
+				const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* info = reinterpret_cast<const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data() + offset);
+				offset += info->Size;
+
+				if (info->Relationship == RelationProcessorPackage)
+				{
+					for (WORD group = 0; group < info->Processor.GroupCount; group++)
+					{
+						ForEachLogicalCore(topology, info->Processor.GroupMask[group], [numPackages](LogicalCore& core) { core.Package = numPackages; });
+					}
+					numPackages++;
+				}
+				else if (info->Relationship == RelationNumaNode)
+				{
+					u32 node = info->NumaNode.NodeNumber;
+					ForEachLogicalCore(topology, info->NumaNode.GroupMask, [node](LogicalCore& core) { core.NUMANode = node; });
+				}
+				else if (info->Relationship == RelationCache && info->Cache.Type != CacheInstruction && info->Cache.Type != CacheTrace)
+				{
+					const GROUP_AFFINITY& affinity = info->Cache.GroupMask;
+
+					u32 numSharingCores = 0;
+					ForEachLogicalCore(topology, affinity, [&numSharingCores](LogicalCore&) { numSharingCores++; });
+
+					// The last level cache decides the cache groups, raw ids start past the core indices so they cannot collide.
+					u32 level = info->Cache.Level;
+					if (level >= lastLevel)
+					{
+						if (level > lastLevel)
+						{
+							numCaches = 0;
+						}
+						lastLevel = level;
+						u32 cacheGroup = (PROCESSORS_PER_GROUP << 16) + numCaches++;
+						ForEachLogicalCore(topology, affinity, [cacheGroup](LogicalCore& core) { core.CacheGroup = cacheGroup; });
+					}
+
+					if (affinity.Group * PROCESSORS_PER_GROUP <= firstCore && firstCore < (affinity.Group + 1u) * PROCESSORS_PER_GROUP
+						&& (affinity.Mask & (static_cast<KAFFINITY>(1) << (firstCore % PROCESSORS_PER_GROUP))) != 0)
+					{
+						CPUCache cache;
+						cache.Level = level;
+						cache.Size = info->Cache.CacheSize;
+						cache.LineSize = info->Cache.LineSize;
+						cache.NumSharingCores = numSharingCores > 0 ? numSharingCores : 1;
+						topology.Caches.push_back(cache);
+					}
+				}
+			}
+
+			std::sort(topology.Caches.begin(), topology.Caches.end(), [](const CPUCache& a, const CPUCache& b) { return a.Level < b.Level; });
+			if (!topology.Caches.empty())
+			{
+				topology.CacheLineSize = topology.Caches.front().LineSize;
+			}
+
+			topology.NumLogicalCores = static_cast<u32>(topology.LogicalCores.size());
+			topology.NumPhysicalCores = Renumber(topology.LogicalCores, &LogicalCore::PhysicalCore);
+			topology.NumPackages = Renumber(topology.LogicalCores, &LogicalCore::Package);
+			topology.NumNUMANodes = Renumber(topology.LogicalCores, &LogicalCore::NUMANode);
+			topology.NumCacheGroups = Renumber(topology.LogicalCores, &LogicalCore::CacheGroup);
+			return topology;
+		}
 	}
 
 	bool Init(AppInfo& info)
@@ -46,6 +266,10 @@ namespace Gecko { namespace Platform
 
 		s_State->Info = info;
 
+		QueryPerformanceFrequency(&s_State->Frequency);
+		QueryPerformanceCounter(&s_State->StartCounter);
+		s_State->SleepTimer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+
 		// Create Instance and class
 		{
 			s_State->Instance = GetModuleHandleA(0);
@@ -113,6 +337,10 @@ namespace Gecko { namespace Platform
 	void Shutdown()
 	{
 		ASSERT_MSG(s_State != nullptr, "Cannot shutdown platform if platform isn't initialized!");
+		if (s_State->SleepTimer != nullptr)
+		{
+			CloseHandle(s_State->SleepTimer);
+		}
 		s_State.release();
 	}
 	
@@ -172,7 +400,7 @@ namespace Gecko { namespace Platform
 
 				data.Data.u32[0] = (u16)width;
 				data.Data.u32[1] = (u16)height;
-				Event::FireEvent(Event::SystemEvent::CODE_RESIZED, data);
+				Event::PostEvent(Event::SystemEvent::CODE_RESIZED, data);
 
 			} break;
 			case WM_KEYDOWN:
@@ -199,7 +427,7 @@ namespace Gecko { namespace Platform
 
 				data.Data.u32[0] = static_cast<u32>(key);
 
-				Event::FireEvent(pressed ? Event::SystemEvent::CODE_KEY_PRESSED : Event::SystemEvent::CODE_KEY_RELEASED, data);
+				Event::PostEvent(pressed ? Event::SystemEvent::CODE_KEY_PRESSED : Event::SystemEvent::CODE_KEY_RELEASED, data);
 
 				return 0;
 			} break;
@@ -212,7 +440,7 @@ namespace Gecko { namespace Platform
 				data.Data.i32[1] = y;
 
 				// Pass over to the input subsystem.
-				Event::FireEvent(Event::SystemEvent::CODE_MOUSE_MOVED, data);
+				Event::PostEvent(Event::SystemEvent::CODE_MOUSE_MOVED, data);
 			} break;
 			case WM_MOUSEWHEEL:
 			{
@@ -221,7 +449,7 @@ namespace Gecko { namespace Platform
 					// Flatten the input to an OS-independent (-1, 1)
 					z_delta = (z_delta < 0) ? -1 : 1;
 					data.Data.i32[0] = z_delta;
-					Event::FireEvent(Event::SystemEvent::CODE_MOUSE_MOVED, data);
+					Event::PostEvent(Event::SystemEvent::CODE_MOUSE_WHEEL, data);
 				}
 			} break;
 			case WM_LBUTTONDOWN:
@@ -251,7 +479,7 @@ namespace Gecko { namespace Platform
 				// Pass over to the input subsystem.
 				if (mouse_button != Input::MouseButton::MAX_BUTTONS)
 				{
-					Event::FireEvent(pressed ? Event::SystemEvent::CODE_BUTTON_PRESSED : Event::SystemEvent::CODE_BUTTON_RELEASED, data);
+					Event::PostEvent(pressed ? Event::SystemEvent::CODE_BUTTON_PRESSED : Event::SystemEvent::CODE_BUTTON_RELEASED, data);
 				}
 			} break;
 			}
@@ -267,26 +495,40 @@ namespace Gecko { namespace Platform
 	}
 
 	float GetTime()
+	{
+		return static_cast<float>(Time::ToSeconds(GetTicks()));
+	}
+
+	u64 GetTicks()
 	{
 		ASSERT_MSG(s_State != nullptr, "Platform state not initialized, did you not initialize platform?");
-		
-		static LARGE_INTEGER frequency;
-		static LARGE_INTEGER startTime;
-		static bool initialized = false;
-
-		if (!initialized) {
-			QueryPerformanceFrequency(&frequency);
-			QueryPerformanceCounter(&startTime);
-			initialized = true;
-		}
 
 		LARGE_INTEGER currentTime;
 		QueryPerformanceCounter(&currentTime);
 
-		// Calculate the elapsed time in seconds
-		double elapsedTime = static_cast<double>(currentTime.QuadPart - startTime.QuadPart) / frequency.QuadPart;
+		// Split into whole seconds and the remainder, multiplying the raw count by a billion overflows after a few days.
+		u64 elapsed = static_cast<u64>(currentTime.QuadPart - s_State->StartCounter.QuadPart);
+		u64 frequency = static_cast<u64>(s_State->Frequency.QuadPart);
+		return (elapsed / frequency) * Time::TICKS_PER_SECOND + (elapsed % frequency) * Time::TICKS_PER_SECOND / frequency;
+	}
 
-		return static_cast<float>(elapsedTime);
+	void SleepFor(u64 nanoseconds)
+	{
+		ASSERT_MSG(s_State != nullptr, "Platform state not initialized, did you not initialize platform?");
+
+		if (s_State->SleepTimer != nullptr)
+		{
+			// Negative due times are relative, in 100 nanosecond units.
+			LARGE_INTEGER dueTime;
+			dueTime.QuadPart = -static_cast<LONGLONG>((nanoseconds + 99) / 100);
+			if (SetWaitableTimer(s_State->SleepTimer, &dueTime, 0, nullptr, nullptr, FALSE))
+			{
+				WaitForSingleObject(s_State->SleepTimer, INFINITE);
+				return;
+			}
+		}
+
+		Sleep(static_cast<DWORD>((nanoseconds + Time::TICKS_PER_MILLISECOND - 1) / Time::TICKS_PER_MILLISECOND));
 	}
 
 	void* CustomAllocate(size_t size) {
@@ -300,6 +542,87 @@ namespace Gecko { namespace Platform
 	void CustomFree(void* mem) {
 		free(mem);
 	}
+
+	void* AllocatePages(size_t size) {
+		// VirtualAlloc reservations are aligned to the 64 KiB allocation granularity.
+		return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+	}
+
+	void FreePages(void* mem, size_t size) {
+		(void)size;
+		VirtualFree(mem, 0, MEM_RELEASE);
+	}
+
+	void* AllocateHugePages(size_t size) {
+		// Cleared after the first attempt that fails for lack of the privilege, regular pages are used from then on.
+		static std::atomic<bool> largePagesAvailable{ EnableLargePages() };
+
+		size_t hugePageSize = GetHugePageSize();
+		size = (size + hugePageSize - 1) & ~(hugePageSize - 1);
+
+		if (largePagesAvailable.load(std::memory_order_relaxed))
+		{
+			void* mem = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+			if (mem != nullptr)
+				return mem;
+
+			if (GetLastError() == ERROR_PRIVILEGE_NOT_HELD)
+			{
+				largePagesAvailable.store(false, std::memory_order_relaxed);
+			}
+		}
+		return AllocatePages(size);
+	}
+
+	void FreeHugePages(void* mem, size_t size) {
+		FreePages(mem, size);
+	}
+
+	size_t GetHugePageSize() {
+		static const size_t hugePageSize = GetLargePageMinimum() > 0 ? GetLargePageMinimum() : DEFAULT_HUGE_PAGE_SIZE;
+		return hugePageSize;
+	}
+
+	u32 CaptureCallStack(void** frames, u32 maxFrames) {
+		return static_cast<u32>(CaptureStackBackTrace(1, maxFrames, frames, nullptr));
+	}
+
+	std::string GetSymbolName(void* address) {
+		static bool symbolsInitialized = false;
+		if (!symbolsInitialized)
+		{
+			SymSetOptions(SYMOPT_UNDNAME | SYMOPT_DEFERRED_LOADS | SYMOPT_LOAD_LINES);
+			SymInitialize(GetCurrentProcess(), nullptr, TRUE);
+			symbolsInitialized = true;
+		}
+
+		DWORD64 symbolAddress = reinterpret_cast<DWORD64>(address);
+		char buffer[sizeof(SYMBOL_INFO) + MAX_SYM_NAME];
+		SYMBOL_INFO* symbol = reinterpret_cast<SYMBOL_INFO*>(buffer);
+		symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+		symbol->MaxNameLen = MAX_SYM_NAME;
+
+		char result[1024];
+		DWORD64 displacement = 0;
+		if (!SymFromAddr(GetCurrentProcess(), symbolAddress, &displacement, symbol))
+		{
+			snprintf(result, sizeof(result), "0x%llx", static_cast<unsigned long long>(symbolAddress));
+			return result;
+		}
+
+		IMAGEHLP_LINE64 line{};
+		line.SizeOfStruct = sizeof(IMAGEHLP_LINE64);
+		DWORD lineDisplacement = 0;
+		if (SymGetLineFromAddr64(GetCurrentProcess(), symbolAddress, &lineDisplacement, &line))
+		{
+			snprintf(result, sizeof(result), "%s (%s:%lu)", symbol->Name, line.FileName, line.LineNumber);
+		}
+		else
+		{
+			snprintf(result, sizeof(result), "%s + 0x%llx", symbol->Name, static_cast<unsigned long long>(displacement));
+		}
+		return result;
+	}
 	
 	std::string GetLocalPath(std::string filePath)
 	{
@@ -308,6 +631,102 @@ namespace Gecko { namespace Platform
 		return s_State->Info.WorkingDir+filePath;
 	}
 
+	bool MapFile(const std::string& filePath, FileMapping& outMapping)
+	{
+		outMapping = FileMapping();
+
+		HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize))
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		// CreateFileMapping refuses empty files.
+		if (fileSize.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return true;
+		}
+
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		// The mapping keeps the file alive on its own.
+		CloseHandle(file);
+		if (mapping == nullptr)
+			return false;
+
+		const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (data == nullptr)
+		{
+			CloseHandle(mapping);
+			return false;
+		}
+
+		outMapping.Data = data;
+		outMapping.Size = static_cast<u64>(fileSize.QuadPart);
+		outMapping.Handle = mapping;
+		return true;
+	}
+
+	void UnmapFile(FileMapping& mapping)
+	{
+		if (mapping.Data != nullptr)
+		{
+			UnmapViewOfFile(mapping.Data);
+		}
+		if (mapping.Handle != nullptr)
+		{
+			CloseHandle(mapping.Handle);
+		}
+		mapping = FileMapping();
+	}
+
+	const CPUTopology& GetCPUTopology()
+	{
+		static const CPUTopology topology = QueryCPUTopology();
+		return topology;
+	}
+
+	bool SetCurrentThreadAffinity(const std::vector<u32>& logicalCores)
+	{
+		if (logicalCores.empty())
+		{
+			DWORD_PTR processMask = 0;
+			DWORD_PTR systemMask = 0;
+			if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+				return false;
+			return SetThreadAffinityMask(GetCurrentThread(), processMask) != 0;
+		}
+
+		// A thread can only be pinned to cores of a single group.
+		GROUP_AFFINITY affinity{};
+		affinity.Group = static_cast<WORD>(logicalCores.front() / PROCESSORS_PER_GROUP);
+		for (u32 index : logicalCores)
+		{
+			if (index / PROCESSORS_PER_GROUP != affinity.Group)
+				return false;
+			affinity.Mask |= static_cast<KAFFINITY>(1) << (index % PROCESSORS_PER_GROUP);
+		}
+
+		return SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != 0;
+	}
+
+	void SetCurrentThreadName(const std::string& name)
+	{
+		// SetThreadDescription only exists since Windows 10 1607, older versions keep the thread unnamed.
+		static SetThreadDescriptionFunction setThreadDescription = reinterpret_cast<SetThreadDescriptionFunction>(
+			reinterpret_cast<void*>(GetProcAddress(GetModuleHandleW(L"kernel32.dll"), "SetThreadDescription")));
+		if (setThreadDescription == nullptr)
+			return;
+
+		std::wstring wideName(name.begin(), name.end());
+		setThreadDescription(GetCurrentThread(), wideName.c_str());
+	}
+
 } 
 
 namespace Logger
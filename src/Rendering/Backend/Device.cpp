@@ -1,6 +1,7 @@
 #include "Rendering/Backend/Device.h"
 
 #include "Rendering/Backend/CommandList.h"
+#include "Rendering/Null/Device_Null.h"
 
 #ifdef WIN32
 #include "Rendering/DX12/Device_DX12.h"
@@ -17,6 +18,9 @@ namespace Gecko {
 		case RenderAPI::None:
 			ASSERT_MSG(false, "No RenderAPI is selected");
 			break;
+		case RenderAPI::Null:
+			return CreateRef<Null::Device_Null>();
+			break;
 #ifdef WIN32
 		case RenderAPI::DX12:
 			return CreateRef<DX12::Device_DX12>();
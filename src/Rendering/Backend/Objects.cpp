@@ -1,5 +1,6 @@
 #include "Rendering/Backend/Objects.h"
 
+#include <algorithm>
 #include <cmath>
 
 namespace Gecko {
@@ -9,6 +10,44 @@ namespace Gecko {
 		return 1+static_cast<u32>(std::log2(static_cast<float>(std::max(width, height))));
 	}
 
+	u64 CalculateTextureSizeInBytes(const TextureDesc& textureDesc)
+	{
+		if (textureDesc.Format == Format::None)
+			return 0;
+
+		u64 size = 0;
+		u64 width = textureDesc.Width;
+		u64 height = textureDesc.Height;
+		u64 depth = textureDesc.Depth;
+		for (u32 mip = 0; mip < textureDesc.NumMips; mip++)
+		{
+			size += width * height * depth;
+			width = std::max<u64>(1, width >> 1);
+			height = std::max<u64>(1, height >> 1);
+			depth = std::max<u64>(1, depth >> 1);
+		}
+
+		return size * FormatSizeInBytes(textureDesc.Format) * std::max(1u, textureDesc.NumArraySlices);
+	}
+
+	u64 CalculateRenderTargetSizeInBytes(const RenderTargetDesc& renderTargetDesc)
+	{
+		u64 pixelSize = 0;
+		for (u32 i = 0; i < renderTargetDesc.NumRenderTargets; i++)
+		{
+			if (renderTargetDesc.RenderTargetFormats[i] != Format::None)
+			{
+				pixelSize += FormatSizeInBytes(renderTargetDesc.RenderTargetFormats[i]);
+			}
+		}
+		if (renderTargetDesc.DepthStencilFormat != Format::None)
+		{
+			pixelSize += FormatSizeInBytes(renderTargetDesc.DepthStencilFormat);
+		}
+
+		return pixelSize * renderTargetDesc.Width * renderTargetDesc.Height;
+	}
+
 	u32 FormatSizeInBytes(const Format& format)
 	{
 		switch (format)
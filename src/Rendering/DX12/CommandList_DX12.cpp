@@ -262,7 +262,7 @@ namespace Gecko { namespace DX12 {
 			renderTargetDX12->DepthBufferResource != nullptr ? &renderTargetDX12->dsv.CPU : nullptr);
 	}
 
-	void CommandList_DX12::BindVertexBuffer(VertexBuffer vertexBuffer)
+	void CommandList_DX12::BindVertexBuffer(const VertexBuffer& vertexBuffer)
 	{
 		ASSERT_MSG(m_BoundPipelineType == PipelineType::Graphics, "Graphics pipeline needs to be bound for this!");
 		VertexBuffer_DX12* vertexBuffer_DX12 = (VertexBuffer_DX12*)vertexBuffer.Data.get();
@@ -270,7 +270,7 @@ namespace Gecko { namespace DX12 {
 		CommandBuffer->CommandList->IASetVertexBuffers(0, 1, &vertexBuffer_DX12->VertexBufferView);
 	}
 	
-	void CommandList_DX12::BindIndexBuffer(IndexBuffer indexBuffer)
+	void CommandList_DX12::BindIndexBuffer(const IndexBuffer& indexBuffer)
 	{
 		ASSERT_MSG(m_BoundPipelineType == PipelineType::Graphics, "Graphics pipeline needs to be bound for this!");
 		IndexBuffer_DX12* indexBuffer_DX12 = (IndexBuffer_DX12*)indexBuffer.Data.get();
@@ -490,7 +490,7 @@ namespace Gecko { namespace DX12 {
 		}
 	}
 
-	void CommandList_DX12::BindGraphicsPipeline(GraphicsPipeline graphicsPipeline)
+	void CommandList_DX12::BindGraphicsPipeline(const GraphicsPipeline& graphicsPipeline)
 	{
 		GraphicsPipeline_DX12* graphicsPipeline_DX12 = (GraphicsPipeline_DX12*)graphicsPipeline.Data.get();
 
@@ -503,7 +503,7 @@ namespace Gecko { namespace DX12 {
 		m_GraphicsPipeline = graphicsPipeline;
 	}
 	
-	void CommandList_DX12::BindComputePipeline(ComputePipeline computePipeline)
+	void CommandList_DX12::BindComputePipeline(const ComputePipeline& computePipeline)
 	{
 		ComputePipeline_DX12* computePipeline_DX12 = (ComputePipeline_DX12*)computePipeline.Data.get();
 
@@ -514,7 +514,7 @@ namespace Gecko { namespace DX12 {
 		m_ComputePipeline = computePipeline;
 	}
 
-	void CommandList_DX12::BindRaytracingPipeline(RaytracingPipeline raytracingPipeline)
+	void CommandList_DX12::BindRaytracingPipeline(const RaytracingPipeline& raytracingPipeline)
 	{
 		RaytracingPipeline_DX12* raytracingPipeline_DX12 = (RaytracingPipeline_DX12*)raytracingPipeline.Data.get();
 
@@ -621,7 +621,7 @@ namespace Gecko { namespace DX12 {
 		CommandBuffer->CommandList->DrawInstanced(numVertices, 1, 0, 0);
 	}
 
-	void CommandList_DX12::BindTLAS(TLAS tlas)
+	void CommandList_DX12::BindTLAS(const TLAS& tlas)
 	{
 		TLAS_DX12* tlas_DX12 = (TLAS_DX12*)tlas.Data.get();
 
@@ -34,8 +34,8 @@ namespace Gecko { namespace DX12 {
 		virtual void CopyFromTexture(Texture src, RenderTarget dst, RenderTargetType dstType) override;
 
 		virtual void BindRenderTarget(RenderTarget renderTarget) override;
-		virtual void BindVertexBuffer(VertexBuffer vertexBuffer) override;
-		virtual void BindIndexBuffer(IndexBuffer indexBuffer) override;
+		virtual void BindVertexBuffer(const VertexBuffer& vertexBuffer) override;
+		virtual void BindIndexBuffer(const IndexBuffer& indexBuffer) override;
 		virtual void BindTexture(u32 slot, Texture texture) override;
 		virtual void BindTexture(u32 slot, Texture texture, u32 mipLevel) override;
 		virtual void BindTexture(u32 slot, RenderTarget renderTarget, RenderTargetType type) override;
@@ -44,13 +44,13 @@ namespace Gecko { namespace DX12 {
 		virtual void BindAsRWTexture(u32 slot, Texture texture, u32 mipLevel) override;
 		virtual void BindAsRWTexture(u32 slot, RenderTarget renderTarget, RenderTargetType type) override;
 	
-		virtual void BindGraphicsPipeline(GraphicsPipeline Pipeline) override;
-		virtual void BindComputePipeline(ComputePipeline Pipeline) override;
-		virtual void BindRaytracingPipeline(RaytracingPipeline Pipeline) override;
+		virtual void BindGraphicsPipeline(const GraphicsPipeline& Pipeline) override;
+		virtual void BindComputePipeline(const ComputePipeline& Pipeline) override;
+		virtual void BindRaytracingPipeline(const RaytracingPipeline& Pipeline) override;
 
 		virtual void SetDynamicCallData(u32 size, void* data) override;
 
-		virtual void BindTLAS(TLAS tlas) override;
+		virtual void BindTLAS(const TLAS& tlas) override;
 
 		virtual void Draw(u32 numIndices) override;
 		virtual void DrawAuto(u32 Vertices) override;
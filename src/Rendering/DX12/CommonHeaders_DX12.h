@@ -46,7 +46,7 @@ using ComPtr = Microsoft::WRL::ComPtr<T>;
     mbstowcs_s(&outSize, wc, cSize, name, cSize-1); \
     obj->SetName(wc);                               \
     delete[] wc;                                    \
-    LOG_DEBUG("D3D12 Object Created: %s", name);       \
+    LOG_CHANNEL_DEBUG(DX12, "D3D12 Object Created: %s", name); \
 }
 
 #define NAME_DIRECTX12_OBJECT_INDEXED(obj, n, name)         \
@@ -59,7 +59,7 @@ using ComPtr = Microsoft::WRL::ComPtr<T>;
     if(swprintf_s(outName, L"%s[%u]", wc, n) > 0)           \
     {                                                       \
         obj->SetName(outName);                              \
-        LOG_DEBUG("D3D12 Object Created: %s[%u]", name, n);    \
+        LOG_CHANNEL_DEBUG(DX12, "D3D12 Object Created: %s[%u]", name, n); \
     }                                                       \
     delete[] wc;                                            \
 }
@@ -140,10 +140,6 @@ namespace Gecko { namespace DX12
 			imGuiHandle.GPU
 		);
 
-		ImGui_ImplDX12_NewFrame();
-		ImGui_ImplWin32_NewFrame();
-		ImGui::NewFrame();
-
 	};
 	
 	Device_DX12::~Device_DX12()
@@ -1862,29 +1858,39 @@ namespace Gecko { namespace DX12
 		return true;
 	}
 
-	void Device_DX12::ImGuiRender(Ref<CommandList> commandList)
+	void Device_DX12::ImGuiEndFrame()
 	{
-		// Execute Command list
-		CommandList_DX12& commandListDx12 = *(CommandList_DX12*)commandList.get();
-
 		ImGui::Render();
-		ID3D12DescriptorHeap* heap = m_SrvDescHeap.Heap();
-		commandListDx12.CommandBuffer->CommandList->SetDescriptorHeaps(1, &heap);
-		ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), commandListDx12.CommandBuffer->CommandList.Get());
 
-		// Update and Render additional Platform Windows
+		// Update and Render additional Platform Windows, the backend records and submits them on command lists of its own.
 		ImGuiIO& io = ImGui::GetIO(); (void)io;
 		if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
 		{
 			ImGui::UpdatePlatformWindows();
-			ImGui::RenderPlatformWindowsDefault(NULL, (void*)commandListDx12.CommandBuffer->CommandList.Get());
+			ImGui::RenderPlatformWindowsDefault();
 		}
+	}
 
+	void Device_DX12::ImGuiNewFrame()
+	{
 		ImGui_ImplDX12_NewFrame();
 		ImGui_ImplWin32_NewFrame();
 		ImGui::NewFrame();
 	}
 
+	void Device_DX12::ImGuiRender(Ref<CommandList> commandList, ImDrawData* drawData)
+	{
+		if (drawData == nullptr)
+			return;
+
+		// Execute Command list
+		CommandList_DX12& commandListDx12 = *(CommandList_DX12*)commandList.get();
+
+		ID3D12DescriptorHeap* heap = m_SrvDescHeap.Heap();
+		commandListDx12.CommandBuffer->CommandList->SetDescriptorHeaps(1, &heap);
+		ImGui_ImplDX12_RenderDrawData(drawData, commandListDx12.CommandBuffer->CommandList.Get());
+	}
+
 	void Device_DX12::DrawTextureInImGui(Texture texture, u32 width, u32 height)
 	{
 		Texture_DX12* texture_DX12 = (Texture_DX12*)texture.Data.get();
@@ -1988,12 +1994,12 @@ namespace Gecko { namespace DX12
 		ComPtr<IDXGIAdapter1> adapter = GetAdapter(m_Factory);
 		if (!adapter)
 		{
-			LOG_ERROR("Could not find Adapter!");
+			LOG_CHANNEL_ERROR(DX12, "Could not find Adapter!");
 			return;
 		}
 		DXGI_ADAPTER_DESC1 adapterDesc{};
 		adapter->GetDesc1(&adapterDesc);
-		LOG_DEBUG("Selected Adapter: %ls", adapterDesc.Description);
+		LOG_CHANNEL_DEBUG(DX12, "Selected Adapter: %ls", adapterDesc.Description);
 
 		D3D_FEATURE_LEVEL maxFeatureLevel{ GetMaxFeatureLevel(adapter.Get()) };
 		ASSERT(maxFeatureLevel >= c_MinimumFeatureLevel);
@@ -2024,7 +2030,7 @@ namespace Gecko { namespace DX12
 
 		ComPtr<IDXGIAdapter4> adapter{ nullptr };
 
-		LOG_DEBUG("Going trhough adapters: ");
+		LOG_CHANNEL_DEBUG(DX12, "Going trhough adapters: ");
 		for (u32 i = 0; factory->EnumAdapterByGpuPreference(i, DXGI_GPU_PREFERENCE_HIGH_PERFORMANCE, IID_PPV_ARGS(&adapter)) != DXGI_ERROR_NOT_FOUND; i++)
 		{
 			DXGI_ADAPTER_DESC1 adapterDesc{};
@@ -2321,7 +2327,7 @@ namespace Gecko { namespace DX12
 		Flush();
 		u32 width = data.Data.u32[0];
 		u32 height = data.Data.u32[1];
-		LOG_INFO("Resizeing to: %u, %u", width, height);
+		LOG_CHANNEL_INFO(DX12, "Resizeing to: %u, %u", width, height);
 
 		if (width == 0) width = 1;
 		if (height == 0) height = 1;
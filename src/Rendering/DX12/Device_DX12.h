@@ -179,7 +179,9 @@ namespace Gecko {
 
 			virtual void UploadTextureData(Texture texture, void* Data, u32 mip = 0, u32 slice = 0) override;
 
-			virtual void ImGuiRender(Ref<CommandList> commandList) override;
+			virtual void ImGuiEndFrame() override;
+			virtual void ImGuiNewFrame() override;
+			virtual void ImGuiRender(Ref<CommandList> commandList, ImDrawData* drawData) override;
 			virtual void DrawRenderTargetInImGui(RenderTarget renderTarget, u32 width = 0, u32 height = 0, RenderTargetType type = RenderTargetType::Target0) override;
 			virtual void DrawTextureInImGui(Texture texture, u32 width = 0, u32 height = 0) override;
 
@@ -1,12 +1,23 @@
 #include "Rendering/Frontend/ApplicationContext.h"
 
 #include "Rendering/Backend/Device.h"
+#include "Core/AsyncIO.h"
+#include "Core/FileSystem.h"
+#include "Core/JobSystem.h"
 
 namespace Gecko
 {
 
 void ApplicationContext::Init(Platform::AppInfo& appInfo)
 {
+	// Asset paths are relative to the working directory, mount packs on top of it to override loose files.
+	FileSystem::MountDirectory("", appInfo.WorkingDir);
+	IO::Init();
+	Jobs::Init();
+
+	// Before the device, its resize listener has to run first.
+	m_RenderThread.Init(&m_Renderer);
+
 	m_Device = Gecko::Device::CreateDevice();
 
 	m_ResourceManager.Init(m_Device.get());
@@ -16,12 +27,17 @@ void ApplicationContext::Init(Platform::AppInfo& appInfo)
 
 void ApplicationContext::Shutdown()
 {
+	m_RenderThread.Shutdown();
 	m_SceneManager.Shutdown();
 	m_Renderer.Shutdown();
 	m_ResourceManager.Shutdown();
 
 	m_Device->Destroy();
 	m_Device.reset();
+
+	Jobs::Shutdown();
+	IO::Shutdown();
+	FileSystem::UnmountAll();
 }
 
 }
\ No newline at end of file
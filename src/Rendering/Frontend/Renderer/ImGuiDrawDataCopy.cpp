@@ -0,0 +1,75 @@
+#include "Rendering/Frontend/Renderer/ImGuiDrawDataCopy.h"
+
+#include <cstring>
+
+namespace Gecko
+{
+
+	namespace
+	{
+		// ImVector's assignment frees and reallocates, resizing keeps the capacity of the previous frames.
+		template<typename T>
+		void CopyVector(ImVector<T>& dst, const ImVector<T>& src)
+		{
+			dst.resize(src.Size);
+			if (src.Size > 0)
+			{
+				memcpy(dst.Data, src.Data, static_cast<size_t>(src.size_in_bytes()));
+			}
+		}
+	}
+
+	ImGuiDrawDataCopy::~ImGuiDrawDataCopy()
+	{
+		for (int i = 0; i < m_DrawLists.Size; i++)
+		{
+			IM_DELETE(m_DrawLists[i]);
+		}
+	}
+
+	void ImGuiDrawDataCopy::Copy(const ImDrawData& drawData)
+	{
+		m_DrawData.Clear();
+
+		for (int i = 0; i < drawData.CmdListsCount; i++)
+		{
+			const ImDrawList* src = drawData.CmdLists[i];
+			if (i == m_DrawLists.Size)
+			{
+				m_DrawLists.push_back(IM_NEW(ImDrawList)(src->_Data));
+			}
+
+			ImDrawList* dst = m_DrawLists[i];
+			CopyVector(dst->CmdBuffer, src->CmdBuffer);
+			CopyVector(dst->IdxBuffer, src->IdxBuffer);
+			CopyVector(dst->VtxBuffer, src->VtxBuffer);
+			dst->Flags = src->Flags;
+
+			m_DrawData.CmdLists.push_back(dst);
+		}
+
+		m_DrawData.Valid = drawData.Valid;
+		m_DrawData.CmdListsCount = drawData.CmdListsCount;
+		m_DrawData.TotalIdxCount = drawData.TotalIdxCount;
+		m_DrawData.TotalVtxCount = drawData.TotalVtxCount;
+		m_DrawData.DisplayPos = drawData.DisplayPos;
+		m_DrawData.DisplaySize = drawData.DisplaySize;
+		m_DrawData.FramebufferScale = drawData.FramebufferScale;
+		m_DrawData.OwnerViewport = drawData.OwnerViewport;
+#if IMGUI_VERSION_NUM >= 19200
+		// Texture updates are owned by the context, the renderer backend applies them when it draws this frame.
+		m_DrawData.Textures = drawData.Textures;
+#endif
+	}
+
+	void ImGuiDrawDataCopy::Clear()
+	{
+		m_DrawData.Clear();
+	}
+
+	ImDrawData* ImGuiDrawDataCopy::Get()
+	{
+		return m_DrawData.Valid ? &m_DrawData : nullptr;
+	}
+
+}
@@ -9,7 +9,7 @@
 namespace Gecko
 {
 
-const void BloomPass::Init(Platform::AppInfo& appInfo, ResourceManager* resourceManager)
+void BloomPass::Init(Platform::AppInfo& appInfo, ResourceManager* resourceManager)
 {
 	// BloomDownScale Compute Pipeline
 	{
@@ -122,7 +122,7 @@ const void BloomPass::Init(Platform::AppInfo& appInfo, ResourceManager* resource
 
 }
 
-const void BloomPass::Render(const SceneRenderInfo& sceneRenderInfo, ResourceManager* resourceManager, Ref<CommandList> commandList)
+void BloomPass::Render(const SceneRenderInfo&, ResourceManager* resourceManager, Ref<CommandList> commandList)
 {
 
 	RenderTarget inputTarget = resourceManager->GetRenderTarget(resourceManager->GetRenderTargetHandle("FXAAOutput"));
@@ -130,10 +130,10 @@ const void BloomPass::Render(const SceneRenderInfo& sceneRenderInfo, ResourceMan
 	Texture upSampleTexture = resourceManager->GetTexture(m_UpScaleTextureHandle);
 	RenderTarget outputTarget = resourceManager->GetRenderTarget(m_OutputTargetHandle);
 
-	ComputePipeline BloomDownScale = resourceManager->GetComputePipeline(m_DownScalePipelineHandle);
-	ComputePipeline BloomUpScale = resourceManager->GetComputePipeline(m_UpScalePipelineHandle);
-	ComputePipeline BloomThreshold = resourceManager->GetComputePipeline(m_ThresholdPipelineHandle);
-	ComputePipeline BloomComposite = resourceManager->GetComputePipeline(m_CompositePipelineHandle);
+	const ComputePipeline& BloomDownScale = resourceManager->GetComputePipeline(m_DownScalePipelineHandle);
+	const ComputePipeline& BloomUpScale = resourceManager->GetComputePipeline(m_UpScalePipelineHandle);
+	const ComputePipeline& BloomThreshold = resourceManager->GetComputePipeline(m_ThresholdPipelineHandle);
+	const ComputePipeline& BloomComposite = resourceManager->GetComputePipeline(m_CompositePipelineHandle);
 
 	commandList->CopyFromRenderTarget(
 		inputTarget, Gecko::RenderTargetType::Target0,
@@ -158,8 +158,8 @@ const void BloomPass::Render(const SceneRenderInfo& sceneRenderInfo, ResourceMan
 
 	commandList->BindComputePipeline(BloomDownScale);
 
-	std::vector<u32> widths(downSampleTexture.Desc.NumMips);
-	std::vector<u32> heights(downSampleTexture.Desc.NumMips);
+	u32* widths = AllocateFrameScratch<u32>(downSampleTexture.Desc.NumMips);
+	u32* heights = AllocateFrameScratch<u32>(downSampleTexture.Desc.NumMips);
 	widths[mipLevel] = downSampleTexture.Desc.Width;
 	heights[mipLevel] = downSampleTexture.Desc.Height;
 	while (mipLevel < downSampleTexture.Desc.NumMips - 1)
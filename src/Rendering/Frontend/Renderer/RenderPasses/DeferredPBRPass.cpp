@@ -3,12 +3,13 @@
 #include "Rendering/Backend/CommandList.h"
 
 #include "Rendering/Frontend/ResourceManager/ResourceManager.h"
+#include "Core/FileSystem.h"
 #include <stb_image.h>
 
 namespace Gecko
 {
 
-const void DeferredPBRPass::Init(Platform::AppInfo& appInfo, ResourceManager* resourceManager)
+void DeferredPBRPass::Init(Platform::AppInfo& appInfo, ResourceManager* resourceManager)
 {
 
 	// PBR Compute Pipeline
@@ -60,7 +61,8 @@ const void DeferredPBRPass::Init(Platform::AppInfo& appInfo, ResourceManager* re
 	PBROutputHandle = resourceManager->CreateRenderTarget(PBROutputDesc, "PBROutput", true);
 
 	int width, height, n;
-	unsigned char* image = stbi_load(Platform::GetLocalPath("Assets/BRDF_LUT.png").c_str(), &width, &height, &n, 4);
+	FileSystem::FileView brdfLUTFile = FileSystem::Open("Assets/BRDF_LUT.png");
+	unsigned char* image = stbi_load_from_memory(brdfLUTFile.GetData(), static_cast<int>(brdfLUTFile.GetSize()), &width, &height, &n, 4);
 	Gecko::TextureDesc textureDesc;
 
 	textureDesc.Width = width;
@@ -75,7 +77,7 @@ const void DeferredPBRPass::Init(Platform::AppInfo& appInfo, ResourceManager* re
 	
 }
 
-const void DeferredPBRPass::Render(const SceneRenderInfo& sceneRenderInfo, ResourceManager* resourceManager, Ref<CommandList> commandList)
+void DeferredPBRPass::Render(const SceneRenderInfo& sceneRenderInfo, ResourceManager* resourceManager, Ref<CommandList> commandList)
 {
 
 	RenderTarget GBuffer = resourceManager->GetRenderTarget(resourceManager->GetRenderTargetHandle("GBuffer"));
@@ -84,7 +86,7 @@ const void DeferredPBRPass::Render(const SceneRenderInfo& sceneRenderInfo, Resou
 
 	Texture BRDFLUTTexture = resourceManager->GetTexture(BRDFLUTTextureHandle);
 
-	ComputePipeline PBRPipeline = resourceManager->GetComputePipeline(PBRPipelineHandle);
+	const ComputePipeline& PBRPipeline = resourceManager->GetComputePipeline(PBRPipelineHandle);
 
 	// PBR Deferred rendering pass
 	PBRData pbrData;
@@ -7,7 +7,7 @@
 namespace Gecko
 {
 
-const void FXAAPass::Init(Platform::AppInfo& appInfo, ResourceManager* resourceManager)
+void FXAAPass::Init(Platform::AppInfo& appInfo, ResourceManager* resourceManager)
 {
 	// FXAA Compute Pipeline
 	{
@@ -57,13 +57,13 @@ const void FXAAPass::Init(Platform::AppInfo& appInfo, ResourceManager* resourceM
 
 }
 
-const void FXAAPass::Render(const SceneRenderInfo& sceneRenderInfo, ResourceManager* resourceManager, Ref<CommandList> commandList)
+void FXAAPass::Render(const SceneRenderInfo&, ResourceManager* resourceManager, Ref<CommandList> commandList)
 {
 
 	RenderTarget inputTarget = resourceManager->GetRenderTarget(resourceManager->GetRenderTargetHandle("PBROutput"));
 	RenderTarget outputTarget = resourceManager->GetRenderTarget(m_OutputHandle);
 	
-	ComputePipeline FXAAPipeline = resourceManager->GetComputePipeline(FXAAPipelineHandle);
+	const ComputePipeline& FXAAPipeline = resourceManager->GetComputePipeline(FXAAPipelineHandle);
 
 	commandList->BindComputePipeline(FXAAPipeline);
 
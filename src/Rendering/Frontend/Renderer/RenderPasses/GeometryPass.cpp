@@ -7,7 +7,7 @@
 namespace Gecko
 {
 
-const void GeometryPass::Init(Platform::AppInfo& appInfo, ResourceManager* resourceManager)
+void GeometryPass::Init(Platform::AppInfo& appInfo, ResourceManager* resourceManager)
 {
 	// GBuffer Graphics Pipeline
 	{
@@ -138,12 +138,12 @@ const void GeometryPass::Init(Platform::AppInfo& appInfo, ResourceManager* resou
 
 }
 
-const void GeometryPass::Render(const SceneRenderInfo& sceneRenderInfo, ResourceManager* resourceManager, Ref<CommandList> commandList)
+void GeometryPass::Render(const SceneRenderInfo& sceneRenderInfo, ResourceManager* resourceManager, Ref<CommandList> commandList)
 {
 	RenderTarget OutputTarget = resourceManager->GetRenderTarget(m_OutputHandle);
 
-	GraphicsPipeline CubemapPipeline = resourceManager->GetGraphicsPipeline(CubemapPipelineHandle);
-	GraphicsPipeline GBufferPipeline = resourceManager->GetGraphicsPipeline(GBufferPipelineHandle);
+	const GraphicsPipeline& CubemapPipeline = resourceManager->GetGraphicsPipeline(CubemapPipelineHandle);
+	const GraphicsPipeline& GBufferPipeline = resourceManager->GetGraphicsPipeline(GBufferPipelineHandle);
 
 	// Environment map pass
 	commandList->ClearRenderTarget(OutputTarget);
@@ -164,9 +164,10 @@ const void GeometryPass::Render(const SceneRenderInfo& sceneRenderInfo, Resource
 
 	commandList->BindGraphicsPipeline(GBufferPipeline);
 	commandList->BindConstantBuffer(0, resourceManager->SceneDataBuffer[currentBackBufferIndex]);
-	for (u32 i = 0; i < sceneRenderInfo.RenderObjects.size(); i++)
+	// Only what the camera can see, shadows are drawn from the full list.
+	for (u32 renderObjectIndex : sceneRenderInfo.VisibleRenderObjects)
 	{
-		const RenderObjectRenderInfo& meshInstanceDescriptor = sceneRenderInfo.RenderObjects[i];
+		const RenderObjectRenderInfo& meshInstanceDescriptor = sceneRenderInfo.RenderObjects[renderObjectIndex];
 
 		glm::mat4 transformMatrix = meshInstanceDescriptor.Transform;
 
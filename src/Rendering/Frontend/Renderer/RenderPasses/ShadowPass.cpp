@@ -7,7 +7,7 @@
 namespace Gecko
 {
 
-const void ShadowPass::Init(Platform::AppInfo& appInfo, ResourceManager* resourceManager)
+void ShadowPass::Init(Platform::AppInfo&, ResourceManager* resourceManager)
 {
 	// Shadow map Graphics Pipeline
 	{
@@ -56,10 +56,10 @@ const void ShadowPass::Init(Platform::AppInfo& appInfo, ResourceManager* resourc
 
 }
 
-const void ShadowPass::Render(const SceneRenderInfo& sceneRenderInfo, ResourceManager* resourceManager, Ref<CommandList> commandList)
+void ShadowPass::Render(const SceneRenderInfo& sceneRenderInfo, ResourceManager* resourceManager, Ref<CommandList> commandList)
 {
 	RenderTarget outputTarget = resourceManager->GetRenderTarget(m_OutputHandle);
-	GraphicsPipeline ShadowPipeline = resourceManager->GetGraphicsPipeline(ShadowPipelineHandle);
+	const GraphicsPipeline& ShadowPipeline = resourceManager->GetGraphicsPipeline(ShadowPipelineHandle);
 
 	commandList->ClearRenderTarget(outputTarget);
 
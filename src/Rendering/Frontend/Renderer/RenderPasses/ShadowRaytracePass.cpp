@@ -7,7 +7,7 @@
 namespace Gecko
 {
 
-const void ShadowRaytracePass::Init(Platform::AppInfo& appInfo, ResourceManager* resourceManager)
+void ShadowRaytracePass::Init(Platform::AppInfo& appInfo, ResourceManager* resourceManager)
 {
 	// Shadow map Graphics Pipeline
 	{
@@ -42,7 +42,7 @@ const void ShadowRaytracePass::Init(Platform::AppInfo& appInfo, ResourceManager*
 
 }
 
-const void ShadowRaytracePass::Render(const SceneRenderInfo& sceneRenderInfo, ResourceManager* resourceManager, Ref<CommandList> commandList)
+void ShadowRaytracePass::Render(const SceneRenderInfo& sceneRenderInfo, ResourceManager* resourceManager, Ref<CommandList> commandList)
 {
 	RenderTarget outputTarget = resourceManager->GetRenderTarget(m_OutputHandle);
 	RenderTarget GBuffer = resourceManager->GetRenderTarget(resourceManager->GetRenderTargetHandle("GBuffer"));
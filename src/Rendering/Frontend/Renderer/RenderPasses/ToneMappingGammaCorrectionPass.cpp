@@ -9,7 +9,7 @@
 namespace Gecko
 {
 
-const void ToneMappingGammaCorrectionPass::Init(Platform::AppInfo& appInfo, ResourceManager* resourceManager)
+void ToneMappingGammaCorrectionPass::Init(Platform::AppInfo& appInfo, ResourceManager* resourceManager)
 {
 	// TonemapAndGammaCorrect Compute Pipeline
 	{
@@ -39,12 +39,12 @@ const void ToneMappingGammaCorrectionPass::Init(Platform::AppInfo& appInfo, Reso
 	m_OutputHandle = resourceManager->CreateRenderTarget(renderTargetDesc, "ToneMappingGammaCorrection", true);
 }
 
-const void ToneMappingGammaCorrectionPass::Render(const SceneRenderInfo& sceneRenderInfo, ResourceManager* resourceManager, Ref<CommandList> commandList)
+void ToneMappingGammaCorrectionPass::Render(const SceneRenderInfo&, ResourceManager* resourceManager, Ref<CommandList> commandList)
 {
 	RenderTarget inputTarget = resourceManager->GetRenderTarget(resourceManager->GetRenderTargetHandle("BloomOutput"));
 	RenderTarget outputTarget = resourceManager->GetRenderTarget(m_OutputHandle);
 
-	ComputePipeline TonemapAndGammaCorrectPipeline = resourceManager->GetComputePipeline(TonemapAndGammaCorrectPipelineHandle);
+	const ComputePipeline& TonemapAndGammaCorrectPipeline = resourceManager->GetComputePipeline(TonemapAndGammaCorrectPipelineHandle);
 
 	commandList->BindComputePipeline(TonemapAndGammaCorrectPipeline);
 	commandList->BindAsRWTexture(0, inputTarget, Gecko::RenderTargetType::Target0);
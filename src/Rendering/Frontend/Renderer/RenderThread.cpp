@@ -0,0 +1,191 @@
+#include "Rendering/Frontend/Renderer/RenderThread.h"
+
+#include "Core/Asserts.h"
+#include "Core/AllocationGuard.h"
+#include "Core/Platform.h"
+#include "Core/Threading.h"
+#include "Rendering/Frontend/Renderer/Renderer.h"
+#include "Rendering/Frontend/Scene/Scene.h"
+
+namespace Gecko
+{
+
+	namespace
+	{
+		constexpr size_t SNAPSHOT_ALLOCATOR_BLOCK_SIZE = 1024 * 1024;
+	}
+
+	FrameSnapshot::FrameSnapshot()
+		: Allocator(SNAPSHOT_ALLOCATOR_BLOCK_SIZE, Memory::MemoryTag::Frame)
+	{
+	}
+
+	void FrameSnapshot::Capture(const Scene& scene, Renderer& renderer)
+	{
+		// The old render info points into the allocator, drop it before the memory is reused.
+		RenderInfo.reset();
+		Allocator.Reset();
+
+		RenderInfo.emplace(scene.GetSceneRenderInfo(Allocator));
+		SceneData = renderer.PrepareSceneData(*RenderInfo);
+		renderer.CullScene(*RenderInfo, SceneData);
+
+		if (const ImDrawData* drawData = ImGui::GetDrawData())
+		{
+			UIDrawData.Copy(*drawData);
+		}
+		else
+		{
+			UIDrawData.Clear();
+		}
+	}
+
+	RenderThread::~RenderThread()
+	{
+		ASSERT_MSG(!m_Running, "Render thread still running!");
+	}
+
+	void RenderThread::Init(Renderer* renderer)
+	{
+		m_Renderer = renderer;
+
+		AddEventListener(Event::SystemEvent::CODE_RESIZED, &RenderThread::OnResize);
+	}
+
+	void RenderThread::Shutdown()
+	{
+		if (m_Running)
+		{
+			Stop();
+		}
+
+		RemoveEventListener(Event::SystemEvent::CODE_RESIZED, &RenderThread::OnResize);
+		for (FrameSnapshot& snapshot : m_Snapshots)
+		{
+			snapshot.RenderInfo.reset();
+			snapshot.Allocator.Release();
+			snapshot.UIDrawData.Clear();
+		}
+		m_Renderer = nullptr;
+	}
+
+	void RenderThread::Start()
+	{
+		ASSERT_MSG(m_Renderer != nullptr, "Render thread not initialized!");
+		ASSERT_MSG(!m_Running, "Render thread already running!");
+
+		m_Stop = false;
+		m_Running = true;
+		m_Thread = std::thread(&RenderThread::ThreadMain, this);
+	}
+
+	void RenderThread::Stop()
+	{
+		ASSERT_MSG(m_Running, "Render thread not running!");
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Stop = true;
+		}
+		m_Condition.notify_all();
+		m_Thread.join();
+		m_Running = false;
+	}
+
+	bool RenderThread::IsRunning() const
+	{
+		return m_Running;
+	}
+
+	FrameSnapshot& RenderThread::BeginFrame()
+	{
+		ASSERT_MSG(m_Running, "Render thread not running!");
+
+		u64 waitStart = Platform::GetTicks();
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		// The snapshot was last used two frames ago, once that frame is presented at most one frame is left in flight.
+		u64 frame = m_SubmittedFrames;
+		m_Condition.wait(lock, [this, frame]() { return m_PresentedFrames + 1 >= frame; });
+		m_Stats.MainThreadWait = Platform::GetTicks() - waitStart;
+
+		FrameSnapshot& snapshot = m_Snapshots[frame % 2];
+		snapshot.FrameIndex = frame;
+		return snapshot;
+	}
+
+	void RenderThread::SubmitFrame()
+	{
+		ASSERT_MSG(m_Running, "Render thread not running!");
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_SubmitTicks[m_SubmittedFrames % 2] = Platform::GetTicks();
+			m_SubmittedFrames++;
+		}
+		m_Condition.notify_all();
+	}
+
+	void RenderThread::WaitIdle()
+	{
+		if (!m_Running)
+			return;
+
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_Condition.wait(lock, [this]() { return m_PresentedFrames == m_SubmittedFrames; });
+	}
+
+	RenderThreadStats RenderThread::GetStats() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Stats;
+	}
+
+	void RenderThread::ThreadMain()
+	{
+		Threading::RegisterCurrentThread(Threading::ThreadRole::Render);
+
+		while (true)
+		{
+			u64 waitStart = Platform::GetTicks();
+			u64 frame;
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_Condition.wait(lock, [this]() { return m_SubmittedFrames > m_PresentedFrames || m_Stop; });
+				// Frames submitted before Stop are still rendered.
+				if (m_SubmittedFrames == m_PresentedFrames)
+					return;
+
+				frame = m_PresentedFrames;
+				m_Stats.RenderThreadWait = Platform::GetTicks() - waitStart;
+			}
+
+			FrameSnapshot& snapshot = m_Snapshots[frame % 2];
+			Ref<CommandList> commandList;
+			{
+				Memory::ScopedAllocationGuard allocationGuard("RenderThread::RecordFrame");
+				commandList = m_Renderer->RecordFrame(*snapshot.RenderInfo, snapshot.SceneData);
+				m_Renderer->RecordImGui(commandList, snapshot.UIDrawData.Get());
+			}
+			{
+				Memory::ScopedAllocationGuard allocationGuard("RenderThread::SubmitFrame");
+				m_Renderer->SubmitFrame(commandList);
+				commandList.reset();
+			}
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				m_PresentedFrames++;
+				m_Stats.NumFrames = m_PresentedFrames;
+				m_Stats.FrameLatency = Platform::GetTicks() - m_SubmitTicks[frame % 2];
+			}
+			m_Condition.notify_all();
+		}
+	}
+
+	bool RenderThread::OnResize(const Event::EventData&)
+	{
+		// The device and the resource manager resize the swap chain and the render targets right after this.
+		WaitIdle();
+		return false;
+	}
+
+}
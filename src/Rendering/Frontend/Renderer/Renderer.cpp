@@ -2,6 +2,9 @@
 
 #include "Core/Logger.h"
 #include "Core/Asserts.h"
+#include "Core/LinearAllocator.h"
+#include "Core/AllocationGuard.h"
+#include "Core/TransformKernels.h"
 #include "Rendering/Backend/Device.h"
 #include "Rendering/Backend/CommandList.h"
 #include "Rendering/Frontend/Scene/Scene.h"
@@ -20,6 +23,12 @@ const VertexLayout fullScreenQuadVertexLayout({
 	{Format::R32G32_FLOAT, "POSITION"},
 });
 
+namespace
+{
+	// Render objects culled per kernel call, the scratch arrays live on the stack.
+	constexpr u32 CULL_BATCH_SIZE = 64;
+}
+
 
 void Renderer::Init(Platform::AppInfo& info, ResourceManager* resourceManager, Device* _device)
 {
@@ -98,6 +107,9 @@ void Renderer::Init(Platform::AppInfo& info, ResourceManager* resourceManager, D
 
 		quadMeshHandle = m_ResourceManager->CreateMesh(vertexDesc, indexDesc, false);
 	}
+
+	// Start from the defaults the resource manager filled the constant buffers with.
+	m_SceneData = *m_ResourceManager->SceneData[0];
 }
 
 Renderer::~Renderer()
@@ -113,7 +125,18 @@ void Renderer::Shutdown()
 	m_ResourceManager = nullptr;
 }
 
-void Renderer::RenderScene(const SceneRenderInfo& sceneRenderInfo)
+void Renderer::RenderScene(SceneRenderInfo& sceneRenderInfo)
+{
+	Memory::ScopedAllocationGuard allocationGuard("Renderer::RenderScene");
+
+	const SceneDataStruct& sceneData = PrepareSceneData(sceneRenderInfo);
+	CullScene(sceneRenderInfo, sceneData);
+	Ref<CommandList> commandList = RecordFrame(sceneRenderInfo, sceneData);
+	RecordImGui(commandList, ImGui::GetDrawData());
+	SubmitFrame(commandList);
+}
+
+const SceneDataStruct& Renderer::PrepareSceneData(const SceneRenderInfo& sceneRenderInfo)
 {
 	/*TLASRefitDesc refitDesc;
 
@@ -127,27 +150,114 @@ void Renderer::RenderScene(const SceneRenderInfo& sceneRenderInfo)
 		refitDesc.BLASInstances.push_back({blas, transform});
 	}*/
 
-	u32 currentBackBufferIndex = device->GetCurrentBackBufferIndex();
-
-	// Upload Scene Data for this frame
-	m_ResourceManager->SceneData[currentBackBufferIndex]->useRaytracing = false;
-	m_ResourceManager->SceneData[currentBackBufferIndex]->ViewMatrix = sceneRenderInfo.Camera.View;
-	m_ResourceManager->SceneData[currentBackBufferIndex]->CameraPosition = glm::vec3(m_ResourceManager->SceneData[currentBackBufferIndex]->ViewMatrix * glm::vec4(0.f, 0.f, 0.f, 1.f));
-	m_ResourceManager->SceneData[currentBackBufferIndex]->ViewOrientation = glm::mat4(glm::mat3(m_ResourceManager->SceneData[currentBackBufferIndex]->ViewMatrix));
-	m_ResourceManager->SceneData[currentBackBufferIndex]->InvViewOrientation = glm::inverse(m_ResourceManager->SceneData[currentBackBufferIndex]->ViewOrientation);
-	m_ResourceManager->SceneData[currentBackBufferIndex]->ProjectionMatrix = sceneRenderInfo.Camera.Projection;
-	m_ResourceManager->SceneData[currentBackBufferIndex]->InvViewMatrix = glm::inverse(m_ResourceManager->SceneData[currentBackBufferIndex]->ViewMatrix);
-	m_ResourceManager->SceneData[currentBackBufferIndex]->invProjectionMatrix = glm::inverse(m_ResourceManager->SceneData[currentBackBufferIndex]->ProjectionMatrix);
+	m_SceneData.useRaytracing = false;
+	m_SceneData.ViewMatrix = sceneRenderInfo.Camera.View;
+	m_SceneData.CameraPosition = glm::vec3(m_SceneData.ViewMatrix * glm::vec4(0.f, 0.f, 0.f, 1.f));
+	m_SceneData.ViewOrientation = glm::mat4(glm::mat3(m_SceneData.ViewMatrix));
+	m_SceneData.ProjectionMatrix = sceneRenderInfo.Camera.Projection;
+	m_SceneData.invProjectionMatrix = glm::inverse(m_SceneData.ProjectionMatrix);
 
+	// Everything but the perspective projection is affine and inverted in one go.
+	glm::mat4 affineMatrices[3] = { m_SceneData.ViewOrientation, m_SceneData.ViewMatrix, glm::mat4(1.f) };
+	u32 numAffineMatrices = 2;
 	if (sceneRenderInfo.DirectionalLights.size() > 0)
 	{
 		glm::mat4 LighDirectionMatrix = glm::mat3(sceneRenderInfo.DirectionalLights[0].Transform);
-		LighDirectionMatrix = glm::translate(glm::mat4(1.), m_ResourceManager->SceneData[currentBackBufferIndex]->CameraPosition - m_ResourceManager->SceneData[currentBackBufferIndex]->LightDirection * 50.f) * LighDirectionMatrix;
-		m_ResourceManager->SceneData[currentBackBufferIndex]->ShadowMapProjection = glm::ortho(-30.f, 30.f, -30.f, 30.f, -100.f, 100.f) * glm::inverse(LighDirectionMatrix);
-		m_ResourceManager->SceneData[currentBackBufferIndex]->ShadowMapProjectionInv = glm::inverse(m_ResourceManager->SceneData[currentBackBufferIndex]->ShadowMapProjection);
-		m_ResourceManager->SceneData[currentBackBufferIndex]->LightDirection = glm::normalize(glm::vec3(LighDirectionMatrix * glm::vec4(0., 0., -1., 0.)));
+		affineMatrices[numAffineMatrices++] = glm::translate(glm::mat4(1.), m_SceneData.CameraPosition - m_SceneData.LightDirection * 50.f) * LighDirectionMatrix;
+	}
+	glm::mat4 inverseAffineMatrices[3];
+	Math::InvertAffine(affineMatrices, inverseAffineMatrices, numAffineMatrices);
+	m_SceneData.InvViewOrientation = inverseAffineMatrices[0];
+	m_SceneData.InvViewMatrix = inverseAffineMatrices[1];
+
+	if (sceneRenderInfo.DirectionalLights.size() > 0)
+	{
+		const glm::mat4& LighDirectionMatrix = affineMatrices[2];
+		// The orthographic projection is affine as well.
+		m_SceneData.ShadowMapProjection = glm::ortho(-30.f, 30.f, -30.f, 30.f, -100.f, 100.f) * inverseAffineMatrices[2];
+		Math::InvertAffine(&m_SceneData.ShadowMapProjection, &m_SceneData.ShadowMapProjectionInv, 1);
+		m_SceneData.LightDirection = glm::normalize(glm::vec3(LighDirectionMatrix * glm::vec4(0., 0., -1., 0.)));
+	}
+
+	return m_SceneData;
+}
+
+void Renderer::CullScene(SceneRenderInfo& sceneRenderInfo, const SceneDataStruct& sceneData)
+{
+	const u32 renderObjectCount = static_cast<u32>(sceneRenderInfo.RenderObjects.size());
+	FrameVector<u32>& visibleRenderObjects = sceneRenderInfo.VisibleRenderObjects;
+	visibleRenderObjects.clear();
+	visibleRenderObjects.reserve(renderObjectCount);
+
+	if (!sceneRenderInfo.HasCamera)
+	{
+		for (u32 i = 0; i < renderObjectCount; i++)
+		{
+			visibleRenderObjects.push_back(i);
+		}
+		return;
+	}
+
+	// The shaders project with the inverted camera transform.
+	const Math::Frustum frustum = Math::ExtractFrustum(sceneData.ProjectionMatrix * sceneData.InvViewMatrix);
+
+	// The bounds and transforms are copied out in batches, component by component, as the kernel wants them.
+	f32 components[6][CULL_BATCH_SIZE];
+	glm::mat4 transforms[CULL_BATCH_SIZE];
+	u32 renderObjects[CULL_BATCH_SIZE];
+	u32 visible[CULL_BATCH_SIZE];
+	u32 batchCount = 0;
+
+	Math::BoxArrays boxes;
+	for (u32 component = 0; component < 3; component++)
+	{
+		boxes.Center[component] = components[component];
+		boxes.Extents[component] = components[3 + component];
+	}
+
+	auto cullBatch = [&]()
+		{
+			u32 visibleCount = Math::CullBoxes(frustum, boxes, transforms, batchCount, visible);
+			for (u32 i = 0; i < visibleCount; i++)
+			{
+				visibleRenderObjects.push_back(renderObjects[visible[i]]);
+			}
+			batchCount = 0;
+		};
+
+	for (u32 i = 0; i < renderObjectCount; i++)
+	{
+		const RenderObjectRenderInfo& renderObject = sceneRenderInfo.RenderObjects[i];
+		const Mesh& mesh = m_ResourceManager->GetMesh(renderObject.MeshHandle);
+		if (!mesh.HasBounds)
+		{
+			// The batch goes first to keep the draw order.
+			cullBatch();
+			visibleRenderObjects.push_back(i);
+			continue;
+		}
+
+		for (u32 component = 0; component < 3; component++)
+		{
+			components[component][batchCount] = mesh.Bounds.Center[component];
+			components[3 + component][batchCount] = mesh.Bounds.Extents[component];
+		}
+		transforms[batchCount] = renderObject.Transform;
+		renderObjects[batchCount] = i;
+		if (++batchCount == CULL_BATCH_SIZE)
+		{
+			cullBatch();
+		}
 	}
+	cullBatch();
+}
 
+Ref<CommandList> Renderer::RecordFrame(const SceneRenderInfo& sceneRenderInfo, const SceneDataStruct& sceneData)
+{
+	u32 currentBackBufferIndex = device->GetCurrentBackBufferIndex();
+
+	// Upload Scene Data for this frame
+	*m_ResourceManager->SceneData[currentBackBufferIndex] = sceneData;
 
 	// Create a command list for this frame
 	Gecko::Ref<Gecko::CommandList> commandList = device->CreateGraphicsCommandList();
@@ -160,12 +270,12 @@ void Renderer::RenderScene(const SceneRenderInfo& sceneRenderInfo)
 
 	// Render to the back buffer
 	// TODO: move this to the present function
-	RenderTarget inputTarget = m_ResourceManager->GetRenderTarget(m_ResourceManager->GetRenderTargetHandle("ToneMappingGammaCorrection"));
+	RenderTarget inputTarget = m_ResourceManager->GetRenderTarget(m_OutputTargetHandle);
 	RenderTarget renderTarget = device->GetCurrentBackBuffer();
 	
-	GraphicsPipeline FullScreenTexturePipeline = m_ResourceManager->GetGraphicsPipeline(FullScreenTexturePipelineHandle);
+	const GraphicsPipeline& FullScreenTexturePipeline = m_ResourceManager->GetGraphicsPipeline(FullScreenTexturePipelineHandle);
 	commandList->BindGraphicsPipeline(FullScreenTexturePipeline);
-	Mesh quadMesh = m_ResourceManager->GetMesh(quadMeshHandle);
+	const Mesh& quadMesh = m_ResourceManager->GetMesh(quadMeshHandle);
 	commandList->BindVertexBuffer(quadMesh.VertexBuffer);
 	commandList->BindIndexBuffer(quadMesh.IndexBuffer);
 	commandList->BindTexture(0, inputTarget, Gecko::RenderTargetType::Target0);
@@ -173,13 +283,36 @@ void Renderer::RenderScene(const SceneRenderInfo& sceneRenderInfo)
 
 	commandList->Draw(3);
 
-	// TODO: move this to its own function
-	// Render ImGui
-	commandList->BindRenderTarget(renderTarget);
-	device->ImGuiRender(commandList);
+	return commandList;
+}
+
+void Renderer::BeginImGuiFrame()
+{
+	device->ImGuiNewFrame();
+}
+
+void Renderer::EndImGuiFrame()
+{
+	device->ImGuiEndFrame();
+}
+
+void Renderer::RecordImGui(Ref<CommandList> commandList, ImDrawData* drawData)
+{
+	if (drawData == nullptr)
+		return;
 
+	commandList->BindRenderTarget(device->GetCurrentBackBuffer());
+	device->ImGuiRender(commandList, drawData);
+}
+
+void Renderer::SubmitFrame(Ref<CommandList> commandList)
+{
 	// Execute command list and display it
 	device->ExecuteGraphicsCommandListAndFlip(commandList);
+
+	// Everything allocated for this frame has been recorded, the scene render info must not be used after this.
+	Memory::GetFrameAllocator().Reset();
+	Memory::EndAllocationGuardFrame();
 }
 
 void Renderer::Present() 
@@ -1,9 +1,14 @@
 #include "Rendering/Frontend/ResourceManager/ResourceManager.h"
 
 #include "Rendering/Backend/CommandList.h"
+#include "Core/AsyncIO.h"
+#include "Core/Logger.h"
+#include "Core/Memory.h"
 
 #include <stb_image.h>
 
+#include <limits.h>
+
 namespace Gecko
 {
 
@@ -15,13 +20,36 @@ namespace Gecko
 		u32 Height;
 	};
 
+	struct HDRImage
+	{
+		f32* Data{ nullptr };
+		int Width{ 0 };
+		int Height{ 0 };
+	};
+
+	static void DecodeHDRImage(const IO::IOResult& result, void* userData)
+	{
+		if (result.Status != IO::IOStatus::Completed || result.Size > INT_MAX)
+			return;
+
+		HDRImage* image = static_cast<HDRImage*>(userData);
+		int numComponents;
+		image->Data = stbi_loadf_from_memory(result.Data, static_cast<int>(result.Size), &image->Width, &image->Height, &numComponents, 4);
+	}
+
 	void ResourceManager::Init(Device* device)
 	{
+		Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::ResourceManager);
+
 		m_Device = device;
 		m_CurrentMeshIndex = 0;
 		m_CurrentTextureIndex = 0;
 		m_CurrentMaterialIndex = 0;
 		m_CurrentRenderTargetIndex = 0;
+
+		const Platform::AppInfo& appInfo = Platform::GetAppInfo();
+		m_MemoryBudget.SetLimits(Memory::BudgetType::CPU, appInfo.CPUMemoryBudget);
+		m_MemoryBudget.SetLimits(Memory::BudgetType::GPU, appInfo.GPUMemoryBudget);
 	
 
 		// MipMap Compute Pipeline
@@ -233,11 +261,14 @@ namespace Gecko
 		}
 
 		AddEventListener(Event::SystemEvent::CODE_RESIZED, &ResourceManager::ResizeEvent);
+		AddEventListener(Event::SystemEvent::CODE_MEMORY_PRESSURE, &ResourceManager::MemoryPressureEvent);
 	}
 
 	void ResourceManager::Shutdown()
 	{
 		RemoveEventListener(Event::SystemEvent::CODE_RESIZED, &ResourceManager::ResizeEvent);
+		RemoveEventListener(Event::SystemEvent::CODE_MEMORY_PRESSURE, &ResourceManager::MemoryPressureEvent);
+		m_SkipTextureMips = false;
 
 		m_CurrentMeshIndex = 0;
 		m_CurrentTextureIndex = 0;
@@ -258,16 +289,25 @@ namespace Gecko
 		m_GraphicsPipelines.clear();
 		m_ComputePipelines.clear();
 		m_RaytracePipelines.clear();
+
+		m_MemoryBudget.Reset();
 	}
 
-	MeshHandle ResourceManager::CreateMesh(VertexBufferDesc vertexDesc, IndexBufferDesc indexDesc, bool CreateBLAS)
+	MeshHandle ResourceManager::CreateMesh(VertexBufferDesc vertexDesc, IndexBufferDesc indexDesc, bool CreateBLAS, const BoundingBox* bounds)
 	{
+		Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::ResourceManager);
+
 		MeshHandle handle = m_CurrentMeshIndex;
 
 		Mesh mesh;
 
 		mesh.VertexBuffer = m_Device->CreateVertexBuffer(vertexDesc);
 		mesh.IndexBuffer = m_Device->CreateIndexBuffer(indexDesc);
+		mesh.HasBounds = bounds != nullptr;
+		if (bounds)
+		{
+			mesh.Bounds = *bounds;
+		}
 		mesh.HasBLAS = CreateBLAS;
 		if (CreateBLAS)
 		{
@@ -276,16 +316,30 @@ namespace Gecko
 
 		m_Meshes[handle] = mesh;
 
+		u64 meshSize = static_cast<u64>(vertexDesc.Layout.Stride) * vertexDesc.NumVertices +
+			static_cast<u64>(FormatSizeInBytes(indexDesc.IndexFormat)) * indexDesc.NumIndices;
+		m_MemoryBudget.TrackGPU(Memory::GPUResourceCategory::Mesh, static_cast<i64>(meshSize));
+
 		m_CurrentMeshIndex++;
 		return handle;
 	}
 
 	TextureHandle ResourceManager::CreateTexture(TextureDesc textureDesc, void* imageData, bool mipMap)
 	{
+		Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::ResourceManager);
+
 		TextureHandle handle = m_CurrentTextureIndex;
+
+		// The mip chain adds a third to the texture, drop it while the GPU budget is under pressure.
+		if (mipMap && m_SkipTextureMips)
+		{
+			textureDesc.NumMips = 1;
+			mipMap = false;
+		}
 	
 		Texture outTex = m_Device->CreateTexture(textureDesc);
 		m_Textures[handle] = outTex;
+		m_MemoryBudget.TrackGPU(Memory::GPUResourceCategory::Texture, static_cast<i64>(CalculateTextureSizeInBytes(textureDesc)));
 
 		if (imageData != nullptr)
 		{
@@ -302,6 +356,8 @@ namespace Gecko
 
 	MaterialHandle ResourceManager::CreateMaterial()
 	{
+		Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::ResourceManager);
+
 		MaterialHandle handle = m_CurrentMaterialIndex;
 
 		Material outMat;
@@ -351,12 +407,15 @@ namespace Gecko
 
 	RenderTargetHandle ResourceManager::CreateRenderTarget(RenderTargetDesc renderTargetDesc, std::string name, bool KeepWindowAspectRatio)
 	{
+		Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::ResourceManager);
+
 		RenderTargetHandle handle = m_CurrentRenderTargetIndex;
 
 		RenderTarget outRenderTarget = m_Device->CreateRenderTarget(renderTargetDesc);
 		m_RenderTargets[handle].RenderTarget = outRenderTarget;
 		m_RenderTargets[handle].KeepWindowAspectRatio = KeepWindowAspectRatio;
 		m_RenderTargets[handle].WidthScale = 1.f;
+		m_MemoryBudget.TrackGPU(Memory::GPUResourceCategory::RenderTarget, static_cast<i64>(CalculateRenderTargetSizeInBytes(renderTargetDesc)));
 
 		m_CurrentRenderTargetIndex++;
 
@@ -366,6 +425,12 @@ namespace Gecko
 
 	EnvironmentMapHandle ResourceManager::CreateEnvironmentMap(std::string path)
 	{
+		Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::ResourceManager);
+
+		// The HDR file is read while the cube map is created, it is decoded on this thread once it arrived.
+		HDRImage hdrImage;
+		IO::IORequestHandle hdrRequest = IO::ReadFile(path, IO::IOPriority::High, DecodeHDRImage, &hdrImage);
+
 		RenderTargetHandle handle = m_CurrentEnvironmentMapsIndex;
 
 		EnvironmentMap outEnvironmentMap;
@@ -392,20 +457,33 @@ namespace Gecko
 
 
 		{
-			int x, y, n;
-			f32* data = stbi_loadf(Platform::GetLocalPath(path).c_str(), &x, &y, &n, 4);
+			IO::Wait(hdrRequest);
+
+			// Without a decoded image the cube map is filled from a single black pixel, a 0x0 texture cannot be created.
+			f32 fallbackPixel[4] = { 0.f, 0.f, 0.f, 1.f };
+			f32* hdrData = hdrImage.Data;
+			if (hdrData == nullptr)
+			{
+				LOG_ERROR("Could not open environment map %s, using a black one instead.", path.c_str());
+				hdrData = fallbackPixel;
+				hdrImage.Width = 1;
+				hdrImage.Height = 1;
+			}
 
 			TextureDesc textureDesc;
-			textureDesc.Width = x;
-			textureDesc.Height = y;
+			textureDesc.Width = hdrImage.Width;
+			textureDesc.Height = hdrImage.Height;
 			textureDesc.Type = TextureType::Tex2D;
 			textureDesc.Format = Format::R32G32B32A32_FLOAT;
 			textureDesc.NumMips = 1;
 			textureDesc.NumArraySlices = 1;
-			outEnvironmentMap.HDRTextureHandle = CreateTexture(textureDesc, data);
+			outEnvironmentMap.HDRTextureHandle = CreateTexture(textureDesc, hdrData);
 			HDRTexture = GetTexture(outEnvironmentMap.HDRTextureHandle);;
 
-			stbi_image_free(data);
+			if (hdrImage.Data != nullptr)
+			{
+				stbi_image_free(hdrImage.Data);
+			}
 
 
 			// computeShader to upload to cubemap
@@ -471,6 +549,8 @@ namespace Gecko
 
 	GraphicsPipelineHandle ResourceManager::CreateGraphicsPipeline(GraphicsPipelineDesc graphicsPipelineDesc)
 	{
+		Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::ResourceManager);
+
 		GraphicsPipelineHandle handle = m_CurrentGraphicsPipelineIndex;
 
 		GraphicsPipeline outGraphicsPipeline = m_Device->CreateGraphicsPipeline(graphicsPipelineDesc);
@@ -482,6 +562,8 @@ namespace Gecko
 
 	ComputePipelineHandle ResourceManager::CreateComputePipeline(ComputePipelineDesc computePipelineDesc)
 	{
+		Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::ResourceManager);
+
 		ComputePipelineHandle handle = m_CurrentComputePipelineIndex;
 
 		ComputePipeline outComputePipeline = m_Device->CreateComputePipeline(computePipelineDesc);
@@ -493,6 +575,8 @@ namespace Gecko
 
 	RaytracingPipelineHandle ResourceManager::CreateRaytracePipeline(RaytracingPipelineDesc raytracePipelineDesc)
 	{
+		Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::ResourceManager);
+
 		RaytracingPipelineHandle handle = m_CurrentRaytracePipelineIndex;
 
 		RaytracingPipeline outRaytracingPipeline = m_Device->CreateRaytracingPipeline(raytracePipelineDesc);
@@ -578,25 +662,45 @@ namespace Gecko
 
 	bool ResourceManager::ResizeEvent(const Event::EventData& eventData)
 	{
+		Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::ResourceManager);
+
 		u32 width = eventData.Data.u32[0];
-		u32 height = eventData.Data.u32[0];
+		u32 height = eventData.Data.u32[1];
 		width = width == 0 ? 1 : width;
 		height = height == 0 ? 1 : height;
 
-		for (auto [key, val] : m_RenderTargets)
+		for (auto& [key, val] : m_RenderTargets)
 		{
 			if (val.KeepWindowAspectRatio)
 			{
 				RenderTargetDesc renderTargetDesc = val.RenderTarget.Desc;
 				renderTargetDesc.Width = static_cast<u32>(width * val.WidthScale);
 				renderTargetDesc.Height = static_cast<u32>(height * val.WidthScale);
+
+				// The budget follows the recreated target, otherwise it keeps counting the size it was created with.
+				m_MemoryBudget.TrackGPU(Memory::GPUResourceCategory::RenderTarget, -static_cast<i64>(CalculateRenderTargetSizeInBytes(val.RenderTarget.Desc)));
 				val.RenderTarget = m_Device->CreateRenderTarget(renderTargetDesc);
+				m_MemoryBudget.TrackGPU(Memory::GPUResourceCategory::RenderTarget, static_cast<i64>(CalculateRenderTargetSizeInBytes(renderTargetDesc)));
 			}
 		}
 
 		return false;
 	}
 
+	bool ResourceManager::MemoryPressureEvent(const Event::EventData& eventData)
+	{
+		if (eventData.Sender != &m_MemoryBudget || eventData.Data.u32[0] != static_cast<u32>(Memory::BudgetType::GPU))
+			return false;
+
+		m_SkipTextureMips = eventData.Data.u32[1] != static_cast<u32>(Memory::MemoryPressure::None);
+		if (m_SkipTextureMips)
+		{
+			LOG_WARN("GPU memory pressure, new textures are created without mip maps.");
+		}
+
+		return false;
+	}
+
 	void ResourceManager::MipMapTexture(Texture texture)
 	{
 		MipGenerationData mipGenerationData;
@@ -4,12 +4,18 @@
 #include "Rendering/Frontend/ApplicationContext.h"
 
 #include "Core/Asserts.h"
+#include "Core/AsyncIO.h"
+#include "Core/FileSystem.h"
+#include "Core/JobSystem.h"
 #include "Core/Logger.h"
+#include "Core/Memory.h"
 
 #include <glm/gtx/matrix_decompose.hpp>
 #include <tiny_gltf.h>
+#include <stb_image.h>
 #include <filesystem>
 
+#include <limits.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -101,11 +107,9 @@ namespace Gecko
 		}
 	}
 	
-	[[nodiscard]] MeshHandle CreateMesh(ResourceManager* resourceManager, const tinygltf::Model& gltfModel, const tinygltf::Primitive& primitive)
+	// Only reads the model, so primitives can be decoded on several threads at once.
+	void DecodePrimitive(const tinygltf::Model& gltfModel, const tinygltf::Primitive& primitive, std::vector<Vertex3D>& vertices, std::vector<u32>& indices)
 	{
-		std::vector<Vertex3D> vertices;
-		std::vector<u32> indices;
-
 		// indices
 		{
 			const tinygltf::Accessor& indexAccessor = gltfModel.accessors[primitive.indices];
@@ -241,7 +245,10 @@ namespace Gecko
 				CalculateTangents(vertices, indices);
 			}
 		}
+	}
 
+	[[nodiscard]] MeshHandle CreateMesh(ResourceManager* resourceManager, std::vector<Vertex3D>& vertices, std::vector<u32>& indices)
+	{
 		// Create the Vertex3D and index buffers
 		VertexBufferDesc vertexDesc;
 		vertexDesc.Layout = Vertex3D::GetLayout();
@@ -253,8 +260,99 @@ namespace Gecko
 		indexDesc.NumIndices = static_cast<u32>(indices.size());
 		indexDesc.IndexData = indices.data();
 
+		// The bounds are kept with the mesh for culling, without vertices there are none.
+		BoundingBox bounds;
+		if (!vertices.empty())
+		{
+			glm::vec3 min = vertices[0].position;
+			glm::vec3 max = vertices[0].position;
+			for (const Vertex3D& vertex : vertices)
+			{
+				min = glm::min(min, vertex.position);
+				max = glm::max(max, vertex.position);
+			}
+			bounds.Center = (min + max) * .5f;
+			bounds.Extents = (max - min) * .5f;
+		}
+
 		// TODO: check if a BLAS needs to be created.
-		return resourceManager->CreateMesh(vertexDesc, indexDesc, false);
+		return resourceManager->CreateMesh(vertexDesc, indexDesc, false, vertices.empty() ? nullptr : &bounds);
+	}
+
+	// Image uris are percent-encoded, e.g. "My%20Texture.png".
+	std::string DecodeURI(const std::string& uri)
+	{
+		auto hexValue = [](char c) -> i32
+			{
+				if (c >= '0' && c <= '9') return c - '0';
+				if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+				if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+				return -1;
+			};
+
+		std::string decoded;
+		decoded.reserve(uri.size());
+		for (size_t i = 0; i < uri.size(); i++)
+		{
+			if (uri[i] == '%' && i + 2 < uri.size() && hexValue(uri[i + 1]) >= 0 && hexValue(uri[i + 2]) >= 0)
+			{
+				decoded.push_back(static_cast<char>(hexValue(uri[i + 1]) * 16 + hexValue(uri[i + 2])));
+				i += 2;
+			}
+			else
+			{
+				decoded.push_back(uri[i]);
+			}
+		}
+		return decoded;
+	}
+
+	void DecodeExternalImage(const IO::IOResult& result, void* userData)
+	{
+		if (result.Status != IO::IOStatus::Completed || result.Size > INT_MAX)
+		{
+			LOG_CHANNEL_WARN(GLTF, "Could not read image %s.", result.Path);
+			return;
+		}
+
+		int width, height, numComponents;
+		stbi_uc* pixels = stbi_load_from_memory(result.Data, static_cast<int>(result.Size), &width, &height, &numComponents, 4);
+		if (pixels == nullptr)
+		{
+			LOG_CHANNEL_WARN(GLTF, "Could not decode image %s.", result.Path);
+			return;
+		}
+
+		tinygltf::Image* image = static_cast<tinygltf::Image*>(userData);
+		image->width = width;
+		image->height = height;
+		image->component = 4;
+		image->bits = 8;
+		image->pixel_type = TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
+		image->image.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+		stbi_image_free(pixels);
+	}
+
+	// tinygltf leaves images that are not embedded empty. They are all requested at once and each one is decoded
+	// as soon as it has been read, while the next ones are still on their way.
+	void LoadExternalImages(tinygltf::Model& gltfModel, const std::filesystem::path& directory)
+	{
+		std::vector<IO::IORequestHandle> requests;
+		requests.reserve(gltfModel.images.size());
+		for (tinygltf::Image& image : gltfModel.images)
+		{
+			if (!image.image.empty() || image.uri.empty())
+				continue;
+
+			std::string imagePath = (directory / DecodeURI(image.uri)).generic_string();
+			requests.push_back(IO::ReadFile(imagePath, IO::IOPriority::Normal, DecodeExternalImage, &image));
+		}
+
+		// Only this model's images, other loads may still be reading in the background.
+		for (const IO::IORequestHandle& request : requests)
+		{
+			IO::Wait(request);
+		}
 	}
 
 	void LoadNodes(const tinygltf::Model& gltfModel, Scene* scene, SceneNode* sceneNode, u32 gltfNodeIndex, const std::vector<std::vector<SceneRenderObject>>& sceneRenderObjects)
@@ -305,9 +403,11 @@ namespace Gecko
 			}
 		}
 
-		sceneNode->Transform.Position = translation;
-		sceneNode->Transform.Rotation = glm::eulerAngles(rotation);
-		sceneNode->Transform.Scale = scale;
+		NodeTransform transform;
+		transform.Position = translation;
+		transform.Rotation = glm::eulerAngles(rotation);
+		transform.Scale = scale;
+		sceneNode->SetTransform(transform);
 
 		// Load the meshes into the Node
 		if (gltfNode.mesh >= 0)
@@ -374,7 +474,17 @@ namespace Gecko
 
 			if (textureDescs[i].Format == Format::None)
 			{
-				LOG_WARN("Texture %ui exists without being on a material!", i);
+				LOG_CHANNEL_WARN(GLTF, "Texture %u exists without being on a material!", i);
+				textureHandles[i] = resourceManager->GetMissingTextureHandle();
+			}
+			else if (image.image.empty())
+			{
+				LOG_CHANNEL_WARN(GLTF, "Texture %u has no image data, using the missing texture instead.", i);
+				textureHandles[i] = resourceManager->GetMissingTextureHandle();
+			}
+			else if (!resourceManager->GetMemoryBudget().CanAllocate(Memory::BudgetType::GPU, CalculateTextureSizeInBytes(textureDescs[i])))
+			{
+				LOG_CHANNEL_WARN(GLTF, "Texture %u does not fit in the GPU memory budget, using the missing texture instead.", i);
 				textureHandles[i] = resourceManager->GetMissingTextureHandle();
 			}
 			else
@@ -452,7 +562,36 @@ namespace Gecko
 	{
 		std::vector<std::vector<SceneRenderObject>> sceneRenderObjects(gltfModel.meshes.size());
 
+		struct PrimitiveData
+		{
+			u32 Mesh;
+			u32 Primitive;
+			std::vector<Vertex3D> Vertices;
+			std::vector<u32> Indices;
+		};
+
+		std::vector<PrimitiveData> primitives;
+		for (u32 i = 0; i < gltfModel.meshes.size(); i++)
+		{
+			for (u32 j = 0; j < gltfModel.meshes[i].primitives.size(); j++)
+			{
+				primitives.push_back({ i, j, {}, {} });
+			}
+		}
+
+		// Decoding and tangent generation run on the workers, the buffers are created on this thread afterwards.
+		Jobs::ParallelFor(0, static_cast<u32>(primitives.size()), 1, [&gltfModel, &primitives](u32 begin, u32 end)
+			{
+				Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::GLTFLoader);
+				for (u32 i = begin; i < end; i++)
+				{
+					PrimitiveData& primitive = primitives[i];
+					DecodePrimitive(gltfModel, gltfModel.meshes[primitive.Mesh].primitives[primitive.Primitive], primitive.Vertices, primitive.Indices);
+				}
+			});
+
 		// load meshes
+		u32 primitiveIndex = 0;
 		for (u32 i = 0; i < gltfModel.meshes.size(); i++)
 		{
 			const tinygltf::Mesh& gltfMesh = gltfModel.meshes[i];
@@ -463,8 +602,11 @@ namespace Gecko
 			for (u32 j = 0; j < gltfMesh.primitives.size(); j++)
 			{
 				const tinygltf::Primitive& prim = gltfMesh.primitives[j];
+				PrimitiveData& primitive = primitives[primitiveIndex++];
 				SceneRenderObject& sceneRenderObject = meshPrimitives[j];
-				sceneRenderObject.SetMeshHandle(CreateMesh(resourceManager, gltfModel, prim));
+				sceneRenderObject.SetMeshHandle(CreateMesh(resourceManager, primitive.Vertices, primitive.Indices));
+				// Free the copies as we go, the GPU buffers hold the data now.
+				primitive = PrimitiveData();
 
 				if (prim.material >= 0)
 				{
@@ -482,8 +624,30 @@ namespace Gecko
 
 	Scene* GLTFSceneLoader::LoadScene(const std::string& pathString, ApplicationContext& ctx)
 	{
+		Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::GLTFLoader);
 
-		const std::filesystem::path path = Gecko::Platform::GetLocalPath(pathString);
+		const std::filesystem::path path = pathString;
+
+		// The file is parsed straight from the mapping, only the buffers and images tinygltf decodes are copied.
+		FileSystem::FileView file = FileSystem::Open(pathString);
+		if (!file.IsValid() || file.GetSize() > UINT32_MAX)
+		{
+			LOG_CHANNEL_ERROR(GLTF, "Could not open %s.", pathString.c_str());
+			return ctx.GetSceneManager()->CreateScene(path.filename().string());
+		}
+
+		// Refuse to load when the file alone would push the CPU budget over its hard limit.
+		Memory::MemoryBudget& memoryBudget = ctx.GetResourceManager()->GetMemoryBudget();
+		memoryBudget.Update();
+		if (!memoryBudget.CanAllocate(Memory::BudgetType::CPU, file.GetSize()))
+		{
+			LOG_CHANNEL_ERROR(GLTF, "Not loading %s, it does not fit in the CPU memory budget.", pathString.c_str());
+			return ctx.GetSceneManager()->CreateScene(path.filename().string());
+		}
+
+		// External buffers of a .gltf are only found next to loose files, a .gltf in a pack has to embed them.
+		// External images are read through the FileSystem by LoadExternalImages and work in packs as well.
+		std::string baseDirectory = file.GetNativePath().empty() ? std::string() : std::filesystem::path(file.GetNativePath()).parent_path().string();
 
 		// Get the gltf Mode
 		tinygltf::Model model;
@@ -495,30 +659,32 @@ namespace Gecko
 		bool ret;
 		if (path.extension() == ".gltf")
 		{
-			ret = loader.LoadASCIIFromFile(&model, &err, &warn, path.string());
+			ret = loader.LoadASCIIFromString(&model, &err, &warn, reinterpret_cast<const char*>(file.GetData()), static_cast<unsigned int>(file.GetSize()), baseDirectory);
 		}
 		else {
-			ret = loader.LoadBinaryFromFile(&model, &err, &warn, path.string());
+			ret = loader.LoadBinaryFromMemory(&model, &err, &warn, file.GetData(), static_cast<unsigned int>(file.GetSize()), baseDirectory);
 		}
 
 		Scene* scene = ctx.GetSceneManager()->CreateScene(path.filename().string());
 
 		if (!warn.empty()) 
 		{
-			LOG_WARN(warn.c_str());
+			LOG_CHANNEL_WARN(GLTF, "%s", warn.c_str());
 			return scene;
 		}
 		if (!err.empty()) 
 		{
-			LOG_ERROR(err.c_str());
+			LOG_CHANNEL_ERROR(GLTF, "%s", err.c_str());
 			return scene;
 		}
 		if (!ret) 
 		{
-			LOG_WARN("Failed to parse glTF");
+			LOG_CHANNEL_WARN(GLTF, "Failed to parse glTF");
 			return scene;
 		}
 
+		LoadExternalImages(model, path.parent_path());
+
 		std::vector<TextureHandle> textureHandles = LoadTextures(ctx.GetResourceManager(), model);
 		std::vector<MaterialHandle> materialHandles = LoadMaterials(ctx.GetResourceManager(), model, textureHandles);
 		std::vector<std::vector<SceneRenderObject>> sceneRenderObjects = LoadMeshes(ctx.GetResourceManager(), model, materialHandles);
@@ -4,26 +4,34 @@
 
 #include "Core/Platform.h"
 #include "Core/Logger.h"
+#include "Core/Memory.h"
+#include "Core/AllocationGuard.h"
 
 namespace Gecko  {
 
 	SceneNode* SceneNode::AddNode(const std::string& name)
 	{
-		u32 index = static_cast<u32>(m_Children.size());
-		m_Children.push_back(CreateScope<SceneNode>());
+		Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::Scene);
+
+		SceneNode* node = m_Scene->m_NodePool.Create(m_Scene);
+		m_Children.push_back(node);
+		m_Scene->m_StructureVersion++;
 
-		SceneNode* node = m_Children[index].get();
 		node->SetName(name);
 		return node;
 	}
 
 	void SceneNode::AppendSceneRenderObject(SceneRenderObject* sceneRenderObject)
 	{
+		Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::Scene);
+
 		m_SceneRenderObjects.push_back(sceneRenderObject);
 	}
 
 	void SceneNode::AppendLight(SceneLight* light)
 	{
+		Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::Scene);
+
 		m_Lights.push_back(light);
 	}
 
@@ -34,7 +42,10 @@ namespace Gecko  {
 
 	void SceneNode::AppendScene(Scene* scene)
 	{
+		Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::Scene);
+
 		m_Scenes.push_back(scene);
+		m_Scene->m_StructureVersion++;
 	}
 
 	u32 SceneNode::GetChildrenCount()
@@ -46,14 +57,16 @@ namespace Gecko  {
 	{
 		if (childNodeIndex >= GetChildrenCount())
 		{
-			LOG_WARN("Node index is greater than the children count!");
+			LOG_CHANNEL_WARN(Scene, "Node index is greater than the children count!");
 			return nullptr;
 		}
-		return m_Children[childNodeIndex].get();
+		return m_Children[childNodeIndex];
 	}
 
-	const void SceneNode::SetName(const std::string& name)
+	void SceneNode::SetName(const std::string& name)
 	{
+		Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::Scene);
+
 		m_Name = name;
 	}
 
@@ -62,13 +75,30 @@ namespace Gecko  {
 		return m_Name;
 	}
 
-	const void SceneNode::PopulateSceneRenderInfo(SceneRenderInfo& sceneRenderInfo, glm::mat4 transform) const
+	void SceneNode::SetTransform(const NodeTransform& transform)
 	{
-	
-		// Calculate the transform of this nodes
-		glm::mat4 transformMatrix = Transform.GetMat4();
-		glm::mat4 worldMatrix = transform * transformMatrix;
+		m_Transform = transform;
+		m_TransformVersion++;
+	}
 
+	NodeTransform& SceneNode::EditTransform()
+	{
+		m_TransformVersion++;
+		return m_Transform;
+	}
+
+	const glm::mat4& SceneNode::GetLocalMatrix() const
+	{
+		if (m_LocalMatrixVersion != m_TransformVersion)
+		{
+			m_LocalMatrix = m_Transform.GetMat4();
+			m_LocalMatrixVersion = m_TransformVersion;
+		}
+		return m_LocalMatrix;
+	}
+
+	void SceneNode::PopulateSceneRenderInfo(SceneRenderInfo& sceneRenderInfo, const glm::mat4& worldMatrix) const
+	{
 		// Add the meshes
 		for (const SceneRenderObject* sceneRenderObject : m_SceneRenderObjects)
 		{
@@ -138,73 +168,55 @@ namespace Gecko  {
 				}
 				break;
 			case LightType::None:
-				LOG_WARN("Invalid light type None!");
+				LOG_CHANNEL_WARN(Scene, "Invalid light type None!");
 				break;
 			default:
-				LOG_WARN("Unkown light type: %ui!", static_cast<u32>(sceneLight->GetLightType()));
+				LOG_CHANNEL_WARN(Scene, "Unkown light type: %u!", static_cast<u32>(sceneLight->GetLightType()));
 				break;
 			}
 		}
-
-		// Add the children
-		for (const Scope<SceneNode>& child : m_Children)
-		{
-			child->PopulateSceneRenderInfo(sceneRenderInfo, worldMatrix);
-		}
-
-		// Append the scene
-		for (const Scene* scene : m_Scenes)
-		{
-			scene->PopulateSceneRenderInfo(sceneRenderInfo, worldMatrix);
-		}
 	}
 
 	void Scene::Init(const std::string& name)
 	{
+		Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::Scene);
+
 		AddEventListener(Event::SystemEvent::CODE_RESIZED, &Scene::OnResize);
 
 		m_Name = name;
-		m_RootNode = CreateScope<SceneNode>();
+		m_RootNode = m_NodePool.Create(this);
 		m_RootNode->SetName("Root Node");
+		m_StructureVersion++;
 	}
 
 	SceneNode* Scene::GetRootNode()
 	{
-		return m_RootNode.get();
+		return m_RootNode;
 	}
 
 	SceneRenderObject* Scene::CreateSceneRenderObject()
 	{
-		u32 index = static_cast<u32>(m_SceneRenderObject.size());
-		m_SceneRenderObject.push_back(CreateScope<SceneRenderObject>());
+		Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::Scene);
 
-		SceneRenderObject* sceneRenderObject = m_SceneRenderObject[index].get();
-		return sceneRenderObject;
+		return m_SceneRenderObjectPool.Create();
 	}
 	
 	SceneLight* Scene::CreateLight(LightType lightType)
 	{
-		u32 index = static_cast<u32>(m_Lights.size());
-	
+		Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::Scene);
+
 		switch (lightType)
 		{
 		case LightType::Directional:
-			m_Lights.push_back(CreateScope<SceneDirectionalLight>());
-			break;
+			return m_DirectionalLightPool.Create();
 		case LightType::Point:
-			m_Lights.push_back(CreateScope<ScenePointLight>());
-			break;
+			return m_PointLightPool.Create();
 		case LightType::Spot:
-			m_Lights.push_back(CreateScope<SceneSpotLight>());
-			break;
+			return m_SpotLightPool.Create();
 		default:
 			ASSERT_MSG(false, "Unkown light type!");
 			return nullptr;
-			break;
 		}
-
-		SceneLight* light = m_Lights[index].get();
-		return light;
 	}
 
 	SceneDirectionalLight* Scene::CreateDirectionalLight()
@@ -224,20 +236,50 @@ namespace Gecko  {
 
 	SceneCamera* Scene::CreateCamera()
 	{
-		u32 index = static_cast<u32>(m_Cameras.size());
-		m_Cameras.push_back(CreateScope<SceneCamera>());
+		Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::Scene);
 
-		SceneCamera* camera = m_Cameras[index].get();
-		return camera;
+		return m_CameraPool.Create();
 	}
 
-	const SceneRenderInfo Scene::GetSceneRenderInfo() const
+	SceneRenderInfo Scene::GetSceneRenderInfo(Memory::LinearAllocator& allocator) const
 	{
-		SceneRenderInfo sceneRenderInfo;
+		Memory::ScopedAllocationGuard allocationGuard("Scene::GetSceneRenderInfo");
 
-		glm::mat4 transform(1.f);
+		SceneRenderInfo sceneRenderInfo(allocator);
+		sceneRenderInfo.RenderObjects.reserve(m_LastRenderInfoSizes.RenderObjects);
+		sceneRenderInfo.DirectionalLights.reserve(m_LastRenderInfoSizes.DirectionalLights);
+		sceneRenderInfo.PointLights.reserve(m_LastRenderInfoSizes.PointLights);
+		sceneRenderInfo.SpotLights.reserve(m_LastRenderInfoSizes.SpotLights);
+		sceneRenderInfo.ChangedRenderObjects.reserve(m_LastRenderInfoSizes.ChangedRenderObjects);
 
-		PopulateSceneRenderInfo(sceneRenderInfo, transform);
+		if (m_Hierarchy.IsOutdated())
+		{
+			m_Hierarchy.Build(*this);
+		}
+		m_Hierarchy.UpdateTransforms();
+
+		// The hierarchy is in the order the tree used to be walked in, the first camera found still wins.
+		const u32 nodeCount = m_Hierarchy.GetNodeCount();
+		for (u32 i = 0; i < nodeCount; i++)
+		{
+			u32 firstRenderObject = static_cast<u32>(sceneRenderInfo.RenderObjects.size());
+			m_Hierarchy.GetNode(i)->PopulateSceneRenderInfo(sceneRenderInfo, m_Hierarchy.GetWorldTransform(i));
+
+			if (m_Hierarchy.HasWorldTransformChanged(i))
+			{
+				for (u32 renderObject = firstRenderObject; renderObject < sceneRenderInfo.RenderObjects.size(); renderObject++)
+				{
+					sceneRenderInfo.ChangedRenderObjects.push_back(renderObject);
+				}
+			}
+		}
+		sceneRenderInfo.EnvironmentMap = m_Hierarchy.GetLastScene()->m_EnvironmentMapHandle;
+
+		m_LastRenderInfoSizes.RenderObjects = sceneRenderInfo.RenderObjects.size();
+		m_LastRenderInfoSizes.DirectionalLights = sceneRenderInfo.DirectionalLights.size();
+		m_LastRenderInfoSizes.PointLights = sceneRenderInfo.PointLights.size();
+		m_LastRenderInfoSizes.SpotLights = sceneRenderInfo.SpotLights.size();
+		m_LastRenderInfoSizes.ChangedRenderObjects = sceneRenderInfo.ChangedRenderObjects.size();
 
 		return sceneRenderInfo;
 	}
@@ -257,21 +299,14 @@ namespace Gecko  {
 		u32 width = data.Data.u32[0];
 		u32 height = data.Data.u32[1];
 		f32 aspectRatio = static_cast<f32>(width) / static_cast<f32>(height);
-		for (u32 i = 0; i < m_Cameras.size(); i++)
+		m_CameraPool.ForEach([aspectRatio](SceneCamera* camera)
 		{
-			if (m_Cameras[i]->IsAutoAspectRatio())
+			if (camera->IsAutoAspectRatio())
 			{
-				m_Cameras[i]->SetAspectRatio(aspectRatio);
+				camera->SetAspectRatio(aspectRatio);
 			}
-		}
+		});
 		return false;
 	}
 
-	const void Scene::PopulateSceneRenderInfo(SceneRenderInfo& sceneRenderInfo, glm::mat4 transform) const
-	{
-		sceneRenderInfo.EnvironmentMap = m_EnvironmentMapHandle;
-
-		m_RootNode->PopulateSceneRenderInfo(sceneRenderInfo, transform);
-	}
-
 }
\ No newline at end of file
@@ -0,0 +1,166 @@
+#include "Rendering/Frontend/Scene/SceneHierarchy.h"
+
+#include "Rendering/Frontend/Scene/Scene.h"
+
+#include "Core/Memory.h"
+#include "Core/TransformKernels.h"
+
+#include <algorithm>
+
+namespace Gecko {
+
+	namespace
+	{
+		// Moved nodes composed per kernel call, the scratch arrays live on the stack.
+		constexpr u32 COMPOSE_BATCH_SIZE = 64;
+
+		struct PendingNode
+		{
+			const SceneNode* Node;
+			u32 Parent;
+		};
+	}
+
+	void SceneHierarchy::Build(const Scene& scene)
+	{
+		Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::Scene);
+
+		m_Nodes.clear();
+		m_Parents.clear();
+		m_Scenes.clear();
+
+		// Depth first without recursion, deep imports would overflow the stack. Children are pushed in reverse so they
+		// come out in order, and before the appended scenes, the same order the nodes were visited in before.
+		std::vector<PendingNode> stack;
+		m_Scenes.push_back({ &scene, scene.m_StructureVersion });
+		stack.push_back({ scene.m_RootNode, NO_PARENT });
+
+		while (!stack.empty())
+		{
+			PendingNode pending = stack.back();
+			stack.pop_back();
+
+			u32 index = static_cast<u32>(m_Nodes.size());
+			m_Nodes.push_back(pending.Node);
+			m_Parents.push_back(pending.Parent);
+
+			const SceneNode* node = pending.Node;
+			for (auto it = node->m_Scenes.rbegin(); it != node->m_Scenes.rend(); ++it)
+			{
+				stack.push_back({ (*it)->m_RootNode, index });
+			}
+			for (auto it = node->m_Children.rbegin(); it != node->m_Children.rend(); ++it)
+			{
+				stack.push_back({ *it, index });
+			}
+
+			// Appended scenes are recorded when their root node is reached, so the list stays in visiting order.
+			if (node == node->m_Scene->m_RootNode && index != 0)
+			{
+				m_Scenes.push_back({ node->m_Scene, node->m_Scene->m_StructureVersion });
+			}
+		}
+
+		m_LocalTransforms.resize(m_Nodes.size());
+		m_WorldTransforms.resize(m_Nodes.size());
+		m_WorldChanged.resize(m_Nodes.size());
+		m_MovedNodes.reserve(m_Nodes.size());
+		m_ChangedNodes.reserve(m_Nodes.size());
+		// Node versions start at one, every entry is read on the next update.
+		m_TransformVersions.assign(m_Nodes.size(), 0);
+	}
+
+	bool SceneHierarchy::IsOutdated() const
+	{
+		if (m_Scenes.empty())
+			return true;
+
+		for (const SceneVersion& version : m_Scenes)
+		{
+			if (version.Source->m_StructureVersion != version.StructureVersion)
+				return true;
+		}
+		return false;
+	}
+
+	void SceneHierarchy::UpdateTransforms()
+	{
+		const u32 nodeCount = GetNodeCount();
+		m_MovedNodes.clear();
+		m_ChangedNodes.clear();
+
+		// A moved node marks itself, parents come first so the mark reaches the whole subtree in the same pass.
+		for (u32 i = 0; i < nodeCount; i++)
+		{
+			const SceneNode* node = m_Nodes[i];
+			u32 parent = m_Parents[i];
+
+			bool moved = node->m_TransformVersion != m_TransformVersions[i];
+			if (moved)
+			{
+				m_TransformVersions[i] = node->m_TransformVersion;
+				m_MovedNodes.push_back(i);
+			}
+
+			bool worldChanged = moved || (parent != NO_PARENT && m_WorldChanged[parent]);
+			m_WorldChanged[i] = worldChanged;
+			if (worldChanged)
+			{
+				m_ChangedNodes.push_back(i);
+			}
+		}
+
+		ComposeLocalTransforms();
+		// The changed nodes are in hierarchy order, a parent is always done before its children.
+		Math::MultiplyByParents(m_ChangedNodes.data(), static_cast<u32>(m_ChangedNodes.size()), m_Parents.data(), m_LocalTransforms.data(), m_WorldTransforms.data());
+	}
+
+	void SceneHierarchy::ComposeLocalTransforms()
+	{
+		// The transforms of the moved nodes are copied out in batches, component by component, as the kernel wants them.
+		f32 components[9][COMPOSE_BATCH_SIZE];
+		glm::mat4 matrices[COMPOSE_BATCH_SIZE];
+
+		Math::TRSArrays transforms;
+		for (u32 component = 0; component < 3; component++)
+		{
+			transforms.Position[component] = components[component];
+			transforms.Rotation[component] = components[3 + component];
+			transforms.Scale[component] = components[6 + component];
+		}
+
+		const u32 movedCount = static_cast<u32>(m_MovedNodes.size());
+		for (u32 first = 0; first < movedCount; first += COMPOSE_BATCH_SIZE)
+		{
+			const u32 count = std::min(COMPOSE_BATCH_SIZE, movedCount - first);
+			for (u32 i = 0; i < count; i++)
+			{
+				const NodeTransform& transform = m_Nodes[m_MovedNodes[first + i]]->m_Transform;
+				for (u32 component = 0; component < 3; component++)
+				{
+					components[component][i] = transform.Position[component];
+					components[3 + component][i] = transform.Rotation[component];
+					components[6 + component][i] = transform.Scale[component];
+				}
+			}
+
+			Math::ComposeTRS(transforms, matrices, count);
+
+			for (u32 i = 0; i < count; i++)
+			{
+				u32 index = m_MovedNodes[first + i];
+				const SceneNode* node = m_Nodes[index];
+				m_LocalTransforms[index] = matrices[i];
+				// Saves the node from composing the same matrix again when it is asked for it.
+				node->m_LocalMatrix = matrices[i];
+				node->m_LocalMatrixVersion = node->m_TransformVersion;
+			}
+		}
+	}
+
+	const Scene* SceneHierarchy::GetLastScene() const
+	{
+		return m_Scenes.empty() ? nullptr : m_Scenes.back().Source;
+	}
+
+}
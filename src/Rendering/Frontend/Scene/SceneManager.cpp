@@ -2,6 +2,7 @@
 
 #include "Rendering/Frontend/Scene/Scene.h"
 #include "Rendering/Frontend/ResourceManager/ResourceManager.h"
+#include "Core/Memory.h"
 
 namespace Gecko {
 
@@ -17,6 +18,8 @@ namespace Gecko {
 
 	Scene* SceneManager::CreateScene(const std::string& name)
 	{
+		Memory::ScopedMemoryTag memoryTag(Memory::MemoryTag::Scene);
+
 		u32 index = static_cast<u32>(m_Scenes.size());
 		m_Scenes.push_back(CreateScope<Scene>());
 
@@ -35,7 +38,7 @@ namespace Gecko {
 	{
 		if (sceneIndex >= GetSceneCount())
 		{
-			LOG_WARN("Scene index is greater then the scene count!");
+			LOG_CHANNEL_WARN(Scene, "Scene index is greater then the scene count!");
 			return nullptr;
 		}
 
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Rendering/Backend/CommandList.h"
+
+namespace Gecko { namespace Null {
+
+	// Records nothing, used by the headless device so the frontend can run without a GPU.
+	class CommandList_Null : public CommandList
+	{
+	public:
+		CommandList_Null() = default;
+
+		virtual ~CommandList_Null() override {};
+
+		virtual bool IsValid() override { return true; }
+
+		virtual void ClearRenderTarget(RenderTarget) override {}
+
+		virtual void CopyToRenderTarget(RenderTarget, RenderTargetType, RenderTarget, RenderTargetType) override {}
+		virtual void CopyFromRenderTarget(RenderTarget, RenderTargetType, Texture) override {}
+		virtual void CopyFromTexture(Texture, RenderTarget, RenderTargetType) override {}
+
+		virtual void BindRenderTarget(RenderTarget) override {}
+		virtual void BindVertexBuffer(const VertexBuffer&) override {}
+		virtual void BindIndexBuffer(const IndexBuffer&) override {}
+		virtual void BindTexture(u32, Texture) override {}
+		virtual void BindTexture(u32, Texture, u32) override {}
+		virtual void BindTexture(u32, RenderTarget, RenderTargetType) override {}
+		virtual void BindAsRWTexture(u32, Texture) override {}
+		virtual void BindAsRWTexture(u32, Texture, u32) override {}
+		virtual void BindAsRWTexture(u32, RenderTarget, RenderTargetType) override {}
+
+		virtual void BindGraphicsPipeline(const GraphicsPipeline&) override {}
+		virtual void BindComputePipeline(const ComputePipeline&) override {}
+		virtual void BindRaytracingPipeline(const RaytracingPipeline&) override {}
+
+		virtual void BindConstantBuffer(u32, ConstantBuffer) override {}
+
+		virtual void BindTLAS(const TLAS&) override {}
+
+		virtual void SetDynamicCallData(u32, void*) override {}
+
+		virtual void Draw(u32) override {}
+		virtual void DrawAuto(u32) override {}
+
+		virtual void Dispatch(u32, u32, u32) override {}
+
+		virtual void DispatchRays(u32, u32, u32) override {}
+	};
+
+} }
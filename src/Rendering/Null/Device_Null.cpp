@@ -0,0 +1,242 @@
+#include "Rendering/Null/Device_Null.h"
+
+#include "Rendering/Null/CommandList_Null.h"
+
+#include "Core/Platform.h"
+#include "Core/Asserts.h"
+#include "Core/Time.h"
+
+#include <imgui.h>
+
+#include <vector>
+
+namespace Gecko { namespace Null {
+
+	namespace
+	{
+		// Stands in for the backend data of every resource, so nothing that checks a resource's Data sees it as missing.
+		struct Resource_Null
+		{
+			u8 Unused{ 0 };
+		};
+
+		// The frontend writes constant buffers through ConstantBuffer::Buffer, so they get real CPU memory.
+		struct ConstantBuffer_Null
+		{
+			std::vector<u8> Memory;
+		};
+
+		Ref<void> CreateResourceData()
+		{
+			return CreateRef<Resource_Null>();
+		}
+	}
+
+	Device_Null::Device_Null()
+	{
+		const Platform::AppInfo& info = Platform::GetAppInfo();
+
+		m_NumBackBuffers = info.NumBackBuffers > 0 ? info.NumBackBuffers : 1;
+
+		m_CommandList = CreateRef<CommandList_Null>();
+
+		m_BackBuffer.Desc.RenderTargetFormats[0] = Format::R8G8B8A8_UNORM;
+		m_BackBuffer.Desc.NumRenderTargets = 1;
+		m_BackBuffer.Desc.DepthStencilFormat = Format::R32_FLOAT;
+		m_BackBuffer.Desc.Width = info.Width;
+		m_BackBuffer.Desc.Height = info.Height;
+		m_BackBuffer.Data = CreateResourceData();
+
+		ImGui::CreateContext();
+		ImGuiIO& io = ImGui::GetIO();
+		io.DisplaySize = ImVec2(static_cast<float>(info.Width), static_cast<float>(info.Height));
+
+		// ImGui asserts when the font atlas is not built, the texture itself is never used.
+		unsigned char* pixels;
+		int width, height;
+		io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+		m_LastFrameTicks = Platform::GetTicks();
+	}
+
+	Device_Null::~Device_Null()
+	{
+		Destroy();
+	}
+
+	Ref<CommandList> Device_Null::CreateGraphicsCommandList()
+	{
+		return m_CommandList;
+	}
+
+	void Device_Null::ExecuteGraphicsCommandList(Ref<CommandList>)
+	{
+	}
+
+	void Device_Null::ExecuteGraphicsCommandListAndFlip(Ref<CommandList>)
+	{
+		m_CurrentBackBuffer = (m_CurrentBackBuffer + 1) % m_NumBackBuffers;
+	}
+
+	Ref<CommandList> Device_Null::CreateComputeCommandList()
+	{
+		return m_CommandList;
+	}
+
+	void Device_Null::ExecuteComputeCommandList(Ref<CommandList>)
+	{
+	}
+
+	RenderTarget Device_Null::GetCurrentBackBuffer()
+	{
+		return m_BackBuffer;
+	}
+
+	RenderTarget Device_Null::CreateRenderTarget(const RenderTargetDesc& desc)
+	{
+		RenderTarget renderTarget;
+		renderTarget.Desc = desc;
+		renderTarget.Data = CreateResourceData();
+		return renderTarget;
+	}
+
+	VertexBuffer Device_Null::CreateVertexBuffer(const VertexBufferDesc& desc)
+	{
+		VertexBuffer vertexBuffer;
+		vertexBuffer.Desc = desc;
+		// The vertex data only has to stay valid until this call.
+		vertexBuffer.Desc.VertexData = nullptr;
+		vertexBuffer.Data = CreateResourceData();
+		return vertexBuffer;
+	}
+
+	IndexBuffer Device_Null::CreateIndexBuffer(const IndexBufferDesc& desc)
+	{
+		IndexBuffer indexBuffer;
+		indexBuffer.Desc = desc;
+		indexBuffer.Desc.IndexData = nullptr;
+		indexBuffer.Data = CreateResourceData();
+		return indexBuffer;
+	}
+
+	GraphicsPipeline Device_Null::CreateGraphicsPipeline(const GraphicsPipelineDesc& desc)
+	{
+		GraphicsPipeline pipeline;
+		pipeline.Desc = desc;
+		pipeline.Data = CreateResourceData();
+		return pipeline;
+	}
+
+	ComputePipeline Device_Null::CreateComputePipeline(const ComputePipelineDesc& desc)
+	{
+		ComputePipeline pipeline;
+		pipeline.Desc = desc;
+		pipeline.Data = CreateResourceData();
+		return pipeline;
+	}
+
+	Texture Device_Null::CreateTexture(const TextureDesc& desc)
+	{
+		Texture texture;
+		texture.Desc = desc;
+		texture.Data = CreateResourceData();
+		return texture;
+	}
+
+	ConstantBuffer Device_Null::CreateConstantBuffer(const ConstantBufferDesc& desc)
+	{
+		ConstantBuffer constantBuffer;
+		constantBuffer.Desc = desc;
+
+		Ref<ConstantBuffer_Null> constantBufferData = CreateRef<ConstantBuffer_Null>();
+		constantBufferData->Memory.resize(desc.Size);
+		constantBuffer.Buffer = constantBufferData->Memory.data();
+		constantBuffer.Data = constantBufferData;
+		return constantBuffer;
+	}
+
+	RaytracingPipeline Device_Null::CreateRaytracingPipeline(const RaytracingPipelineDesc& desc)
+	{
+		RaytracingPipeline pipeline;
+		pipeline.Desc = desc;
+		pipeline.Data = CreateResourceData();
+		return pipeline;
+	}
+
+	BLAS Device_Null::CreateBLAS(const BLASDesc& desc)
+	{
+		BLAS blas;
+		blas.Desc = desc;
+		blas.Data = CreateResourceData();
+		return blas;
+	}
+
+	TLAS Device_Null::CreateTLAS(const TLASRefitDesc&)
+	{
+		TLAS tlas;
+		tlas.Data = CreateResourceData();
+		return tlas;
+	}
+
+	void Device_Null::UploadTextureData(Texture, void*, u32, u32)
+	{
+	}
+
+	void Device_Null::DrawTextureInImGui(Texture texture, u32 width, u32 height)
+	{
+		ImVec2 size = {
+			static_cast<float>(width == 0 ? texture.Desc.Width : width),
+			static_cast<float>(height == 0 ? texture.Desc.Height : height)
+		};
+		ImGui::Dummy(size);
+	}
+
+	void Device_Null::DrawRenderTargetInImGui(RenderTarget renderTarget, u32 width, u32 height, RenderTargetType)
+	{
+		ImVec2 size = {
+			static_cast<float>(width == 0 ? renderTarget.Desc.Width : width),
+			static_cast<float>(height == 0 ? renderTarget.Desc.Height : height)
+		};
+		ImGui::Dummy(size);
+	}
+
+	void Device_Null::ImGuiEndFrame()
+	{
+		ImGui::Render();
+	}
+
+	void Device_Null::ImGuiNewFrame()
+	{
+		u64 ticks = Platform::GetTicks();
+		ImGuiIO& io = ImGui::GetIO();
+		io.DeltaTime = (ticks > m_LastFrameTicks) ? static_cast<f32>(Time::ToSeconds(ticks - m_LastFrameTicks)) : 1.f / 60.f;
+		m_LastFrameTicks = ticks;
+
+		ImGui::NewFrame();
+	}
+
+	void Device_Null::ImGuiRender(Ref<CommandList>, ImDrawData*)
+	{
+	}
+
+	bool Device_Null::Destroy()
+	{
+		if (m_Destroyed)
+			return true;
+
+		ImGui::DestroyContext();
+		m_Destroyed = true;
+		return true;
+	}
+
+	u32 Device_Null::GetNumBackBuffers()
+	{
+		return m_NumBackBuffers;
+	}
+
+	u32 Device_Null::GetCurrentBackBufferIndex()
+	{
+		return m_CurrentBackBuffer;
+	}
+
+} }
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Rendering/Backend/Device.h"
+
+namespace Gecko { namespace Null {
+
+	// A device without a GPU for headless runs: resources only keep their description and command lists do nothing.
+	// ImGui still gets a context and frames, so debug UI code runs the same way it does with a real device.
+	class Device_Null : public Device
+	{
+	public:
+		Device_Null();
+		virtual ~Device_Null() override;
+
+		virtual Ref<CommandList> CreateGraphicsCommandList() override;
+		virtual void ExecuteGraphicsCommandList(Ref<CommandList> commandList) override;
+		virtual void ExecuteGraphicsCommandListAndFlip(Ref<CommandList> commandList) override;
+
+		virtual Ref<CommandList> CreateComputeCommandList() override;
+		virtual void ExecuteComputeCommandList(Ref<CommandList> commandList) override;
+
+		virtual RenderTarget GetCurrentBackBuffer() override;
+
+		virtual RenderTarget CreateRenderTarget(const RenderTargetDesc& desc) override;
+		virtual VertexBuffer CreateVertexBuffer(const VertexBufferDesc& desc) override;
+		virtual IndexBuffer CreateIndexBuffer(const IndexBufferDesc& desc) override;
+		virtual GraphicsPipeline CreateGraphicsPipeline(const GraphicsPipelineDesc& desc) override;
+		virtual ComputePipeline CreateComputePipeline(const ComputePipelineDesc& desc) override;
+		virtual Texture CreateTexture(const TextureDesc& desc) override;
+		virtual ConstantBuffer CreateConstantBuffer(const ConstantBufferDesc& desc) override;
+
+		virtual RaytracingPipeline CreateRaytracingPipeline(const RaytracingPipelineDesc& desc) override;
+		virtual BLAS CreateBLAS(const BLASDesc& desc) override;
+		virtual TLAS CreateTLAS(const TLASRefitDesc& desc) override;
+
+		virtual void UploadTextureData(Texture texture, void* Data, u32 mip = 0, u32 slice = 0) override;
+
+		virtual void DrawTextureInImGui(Texture texture, u32 width = 0, u32 height = 0) override;
+		virtual void DrawRenderTargetInImGui(RenderTarget renderTarget, u32 width = 0, u32 height = 0, RenderTargetType type = RenderTargetType::Target0) override;
+		virtual void ImGuiEndFrame() override;
+		virtual void ImGuiNewFrame() override;
+		virtual void ImGuiRender(Ref<CommandList> commandList, ImDrawData* drawData) override;
+
+		virtual bool Destroy() override;
+
+		virtual u32 GetNumBackBuffers() override;
+		virtual u32 GetCurrentBackBufferIndex() override;
+
+	private:
+		// Null command lists hold no state, so one instance is handed out instead of allocating one per frame.
+		Ref<CommandList> m_CommandList;
+		RenderTarget m_BackBuffer;
+		u32 m_NumBackBuffers{ 0 };
+		u32 m_CurrentBackBuffer{ 0 };
+		u64 m_LastFrameTicks{ 0 };
+		bool m_Destroyed{ false };
+	};
+
+} }
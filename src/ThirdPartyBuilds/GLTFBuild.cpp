@@ -1,4 +1,4 @@
-#include "Core/Platform.h"
+#include "Core/Memory.h"
 
 #if defined(WIN32)
 #pragma warning( push )
@@ -6,11 +6,13 @@
 #pragma warning(disable : 4267)
 #endif
 
-#define STBI_MALLOC(sz) Gecko::Platform::CustomAllocate(sz)
-#define STBI_REALLOC(p,newsz) Gecko::Platform::CustomRealloc(p,newsz)
-#define STBI_FREE(p) Gecko::Platform::CustomFree(p)
+#define STBI_MALLOC(sz) Gecko::Memory::Allocate(sz, Gecko::Memory::GetCurrentTag())
+#define STBI_REALLOC(p,newsz) Gecko::Memory::Reallocate(p, newsz, Gecko::Memory::GetCurrentTag())
+#define STBI_FREE(p) Gecko::Memory::Free(p)
 
 #define TINYGLTF_USE_CPP14 
+// External images are read through the IO service by GLTFSceneLoader, tinygltf only keeps their uri.
+#define TINYGLTF_NO_EXTERNAL_IMAGE
 #define TINYGLTF_IMPLEMENTATION
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #define STB_IMAGE_IMPLEMENTATION
@@ -1,6 +1,9 @@
 #include "UI/DebugUIRenderer.h"
 
 #include "Rendering/Frontend/ApplicationContext.h"
+#include "Core/Memory.h"
+#include "Core/AllocationGuard.h"
+#include "Core/Logger.h"
 
 #include <imgui.h>
 
@@ -55,10 +58,89 @@ namespace Gecko {
 	{
 		ImGui::Begin("Resource Manager");
 
+		const Memory::MemoryBudget& memoryBudget = resourceManager->GetMemoryBudget();
+		for (u32 i = 0; i < static_cast<u32>(Memory::BudgetType::MaxTypes); i++)
+		{
+			Memory::BudgetType type = static_cast<Memory::BudgetType>(i);
+			const Memory::BudgetLimits& limits = memoryBudget.GetLimits(type);
+			ImGui::Text("%s: %.2f MiB (soft %.2f MiB, hard %.2f MiB), pressure: %s",
+				Memory::MemoryBudget::GetBudgetTypeName(type),
+				static_cast<f64>(memoryBudget.GetUsage(type)) / (1024. * 1024.),
+				static_cast<f64>(limits.SoftLimit) / (1024. * 1024.),
+				static_cast<f64>(limits.HardLimit) / (1024. * 1024.),
+				Memory::MemoryBudget::GetPressureName(memoryBudget.GetPressure(type)));
+		}
+		ImGui::Text("Textures: %.2f MiB", static_cast<f64>(memoryBudget.GetGPUUsage(Memory::GPUResourceCategory::Texture)) / (1024. * 1024.));
+		ImGui::Text("Meshes: %.2f MiB", static_cast<f64>(memoryBudget.GetGPUUsage(Memory::GPUResourceCategory::Mesh)) / (1024. * 1024.));
+		ImGui::Text("Render targets: %.2f MiB", static_cast<f64>(memoryBudget.GetGPUUsage(Memory::GPUResourceCategory::RenderTarget)) / (1024. * 1024.));
+
+		ImGui::End();
+	}
+
+	void RenderMemoryUI()
+	{
+		ImGui::Begin("Memory");
+
+		if (ImGui::BeginTable("MemoryTags", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+		{
+			ImGui::TableSetupColumn("Tag");
+			ImGui::TableSetupColumn("Live (KiB)");
+			ImGui::TableSetupColumn("Allocations");
+			ImGui::TableSetupColumn("Peak (KiB)");
+			ImGui::TableHeadersRow();
+
+			for (u32 i = 0; i < static_cast<u32>(Memory::MemoryTag::MaxTags); i++)
+			{
+				Memory::MemoryTag tag = static_cast<Memory::MemoryTag>(i);
+				Memory::MemoryTagStats stats = Memory::GetTagStats(tag);
+
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::Text("%s", Memory::GetTagName(tag));
+				ImGui::TableNextColumn();
+				ImGui::Text("%.2f", static_cast<f64>(stats.LiveBytes) / 1024.);
+				ImGui::TableNextColumn();
+				ImGui::Text("%llu", static_cast<unsigned long long>(stats.LiveAllocations));
+				ImGui::TableNextColumn();
+				ImGui::Text("%.2f", static_cast<f64>(stats.HighWaterMark) / 1024.);
+			}
+			ImGui::EndTable();
+		}
+
+		Memory::AllocationGuardStats guardStats = Memory::GetAllocationGuardStats();
+		ImGui::Text("Guarded allocations last frame: %llu (%llu bytes)",
+			static_cast<unsigned long long>(guardStats.AllocationsLastFrame),
+			static_cast<unsigned long long>(guardStats.BytesLastFrame));
+		ImGui::Text("Guarded allocations total: %llu", static_cast<unsigned long long>(guardStats.TotalAllocations));
+
 		ImGui::End();
 	}
 
-	void RenderRendererUI(Renderer* renderer)
+	void RenderLoggerUI()
+	{
+		ImGui::Begin("Logger");
+
+		const char* levelNames[] = {
+			Logger::GetLevelName(Logger::LOG_LEVEL_FATAL), Logger::GetLevelName(Logger::LOG_LEVEL_ERROR),
+			Logger::GetLevelName(Logger::LOG_LEVEL_WARN), Logger::GetLevelName(Logger::LOG_LEVEL_INFO),
+			Logger::GetLevelName(Logger::LOG_LEVEL_DEBUG), Logger::GetLevelName(Logger::LOG_LEVEL_TRACE)
+		};
+
+		for (u8 i = 0; i < static_cast<u8>(Logger::LogChannel::MaxChannels); i++)
+		{
+			Logger::LogChannel channel = static_cast<Logger::LogChannel>(i);
+			int level = static_cast<int>(Logger::GetChannelLevel(channel));
+			if (ImGui::Combo(Logger::GetChannelName(channel), &level, levelNames, IM_ARRAYSIZE(levelNames)))
+			{
+				Logger::SetChannelLevel(channel, static_cast<Logger::eLogLevel>(level));
+			}
+		}
+		ImGui::Text("Dropped messages: %llu", static_cast<unsigned long long>(Logger::GetDroppedMessageCount()));
+
+		ImGui::End();
+	}
+
+	void RenderRendererUI([[maybe_unused]] Renderer* renderer)
 	{
 		ImGui::Begin("Renderer");
 
@@ -173,16 +255,25 @@ namespace Gecko {
 
 	}
 
-	void RenderTransformUI(NodeTransform& transform)
+	void RenderTransformUI(SceneNode* node)
 	{
-		ImGui::DragFloat3("Position", &transform.Position[0], 0.01f);
+		// Only hand the transform back when it was dragged, setting it marks the node as moved.
+		NodeTransform transform = node->GetTransform();
+		bool changed = false;
+
+		changed |= ImGui::DragFloat3("Position", &transform.Position[0], 0.01f);
 
-		ImGui::DragFloat3("Rotation", &transform.Rotation[0], 1.f);
+		changed |= ImGui::DragFloat3("Rotation", &transform.Rotation[0], 1.f);
 
-		ImGui::DragFloat3("Scale", &transform.Scale[0], 0.01f);
+		changed |= ImGui::DragFloat3("Scale", &transform.Scale[0], 0.01f);
+
+		if (changed)
+		{
+			node->SetTransform(transform);
+		}
 	}
 
-	void RenderSelectedNodeUI(SceneNode* node, Scene* scene)
+	void RenderSelectedNodeUI(SceneNode* node, [[maybe_unused]] Scene* scene)
 	{
 		ImGui::Begin("Node");
 		if (node == nullptr)
@@ -196,7 +287,7 @@ namespace Gecko {
 
 		if (ImGui::CollapsingHeader("Transform"))
 		{
-			RenderTransformUI(node->Transform);
+			RenderTransformUI(node);
 		}
 
 		if (ImGui::CollapsingHeader("Meshes"))
@@ -235,6 +326,8 @@ namespace Gecko {
 			RenderSelectedNodeUI(selectedNode, selectedScene);
 			RenderRendererUI(ctx.GetRenderer());
 			RenderResourceManagerUI(ctx.GetResourceManager());
+			RenderMemoryUI();
+			RenderLoggerUI();
 		}
 	}
 